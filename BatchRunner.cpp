@@ -0,0 +1,351 @@
+// BatchRunner.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "BatchRunner.h"
+#include <atomic>               // For std::atomic
+#include <chrono>               // For timing the run
+#include <cstdio>               // For snprintf
+#include <filesystem>           // For std::filesystem::recursive_directory_iterator
+#include <fstream>              // For std::ifstream
+#include <mutex>                // For std::mutex
+#include "sqlite3.h"            // For sqlite3
+#include "Logger.h"             // For LogMessage
+#include "ReferenceDatabase.h"  // For the reference items
+#include "ItemCatalog.h"        // For the reference items, when mapped from a catalog
+#include "SaveConsistencyCheck.h" // For SaveConsistencyChecker
+#include "SaveCodec.h"          // For decoding saves for queries
+#include "SaveQuery.h"          // For SaveQuery
+#include "WorkerThreads.h"      // For RunWorkerThreads
+
+// --- BatchSourceList ---
+
+// Returns true if the file name ends with ext, ignoring ASCII case.
+static bool HasExtension(const std::filesystem::path& path, const char* ext) {
+    return _stricmp(path.extension().string().c_str(), ext) == 0;
+}
+
+void BatchSourceList::Add(const std::string& path) {
+    std::string archive_path, member_name;
+    if (SplitSaveArchivePath(path, archive_path, member_name)) {
+        AddArchive(archive_path, member_name, false);
+        return;
+    }
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        for (auto it = std::filesystem::recursive_directory_iterator(path, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file()) {
+                continue;
+            }
+            const std::filesystem::path& file = it->path();
+            if (HasExtension(file, ".sav")) {
+                m_sources.push_back({ file.string(), NULL, 0 });
+            } else if (IsSaveArchivePath(file.string())) {
+                AddArchive(file.string(), "", true);
+            }
+        }
+        if (ec) {
+            m_errors.push_back("Could not scan directory " + path + ": " + ec.message());
+        }
+        return;
+    }
+    if (SaveArchive::DetectFormat(path) != SAVE_ARCHIVE_NONE) {
+        AddArchive(path, "", true);
+        return;
+    }
+    m_sources.push_back({ path, NULL, 0 });
+}
+
+// Opens an archive once and adds either one named member or, for wholeArchive, every save it holds.
+void BatchSourceList::AddArchive(const std::string& archivePath, const std::string& memberName, bool wholeArchive) {
+    std::unique_ptr<SaveArchive> archive(new SaveArchive());
+    std::string error;
+    if (!archive->Open(archivePath, error)) {
+        m_errors.push_back(error);
+        return;
+    }
+    const std::vector<SaveArchiveMember>& members = archive->GetMembers();
+    if (!wholeArchive) {
+        int index = archive->FindMember(memberName);
+        if (index < 0) {
+            m_errors.push_back("Archive has no member named " + memberName + ": " + archivePath);
+            return;
+        }
+        m_sources.push_back({ archivePath + SAVE_ARCHIVE_MEMBER_SEPARATOR + members[index].name, archive.get(), static_cast<size_t>(index) });
+    } else {
+        for (size_t i = 0; i < members.size(); ++i) {
+            // A gzip file holds exactly one save whatever its stored name; zips may carry other files.
+            if (archive->GetFormat() == SAVE_ARCHIVE_GZIP || HasExtension(members[i].name, ".sav")) {
+                m_sources.push_back({ archivePath + SAVE_ARCHIVE_MEMBER_SEPARATOR + members[i].name, archive.get(), i });
+            }
+        }
+    }
+    m_archives.push_back(std::move(archive));
+}
+
+bool BatchSourceList::ReadBytes(size_t index, std::string& out_bytes, std::string& out_error) const {
+    const BatchSource& source = m_sources[index];
+    if (source.archive) {
+        return source.archive->ReadMember(source.member, MAX_SAVE_FILE_BYTES, out_bytes, out_error);
+    }
+    std::ifstream input(source.path, std::ios::binary | std::ios::ate);
+    if (!input) {
+        out_error = "Could not open save file: " + source.path;
+        return false;
+    }
+    std::streamoff size = input.tellg();
+    if (size < 0 || static_cast<unsigned long long>(size) > MAX_SAVE_FILE_BYTES) {
+        out_error = "Save file is larger than the " + std::to_string(MAX_SAVE_FILE_BYTES) + " byte limit: " + source.path;
+        return false;
+    }
+    out_bytes.resize(static_cast<size_t>(size));
+    input.seekg(0);
+    if (size > 0 && !input.read(&out_bytes[0], size)) {
+        out_error = "Could not read save file: " + source.path;
+        return false;
+    }
+    return true;
+}
+
+bool BatchSourceList::Load(size_t index, SaveGameManager& manager, std::string& buffer) const {
+    // Read or inflate into the caller's buffer; LoadSaveFromMemory decodes and parses it in place.
+    std::string error;
+    if (!ReadBytes(index, buffer, error)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Could not read save: " + error).c_str());
+        return false;
+    }
+    return manager.LoadSaveFromMemory(buffer, m_sources[index].path);
+}
+
+// --- Batch check ---
+
+// Outcome of checking one source, kept until every worker is done so the report comes out in order.
+struct BatchCheckResult {
+    bool loaded = false;
+    SchemaValidationResult schema;
+    SaveConsistencyReport consistency;
+};
+
+int RunBatchCheck(const CommandLineOptions& options) {
+    LogMessage(LOG_INFO_LEVEL, ("Batch checking saves in: " + options.batchCheckPath).c_str());
+    auto start = std::chrono::steady_clock::now();
+
+    BatchSourceList sources;
+    sources.Add(options.batchCheckPath);
+    for (const std::string& error : sources.GetErrors()) {
+        LogMessage(LOG_ERROR_LEVEL, ("Batch check: " + error).c_str());
+    }
+    const size_t source_count = sources.GetSources().size();
+    if (source_count == 0) {
+        LogMessage(LOG_ERROR_LEVEL, "Batch check found no saves.");
+        return 1;
+    }
+
+    // The reference items are laid out once and only read by the workers.
+    ItemCatalog catalog;
+    std::string error;
+    if (!options.catalogFile.empty() && !catalog.Open(options.catalogFile, error)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Batch check: " + error).c_str());
+        return 1;
+    }
+    sqlite3* db = catalog.IsOpen() ? NULL : ReferenceDatabase::Open(error);
+    if (!catalog.IsOpen() && !db) {
+        LogMessage(LOG_ERROR_LEVEL, ("Batch check: reference database failed to initialize: " + error).c_str());
+        return 1;
+    }
+    SaveConsistencyChecker checker;
+    bool prepared = checker.Prepare(catalog.IsOpen() ? &catalog : NULL, db, error);
+    ReferenceDatabase::Close(db);
+    if (!prepared) {
+        LogMessage(LOG_ERROR_LEVEL, ("Batch check: " + error).c_str());
+        return 1;
+    }
+
+    // Each worker has its own manager and pools, reused for every save it checks.
+    std::vector<BatchCheckResult> results(source_count);
+    size_t worker_count = RunWorkerThreads(source_count, static_cast<unsigned>(options.batchThreads), "batch worker", [&](std::atomic<size_t>& next) {
+        SaveGameManager manager;
+        if (!options.schemaFile.empty()) {
+            manager.LoadSchemaFile(options.schemaFile); // Outside the arena: the schema outlives every save.
+        }
+        BatchWorkerPools pools;
+        for (size_t index = next++; index < source_count; index = next++) {
+            BatchCheckResult& result = results[index];
+            pools.arena.Reset();
+            ScopedSaveJsonArena arena(pools.arena);
+            result.loaded = sources.Load(index, manager, pools.bytes);
+            if (result.loaded) {
+                result.schema = manager.ValidateSaveData();
+                checker.Check(manager.GetSaveData(), result.consistency);
+            }
+            manager.CloseSave(); // Its nodes are in the arena, so the save goes while the arena is installed.
+        }
+    });
+
+    size_t failed_to_load = 0;
+    size_t with_problems = 0;
+    size_t with_unknown_ids = 0;
+    for (size_t i = 0; i < source_count; ++i) {
+        const std::string& path = sources.GetSources()[i].path;
+        const BatchCheckResult& result = results[i];
+        if (!result.loaded) {
+            failed_to_load++;
+            LogMessage(LOG_ERROR_LEVEL, ("FAILED to load: " + path).c_str());
+            continue;
+        }
+        if (result.schema.IsValid() && result.consistency.ProblemCount() == 0) {
+            continue;
+        }
+        // As when writing, IDs missing from the reference data (items newer than it) are only a warning.
+        bool failed = !result.schema.IsValid() || result.consistency.ProblemCount() > result.consistency.unknownIds;
+        LogLevel level = failed ? LOG_ERROR_LEVEL : LOG_WARNING_LEVEL;
+        (failed ? with_problems : with_unknown_ids)++;
+        LogMessage(level, (path + ": " + std::to_string(result.schema.errorCount) + " schema violation(s), " +
+                           std::to_string(result.consistency.ProblemCount()) + " item problem(s) (" +
+                           std::to_string(result.consistency.unknownIds) + " unknown ID(s)).").c_str());
+        for (const std::string& message : result.schema.messages) {
+            LogMessage(level, ("  Schema violation: " + message).c_str());
+        }
+        for (const std::string& problem : result.consistency.problems) {
+            LogMessage(level, ("  " + problem).c_str());
+        }
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    char summary[240];
+    snprintf(summary, sizeof(summary), "Batch check: %zu save(s) on %zu thread(s) in %.1f ms; %zu failed to load, %zu with problems, %zu with unknown IDs only, %zu unreadable source(s).",
+             source_count, worker_count, elapsed_ms, failed_to_load, with_problems, with_unknown_ids, sources.GetErrors().size());
+    bool ok = failed_to_load == 0 && with_problems == 0 && sources.GetErrors().empty();
+    LogMessage(ok ? LOG_INFO_LEVEL : LOG_ERROR_LEVEL, summary);
+    return ok ? 0 : 1;
+}
+
+// --- Query ---
+
+// What a worker found for one source, kept until every worker is done so the report comes out in order.
+struct QueryResult {
+    bool read = false;
+    std::string error;
+    std::vector<std::string> values;    // Results as JSON text, when the query has no reducer.
+};
+
+int RunSaveQuery(const CommandLineOptions& options) {
+    SaveQuery query;
+    std::string error;
+    if (!query.Compile(options.query, error)) {
+        LogMessage(LOG_ERROR_LEVEL, error.c_str());
+        return 1;
+    }
+    if (options.querySavesPath.empty()) {
+        LogMessage(LOG_ERROR_LEVEL, "Query: -query needs the saves to run on (-query-saves=<path>).");
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    BatchSourceList sources;
+    sources.Add(options.querySavesPath);
+    for (const std::string& source_error : sources.GetErrors()) {
+        LogMessage(LOG_ERROR_LEVEL, ("Query: " + source_error).c_str());
+    }
+    const size_t source_count = sources.GetSources().size();
+    if (source_count == 0) {
+        LogMessage(LOG_ERROR_LEVEL, "Query found no saves.");
+        return 1;
+    }
+
+    // Reducing workers each fold into their own accumulator; the totals are merged at the end.
+    const bool reduce = query.GetReducer() != QUERY_REDUCE_NONE;
+    std::vector<QueryResult> results(source_count);
+    std::vector<SaveQueryAccumulator> partials;
+    std::mutex partials_mutex;
+    size_t worker_count = RunWorkerThreads(source_count, static_cast<unsigned>(options.batchThreads), "batch worker", [&](std::atomic<size_t>& next) {
+        SaveQueryAccumulator accumulator;
+        BatchWorkerPools pools;
+        for (size_t index = next++; index < source_count; index = next++) {
+            QueryResult& result = results[index];
+            pools.arena.Reset();
+            ScopedSaveJsonArena arena(pools.arena);
+            SaveJson save; // Destroyed before the arena is uninstalled.
+            SaveCodec codec;
+            std::string& bytes = pools.bytes;
+            if (!sources.ReadBytes(index, bytes, result.error)) {
+                continue;
+            }
+            if (!DetectSaveCodec(bytes.data(), bytes.size(), codec)) {
+                result.error = "Could not recognize the save file encoding.";
+                continue;
+            }
+            DecodeSaveBytes(codec, bytes);
+            if (!ParseSaveSections(bytes, query.GetRootSections(), save, result.error)) {
+                continue;
+            }
+            result.read = true;
+            if (reduce) {
+                query.Accumulate(save, accumulator);
+            } else {
+                query.Run(save, [&result](const SaveJson& value) { result.values.push_back(value.dump()); });
+            }
+        }
+        std::lock_guard<std::mutex> lock(partials_mutex);
+        partials.push_back(std::move(accumulator));
+    });
+
+    size_t failed = 0;
+    size_t result_count = 0;
+    for (size_t i = 0; i < source_count; ++i) {
+        const std::string& path = sources.GetSources()[i].path;
+        if (!results[i].read) {
+            failed++;
+            LogMessage(LOG_ERROR_LEVEL, ("FAILED to read " + path + ": " + results[i].error).c_str());
+            continue;
+        }
+        for (const std::string& value : results[i].values) {
+            LogMessage(LOG_INFO_LEVEL, (path + ": " + value).c_str());
+        }
+        result_count += results[i].values.size();
+    }
+    if (reduce) {
+        SaveQueryAccumulator total;
+        for (const SaveQueryAccumulator& partial : partials) {
+            total.Merge(partial);
+        }
+        for (const std::string& line : query.DescribeResult(total)) {
+            LogMessage(LOG_INFO_LEVEL, line.c_str());
+        }
+        result_count = static_cast<size_t>(total.count);
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    char summary[200];
+    snprintf(summary, sizeof(summary), "Query: %zu result(s) from %zu save(s) on %zu thread(s) in %.1f ms; %zu unreadable.",
+             result_count, source_count - failed, worker_count, elapsed_ms, failed + sources.GetErrors().size());
+    bool ok = failed == 0 && sources.GetErrors().empty();
+    LogMessage(ok ? LOG_INFO_LEVEL : LOG_ERROR_LEVEL, summary);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+// BatchRunner.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "CommandLine.h"    // For CommandLineOptions
+#include "SaveArchive.h"    // For SaveArchive
+#include "SaveGameManager.h"
+#include "SaveJsonArena.h"  // For SaveJsonArena
+
+// One save a batch run reads: a plain file, or a member of an archive the source list holds open.
+struct BatchSource {
+    std::string path;               // File path, or "archive!member" for archive members.
+    const SaveArchive* archive;     // Archive holding the save, or NULL for a plain file.
+    size_t member;                  // Member index within archive.
+};
+
+// The saves a batch run covers. Each archive is opened (mapped) once and shared by every worker reading
+// its members, so a zip of backups is never extracted to disk.
+class BatchSourceList {
+public:
+    // Adds the saves a path names:
+    //   - a directory: every .sav file and every .zip/.gz/.gzip archive below it, recursively;
+    //   - an archive: every .sav member of a zip, or the member of a gzip file;
+    //   - "archive!member": that member;
+    //   - any other file: the file itself.
+    // Archives that cannot be opened are recorded in GetErrors rather than stopping the scan.
+    void Add(const std::string& path);
+
+    const std::vector<BatchSource>& GetSources() const { return m_sources; }
+    const std::vector<std::string>& GetErrors() const { return m_errors; }
+
+    // Reads source index's encoded bytes: the file, or the inflated archive member. Thread-safe.
+    bool ReadBytes(size_t index, std::string& out_bytes, std::string& out_error) const;
+    // Loads source index into manager, reading it into buffer (which keeps its capacity from one save
+    // to the next). Thread-safe for distinct managers.
+    bool Load(size_t index, SaveGameManager& manager, std::string& buffer) const;
+
+private:
+    void AddArchive(const std::string& archivePath, const std::string& memberName, bool wholeArchive);
+
+    std::vector<std::unique_ptr<SaveArchive>> m_archives;
+    std::vector<BatchSource> m_sources;
+    std::vector<std::string> m_errors;
+};
+
+// Memory a batch worker reuses from one save to the next. The read buffer grows to the largest save
+// the worker has read and stays there; each parsed save lives in the arena, which is reset wholesale
+// once the worker is done with the save. After the first few saves, loading another makes almost no
+// heap allocations, so workers on many threads stop contending for the allocator.
+struct BatchWorkerPools {
+    std::string bytes;      // Encoded save bytes, decoded in place.
+    SaveJsonArena arena;    // Nodes and strings of the save being worked on.
+};
+
+// Loads every save under -batch-check=<path> on a pool of worker threads, validates each against the
+// save schema and checks its items against the reference data, then reports a summary.
+// Returns the process exit code: 0 if every save loaded and passed, 1 otherwise.
+int RunBatchCheck(const CommandLineOptions& options);
+
+// Runs the -query expression (see SaveQuery) over every save under -query-saves=<path>, in parallel.
+// Each save is decoded and only the top-level sections the query names are parsed. Results are logged
+// per save, or folded into one total if the query ends with a reducer.
+// Returns the process exit code: 0 on success, 1 if the query is invalid or any save cannot be read.
+int RunSaveQuery(const CommandLineOptions& options);
@@ -0,0 +1,98 @@
+// BufferedWriter.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "BufferedWriter.h"
+#include <cstring>      // For memcpy
+#include <memory>       // For std::make_shared
+#include "SaveJsonWriter.h" // For SaveJsonWriter
+
+BufferedFileWriter::BufferedFileWriter(size_t buffer_size)
+    : m_file(NULL), m_buffer(buffer_size > 0 ? buffer_size : DEFAULT_WRITE_BUFFER_SIZE), m_used(0), m_failed(false) {
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+    Close();
+}
+
+bool BufferedFileWriter::Open(const std::string& path) {
+    Close();
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) {
+        return false;
+    }
+    setvbuf(m_file, NULL, _IONBF, 0); // Our own buffer replaces the CRT's.
+    m_used = 0;
+    m_failed = false;
+    return true;
+}
+
+void BufferedFileWriter::Write(const char* data, size_t length) {
+    // Large writes bypass the buffer once it has been drained, avoiding a pointless copy.
+    if (length >= m_buffer.size()) {
+        Flush();
+        if (m_file && fwrite(data, 1, length, m_file) != length) {
+            m_failed = true;
+        }
+        return;
+    }
+    if (m_used + length > m_buffer.size()) {
+        Flush();
+    }
+    memcpy(m_buffer.data() + m_used, data, length);
+    m_used += length;
+}
+
+void BufferedFileWriter::Flush() {
+    if (m_used == 0) {
+        return;
+    }
+    if (!m_file || fwrite(m_buffer.data(), 1, m_used, m_file) != m_used) {
+        m_failed = true;
+    }
+    m_used = 0;
+}
+
+bool BufferedFileWriter::Close() {
+    if (!m_file) {
+        return !m_failed;
+    }
+    Flush();
+    if (fclose(m_file) != 0) {
+        m_failed = true;
+    }
+    m_file = NULL;
+    return !m_failed;
+}
+
+void WriteJson(const SaveJson& value, BufferedFileWriter& writer, int indent) {
+    SaveJsonWriter json_writer(std::make_shared<BufferedJsonOutputAdapter>(writer), indent);
+    json_writer.Write(value);
+}
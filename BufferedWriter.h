@@ -0,0 +1,96 @@
+// BufferedWriter.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdio>       // For FILE
+#include <string>
+#include <vector>
+#include "SaveJson.h"   // For SaveJson, nlohmann::detail::output_adapter_protocol
+
+// Default size of the in-memory buffer used by BufferedFileWriter.
+const size_t DEFAULT_WRITE_BUFFER_SIZE = 256 * 1024;
+
+// The BufferedFileWriter class writes to a file through a large caller-owned buffer, issuing one
+// write call per buffer fill instead of one per insertion like an unbuffered std::ofstream.
+class BufferedFileWriter {
+public:
+    explicit BufferedFileWriter(size_t buffer_size = DEFAULT_WRITE_BUFFER_SIZE);
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    // Opens (and truncates) the file at path for binary writing. Returns false on failure.
+    bool Open(const std::string& path);
+    bool IsOpen() const { return m_file != NULL; }
+
+    // Appends bytes to the buffer, flushing to disk whenever it fills.
+    void Write(const char* data, size_t length);
+    void Write(const std::string& text) { Write(text.data(), text.size()); }
+    void Put(char c) {
+        if (m_used == m_buffer.size()) {
+            Flush();
+        }
+        m_buffer[m_used++] = c;
+    }
+
+    // Writes any buffered bytes to the file.
+    void Flush();
+
+    // Flushes and closes the file. Returns false if any write failed.
+    bool Close();
+
+private:
+    FILE* m_file;
+    std::vector<char> m_buffer;
+    size_t m_used;
+    bool m_failed;
+};
+
+// Adapts a BufferedFileWriter as a JSON output target, so a DOM can be serialized
+// straight to disk without first materializing the whole text in memory.
+class BufferedJsonOutputAdapter : public nlohmann::detail::output_adapter_protocol<char> {
+public:
+    explicit BufferedJsonOutputAdapter(BufferedFileWriter& writer) : m_writer(writer) {}
+    void write_character(char c) override { m_writer.Put(c); }
+    void write_characters(const char* s, std::size_t length) override { m_writer.Write(s, length); }
+
+private:
+    BufferedFileWriter& m_writer;
+};
+
+// Serializes a JSON value through a BufferedFileWriter.
+// Parameters:
+//   value: The JSON value to write.
+//   writer: An open writer.
+//   indent: Indentation step; a negative value writes compact JSON like json::dump().
+void WriteJson(const SaveJson& value, BufferedFileWriter& writer, int indent = -1);
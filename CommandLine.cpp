@@ -0,0 +1,121 @@
+// CommandLine.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "CommandLine.h"
+#include <cstring>      // For strcmp, strncmp
+#include <cstdlib>      // For strtod, atoi
+
+// Returns the value part of a "-name=value" argument if arg starts with prefix, or NULL otherwise.
+static const char* MatchValueArgument(const char* arg, const char* prefix) {
+    size_t prefix_len = strlen(prefix);
+    if (strncmp(arg, prefix, prefix_len) == 0) {
+        return arg + prefix_len;
+    }
+    return NULL;
+}
+
+CommandLineOptions ParseCommandLine(int argc, char** argv) {
+    CommandLineOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = NULL;
+        if (strcmp(arg, "-log") == 0) {
+            options.enableFileLogging = true;
+        } else if (strcmp(arg, "-dump") == 0) {
+            options.dumpDiagnostics = true;
+        } else if (strcmp(arg, "-startup-check") == 0) {
+            options.startupCheck = true;
+        } else if ((value = MatchValueArgument(arg, "-startup-budget=")) != NULL) {
+            double budget = strtod(value, NULL);
+            if (budget > 0.0) {
+                options.startupBudgetMs = budget;
+            } else {
+                options.warnings.push_back(std::string("Ignoring invalid startup budget: ") + value);
+            }
+        } else if ((value = MatchValueArgument(arg, "-schema=")) != NULL) {
+            options.schemaFile = value;
+        } else if ((value = MatchValueArgument(arg, "-infer-schema=")) != NULL) {
+            options.inferSchemaDir = value;
+        } else if (strcmp(arg, "-stress-load") == 0) {
+            options.stressLoad = true;
+        } else if ((value = MatchValueArgument(arg, "-benchmark=")) != NULL) {
+            options.benchmarkFile = value;
+        } else if ((value = MatchValueArgument(arg, "-benchmark-iterations=")) != NULL) {
+            int iterations = atoi(value);
+            if (iterations > 0) {
+                options.benchmarkIterations = iterations;
+            } else {
+                options.warnings.push_back(std::string("Ignoring invalid benchmark iteration count: ") + value);
+            }
+        } else if (strcmp(arg, "-perf-counters") == 0) {
+            options.perfCounters = true;
+        } else if ((value = MatchValueArgument(arg, "-catalog=")) != NULL) {
+            options.catalogFile = value;
+        } else if ((value = MatchValueArgument(arg, "-export-catalog=")) != NULL) {
+            options.exportCatalogFile = value;
+        } else if ((value = MatchValueArgument(arg, "-export-catalog-version=")) != NULL) {
+            options.exportCatalogVersionFile = value;
+        } else if ((value = MatchValueArgument(arg, "-catalog-version-sql=")) != NULL) {
+            options.catalogVersionSqlFile = value;
+        } else if ((value = MatchValueArgument(arg, "-lang-file=")) != NULL) {
+            options.languageFile = value;
+        } else if ((value = MatchValueArgument(arg, "-lang=")) != NULL) {
+            options.language = value;
+        } else if ((value = MatchValueArgument(arg, "-find-item=")) != NULL) {
+            options.findItemText = value;
+        } else if ((value = MatchValueArgument(arg, "-batch-check=")) != NULL) {
+            options.batchCheckPath = value;
+        } else if ((value = MatchValueArgument(arg, "-batch-threads=")) != NULL) {
+            int threads = atoi(value);
+            if (threads > 0) {
+                options.batchThreads = threads;
+            } else {
+                options.warnings.push_back(std::string("Ignoring invalid batch thread count: ") + value);
+            }
+        } else if ((value = MatchValueArgument(arg, "-query=")) != NULL) {
+            options.query = value;
+        } else if ((value = MatchValueArgument(arg, "-query-saves=")) != NULL) {
+            options.querySavesPath = value;
+        } else if ((value = MatchValueArgument(arg, "-profile=")) != NULL) {
+            options.profileFile = value;
+        } else {
+            // The logger is not initialized yet, so the warning is kept for the caller to log.
+            options.warnings.push_back(std::string("Ignoring unrecognized argument: ") + arg);
+        }
+    }
+    return options;
+}
+
+bool IsHeadlessRun(const CommandLineOptions& options) {
+    return options.startupCheck || !options.inferSchemaDir.empty() || options.stressLoad || !options.benchmarkFile.empty() ||
+           !options.exportCatalogFile.empty() || !options.exportCatalogVersionFile.empty() || !options.findItemText.empty() || !options.batchCheckPath.empty() ||
+           !options.query.empty();
+}
@@ -0,0 +1,77 @@
+// CommandLine.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Default budget, in milliseconds, for core initialization when running with -startup-check.
+const double DEFAULT_STARTUP_BUDGET_MS = 250.0;
+// Default number of timed repetitions per benchmark when running with -benchmark.
+const int DEFAULT_BENCHMARK_ITERATIONS = 10;
+
+// Options parsed from the application's command line.
+struct CommandLineOptions {
+    bool enableFileLogging = false;     // -log: Write log output to a timestamped file in the bin directory.
+    bool dumpDiagnostics = false;       // -dump: Write a diagnostic dump after every edit operation.
+    bool startupCheck = false;          // -startup-check: Time core initialization headlessly and exit.
+    double startupBudgetMs = DEFAULT_STARTUP_BUDGET_MS; // -startup-budget=<ms>: Budget for -startup-check.
+    std::string schemaFile;             // -schema=<file>: Validate saves against this schema instead of the built-in one.
+    std::string inferSchemaDir;         // -infer-schema=<path>: Infer a schema from the saves in a directory or archive and exit.
+    bool stressLoad = false;            // -stress-load: Load pathological inputs, check for linear cost, and exit.
+    std::string benchmarkFile;          // -benchmark=<save>: Benchmark loading and editing <save> and exit.
+    int benchmarkIterations = DEFAULT_BENCHMARK_ITERATIONS; // -benchmark-iterations=<n>: Repetitions per benchmark.
+    bool perfCounters = false;          // -perf-counters: Also collect hardware performance counters in -benchmark.
+    std::string catalogFile;            // -catalog=<file>: Look item data up in this mapped item catalog.
+    std::string exportCatalogFile;      // -export-catalog=<file>: Generate an item catalog from the reference data and exit.
+    std::string exportCatalogVersionFile; // -export-catalog-version=<file>: Generate a reference catalog version from -catalog-version-sql and exit.
+    std::string catalogVersionSqlFile;  // -catalog-version-sql=<file>: SQL dump of another game build's reference database.
+    std::string languageFile;           // -lang-file=<file>: Import item display names from this localization table.
+    std::string language;               // -lang=<language>: Language to show item names in (default: the table's first).
+    std::string findItemText;           // -find-item=<text>: List the items whose name or text ID contains <text> and exit.
+    std::string batchCheckPath;         // -batch-check=<path>: Check every save in a directory or archive and exit.
+    int batchThreads = 0;               // -batch-threads=<n>: Worker threads for -batch-check and -query (default: one per core).
+    std::string query;                  // -query=<expression>: Run a read-only query over the -query-saves saves and exit.
+    std::string querySavesPath;         // -query-saves=<path>: Directory or archive of saves for -query.
+    std::string profileFile;            // -profile=<file>: Sample call stacks for the whole run and write folded stacks to <file>.
+    std::vector<std::string> warnings;  // Arguments that were ignored and why, to log once the logger is running.
+};
+
+// Parses command line arguments into a CommandLineOptions structure.
+// Unrecognized or invalid arguments are ignored and described in the options' warnings.
+// Parameters:
+//   argc: Number of arguments, including the program name.
+//   argv: Argument strings, including the program name at index 0.
+CommandLineOptions ParseCommandLine(int argc, char** argv);
+
+// Returns true if any option requests a headless (windowless) run.
+bool IsHeadlessRun(const CommandLineOptions& options);
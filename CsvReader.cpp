@@ -0,0 +1,125 @@
+// CsvReader.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "CsvReader.h"
+#include <fstream>      // For std::ifstream
+
+CsvReader::CsvReader(const std::string& text) : m_text(text), m_pos(0), m_line(1), m_recordLine(0) {
+    if (m_text.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        m_pos = 3;
+    }
+}
+
+bool CsvReader::ReadRecord(std::vector<std::string>& fields) {
+    // Skip blank lines between records.
+    while (m_pos < m_text.size() && (m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+        if (m_text[m_pos] == '\n') {
+            m_line++;
+        }
+        m_pos++;
+    }
+    if (m_pos >= m_text.size()) {
+        return false;
+    }
+    m_recordLine = m_line;
+
+    size_t field_count = 0;
+    for (;;) {
+        if (field_count == fields.size()) {
+            fields.emplace_back();
+        }
+        std::string& field = fields[field_count++];
+        field.clear();
+
+        if (m_pos < m_text.size() && m_text[m_pos] == '"') {
+            // Quoted field: runs to the next quote not followed by another quote.
+            m_pos++;
+            while (m_pos < m_text.size()) {
+                char c = m_text[m_pos++];
+                if (c == '"') {
+                    if (m_pos < m_text.size() && m_text[m_pos] == '"') {
+                        field += '"';
+                        m_pos++;
+                        continue;
+                    }
+                    break;
+                }
+                if (c == '\n') {
+                    m_line++;
+                }
+                field += c;
+            }
+        }
+        // Unquoted field, or anything after a closing quote up to the delimiter (kept as-is).
+        size_t end = m_text.find_first_of(",\r\n", m_pos);
+        if (end == std::string::npos) {
+            end = m_text.size();
+        }
+        field.append(m_text, m_pos, end - m_pos);
+        m_pos = end;
+
+        if (m_pos < m_text.size() && m_text[m_pos] == ',') {
+            m_pos++;
+            continue;
+        }
+        // End of record: consume CRLF or LF.
+        if (m_pos < m_text.size() && m_text[m_pos] == '\r') {
+            m_pos++;
+        }
+        if (m_pos < m_text.size() && m_text[m_pos] == '\n') {
+            m_pos++;
+            m_line++;
+        }
+        break;
+    }
+    fields.resize(field_count);
+    return true;
+}
+
+bool ReadTextFile(const std::string& filepath, size_t maxBytes, std::string& out_text, std::string& out_error) {
+    std::ifstream input(filepath, std::ios::binary | std::ios::ate);
+    if (!input) {
+        out_error = "Could not open file: " + filepath;
+        return false;
+    }
+    std::streamoff size = input.tellg();
+    if (size < 0 || static_cast<unsigned long long>(size) > maxBytes) {
+        out_error = "File is larger than the " + std::to_string(maxBytes) + " byte limit: " + filepath;
+        return false;
+    }
+    out_text.resize(static_cast<size_t>(size));
+    input.seekg(0);
+    if (size > 0 && !input.read(&out_text[0], size)) {
+        out_error = "Could not read file: " + filepath;
+        return false;
+    }
+    return true;
+}
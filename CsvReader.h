@@ -0,0 +1,60 @@
+// CsvReader.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Reads CSV records (RFC 4180) from text held in memory: comma-separated fields, optionally enclosed in
+// double quotes, with "" standing for a quote inside a quoted field. Records end at LF or CRLF; quoted
+// fields may contain either. A UTF-8 byte order mark at the start of the text is skipped.
+class CsvReader {
+public:
+    // The text must outlive the reader.
+    explicit CsvReader(const std::string& text);
+
+    // Reads the next record into fields, reusing their storage. Blank lines are skipped.
+    // Returns false at the end of the text.
+    bool ReadRecord(std::vector<std::string>& fields);
+    // Line number (1-based) at which the last record read started, for error messages.
+    size_t GetRecordLine() const { return m_recordLine; }
+
+private:
+    const std::string& m_text;
+    size_t m_pos;
+    size_t m_line;
+    size_t m_recordLine;
+};
+
+// Reads a whole file into out_text, refusing files larger than maxBytes.
+// Returns false and sets out_error if the file cannot be read or is too large.
+bool ReadTextFile(const std::string& filepath, size_t maxBytes, std::string& out_text, std::string& out_error);
@@ -32,23 +32,32 @@
 #include <windows.h>    // Basic Windows API functions
 #include <windowsx.h>   // For GET_WM_COMMAND_ID macro
 #include <string>       // For std::string
+#include <map>          // For per-section change counts shown in the status line
 #include <filesystem>   // For std::filesystem (C++17 for path manipulation) - Kept for std::filesystem::path
-#include <string.h>     // For strstr (for parsing command-line arguments)
-#include <vector>       // For std::vector (used in zlib decompression)
+#include <stdio.h>      // For freopen (attaching headless runs to the parent console)
+#include <stdlib.h>     // For __argc, __argv
 
 // Include SQLite3 header
 #include "sqlite3.h"
 
-// zlib header for decompression
-#include "zlib.h"
-
-// Include the generated embedded SQL string (our compressed reference DB)
-#include "embedded_sql.h" // Contains compressed binary SQL data for the reference database.
-
 // Project-specific headers
 #include "DaveSaveEd.h"     // Application-wide globals and common definitions.
 #include "Logger.h"         // Logging functionality.
 #include "SaveGameManager.h" // Manages game save file operations.
+#include "ReferenceDatabase.h" // Builds the in-memory reference database.
+#include "StartupProfiler.h" // Startup phase timing.
+#include "CommandLine.h"    // Command line option parsing.
+#include "HeadlessRunner.h" // Windowless command line modes.
+#include "Diagnostics.h"    // Opt-in diagnostic dumps.
+#include "EditJournal.h"    // Crash-recovery edit journal.
+#include "SaveChangeEvents.h" // Change events that drive the display refresh.
+#include "ItemCatalog.h"    // Optional memory-mapped item catalog.
+#include "LocalizationTable.h" // Optional item display names.
+#include "InventoryImport.h" // Bulk import of item counts from CSV.
+#include "CsvReader.h"      // For ReadTextFile.
+#include "SaveConsistencyCheck.h" // Audits the save's items before writing.
+#include "SamplingProfiler.h" // Optional -profile sampling of the whole run.
+#include "SavePreload.h"    // Background load of the most recent save at startup.
 #include "resource.h" //icon ID
 
 // --- Global Constants and Control IDs for the Dialog UI ---
@@ -82,6 +91,33 @@
 #define IDC_BTN_MAX_OWN_MATERIALS 114
 #define IDC_BTN_MAX_LEVEL_OWN_STAFF 115
 
+// Control ID for the status line below the file buttons.
+#define IDC_STATIC_STATUS           117
+
+#define IDC_BTN_IMPORT_COUNTS       118
+#define IDC_BTN_GAIN_TIMES_NOW      119
+
+// System menu command IDs (must be multiples of 16 and below 0xF000).
+#define IDM_DIAGNOSTIC_DUMP         0x0010
+
+// Posted from WM_CREATE to offer recovery of a crashed session once the window is up.
+#define WM_APP_OFFER_RECOVERY       (WM_APP + 1)
+// Posted on the first save data change after a refresh; redraws everything changed since then at once.
+#define WM_APP_REFRESH_DISPLAY      (WM_APP + 2)
+
+// Parts of the display that are refreshed independently (bit flags).
+enum DisplayPart : unsigned {
+    DISPLAY_GOLD        = 1 << 0,
+    DISPLAY_BEI         = 1 << 1,
+    DISPLAY_FLAME       = 1 << 2,
+    DISPLAY_FOLLOWERS   = 1 << 3,
+    DISPLAY_STATUS      = 1 << 4,
+    DISPLAY_CURRENCIES  = DISPLAY_GOLD | DISPLAY_BEI | DISPLAY_FLAME | DISPLAY_FOLLOWERS,
+};
+
+// Directory diagnostic dumps are written to, relative to the working directory.
+const char* const DIAGNOSTICS_DIRECTORY = "diagnostics";
+
 // --- Global Window Handles ---
 HWND g_hDlg = NULL; // Handle to the main dialog window.
 
@@ -90,49 +126,342 @@ HWND g_hStaticGoldValue = NULL;
 HWND g_hStaticBeiValue = NULL;
 HWND g_hStaticFlameValue = NULL;
 HWND g_hStaticFollowerValue = NULL;
+// Handle to the status line that reports what the last edit changed.
+HWND g_hStaticStatus = NULL;
+
+// --- Display Refresh State ---
+// Change events only mark the display parts they affect. The marked parts are redrawn together when
+// WM_APP_REFRESH_DISPLAY arrives, so a burst of changes (a "Max" pass, a session recovery) costs one refresh.
+unsigned g_dirtyDisplayParts = 0;
+bool g_displayRefreshPosted = false;
+std::map<std::string, int> g_pendingSectionChanges; // Item-level changes per save section since the last refresh.
+std::string g_pendingStatusMessage;                 // Load/unload message for the next status line.
 
 // --- Global SQLite Database Handle (for embedded reference DB) ---
 // This database stores reference data (e.g., ingredient lists) for the editor.
 sqlite3* g_refDb = NULL;
 
+// --- Global Item Catalog (optional, from -catalog=<file>) ---
+// A mapped binary copy of the reference item data; when open, the "Max" passes read it instead of g_refDb.
+ItemCatalog g_itemCatalog;
+
+// --- Global Localization Table (optional, from -lang-file=<file>) ---
+// Display names of the reference items, so count imports can name items the way players see them.
+LocalizationTable g_localization;
+
 // --- Global Save Game Manager instance ---
 // Manages all interactions with the game's save files.
 SaveGameManager g_saveGameManager;
 
+// --- Global Save Preload ---
+// The most recent save, loaded in the background at startup in case it is the one the user opens.
+SavePreload g_savePreload;
+
 // Global brush for painting the dialog background color.
 HBRUSH g_hBackgroundBrush = NULL;
 
 // --- Forward Declarations ---
 // Main dialog procedure callback function.
 INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
-// Function to update the currency display on the UI from the loaded save data.
-void UpdateCurrencyDisplay();
-
-// --- Function to update currency static text fields ---
-// Retrieves currency values from the SaveGameManager and updates the corresponding UI controls.
-void UpdateCurrencyDisplay() {
-    // Initialize display strings to blank.
-    std::string gold_str = "";
-    std::string bei_str = "";
-    std::string flame_str = "";
-    std::string follower_str = "";
-
-    // If a save file is loaded, retrieve and display the actual values.
-    if (g_saveGameManager.IsSaveFileLoaded()) {
-        gold_str = std::to_string(g_saveGameManager.GetGold());
-        bei_str = std::to_string(g_saveGameManager.GetBei());
-        flame_str = std::to_string(g_saveGameManager.GetArtisansFlame());
-        follower_str = std::to_string(g_saveGameManager.GetFollowerCount());
-        LogMessage(LOG_INFO_LEVEL, "Currency display updated from SaveGameManager values.");
+// Function to receive save data change events and schedule the display refresh.
+void OnSaveDataChanged(const SaveChangeEvent& event);
+// Function to mark display parts as changed and schedule one refresh for all of them.
+void RequestDisplayRefresh(unsigned parts);
+// Function to redraw the display parts changed since the last refresh.
+void RefreshDisplay();
+// Function to write a diagnostic dump after an edit, if enabled with -dump.
+void RequestAutoDiagnosticDump();
+// Function to offer replaying the edit journal left behind by a session that did not exit cleanly.
+void OfferSessionRecovery(HWND hDlg);
+// Function to import item counts from a CSV file chosen by the user.
+void ImportItemCountsFromFile(HWND hDlg);
+// Function to switch the reference database to the catalog version the loaded save needs.
+void MatchCatalogVersionToSave();
+// Function to switch the reference database to a catalog version and point the save manager at it.
+void UseCatalogVersion(size_t version);
+// Function returning the item catalog if it matches the reference database in use, else NULL.
+const ItemCatalog* GetActiveItemCatalog();
+// Function to audit the save's items before writing; returns false if the user chooses not to write.
+bool ConfirmSaveConsistency(HWND hDlg);
+
+// --- Function to queue a diagnostic dump after an edit operation ---
+// Does nothing unless dumps were enabled with the -dump command line flag.
+void RequestAutoDiagnosticDump() {
+    if (Diagnostics::IsAutoDumpEnabled()) {
+        Diagnostics::RequestDump(g_saveGameManager.IsSaveFileLoaded() ? &g_saveGameManager.GetSaveData() : NULL, g_refDb);
+    }
+}
+
+// --- Function to recover a crashed editing session ---
+// A journal left at the default location means the previous session ended without writing or exiting cleanly.
+void OfferSessionRecovery(HWND hDlg) {
+    std::string journal_path = EditJournal::DefaultJournalPath();
+    JournalContents journal;
+    if (!EditJournal::Read(journal_path, journal)) {
+        return;
+    }
+    if (journal.entries.empty()) {
+        EditJournal::Remove(journal_path); // Nothing was edited; nothing to recover.
+        return;
+    }
+
+    std::string prompt = "DaveSaveEd did not exit cleanly. " + std::to_string(journal.entries.size()) +
+        " unsaved edit(s) to\n" + journal.sourcePath + "\ncan be recovered.";
+    if (journal.truncated) {
+        prompt += "\n\nThe last edit was only partially recorded and will be skipped.";
+    }
+    if (!EditJournal::SourceMatches(journal)) {
+        prompt += "\n\nWarning: the save file has changed since these edits were made.";
+    }
+    prompt += "\n\nRecover them now?";
+
+    if (MessageBox(hDlg, prompt.c_str(), "Recover Session", MB_ICONQUESTION | MB_YESNO) == IDYES) {
+        if (!g_saveGameManager.LoadRecoverySource(journal)) {
+            MessageBox(hDlg, "Failed to recover the session: the save file could not be loaded.", "Recovery Error", MB_ICONERROR | MB_OK);
+        } else {
+            // Pick the catalog version before replaying, so the Max* passes know the save's items. Each edit
+            // is replayed with the version it was made under, if this build still embeds it.
+            MatchCatalogVersionToSave();
+            size_t matched_version = ReferenceDatabase::GetCatalogVersion(g_refDb);
+            g_saveGameManager.ReplayJournal(journal, [matched_version](uint32_t version) {
+                UseCatalogVersion(version < ReferenceDatabase::GetCatalogVersionCount() ? version : matched_version);
+                return g_refDb;
+            });
+            UseCatalogVersion(matched_version);
+        }
     } else {
-        LogMessage(LOG_INFO_LEVEL, "No valid save data loaded. Displaying blank currency values.");
+        LogMessage(LOG_INFO_LEVEL, "Session recovery declined.");
+        EditJournal::Remove(journal_path);
+    }
+}
+
+// --- Reference catalog versions ---
+// The item catalog file is built from the base catalog; once another version is applied, item data comes from the database.
+const ItemCatalog* GetActiveItemCatalog() {
+    return g_itemCatalog.IsOpen() && ReferenceDatabase::GetCatalogVersion(g_refDb) == 0 ? &g_itemCatalog : NULL;
+}
+
+// Saves from other game builds refer to items the base catalog lacks. Pick the embedded version that knows
+// them; its delta is only inflated now, the first time a save needs it.
+void MatchCatalogVersionToSave() {
+    if (!g_refDb || ReferenceDatabase::GetCatalogVersionCount() < 2) {
+        return;
+    }
+    // Compare against the base, so a save from the base build goes back to it after a save from another build.
+    std::string version_error;
+    if (!ReferenceDatabase::ApplyCatalogVersion(g_refDb, 0, version_error)) {
+        LogMessage(LOG_ERROR_LEVEL, version_error.c_str());
+        return;
+    }
+    std::vector<int32_t> unknown_ids;
+    g_saveGameManager.FindUnknownItemIds(g_refDb, unknown_ids);
+    size_t version = 0;
+    size_t known = 0;
+    if (!unknown_ids.empty()) {
+        version = ReferenceDatabase::FindCatalogVersionForItems(unknown_ids, known);
+        LogMessage(LOG_INFO_LEVEL, ("The save refers to " + std::to_string(unknown_ids.size()) + " item(s) the base reference catalog lacks; " +
+                   (version == 0 ? std::string("no embedded version knows them.") :
+                    std::string(ReferenceDatabase::GetCatalogVersionName(version)) + " knows " + std::to_string(known) + ".")).c_str());
+    }
+    UseCatalogVersion(version);
+}
+
+void UseCatalogVersion(size_t version) {
+    if (!g_refDb) {
+        return; // The database failed to open; there is no version to switch.
+    }
+    std::string version_error;
+    if (!ReferenceDatabase::ApplyCatalogVersion(g_refDb, version, version_error)) {
+        LogMessage(LOG_ERROR_LEVEL, version_error.c_str());
+    }
+    g_saveGameManager.SetItemCatalog(GetActiveItemCatalog());
+    g_saveGameManager.SetCatalogVersion(ReferenceDatabase::GetCatalogVersion(g_refDb));
+}
+
+// --- Function to audit the save before writing ---
+// Every problem is logged. Unknown IDs alone do not stop the write (the save may come from a game build the
+// reference data does not cover); counts out of range or wrong parents ask the user first.
+bool ConfirmSaveConsistency(HWND hDlg) {
+    if (!g_saveGameManager.IsSaveFileLoaded()) {
+        return true;
+    }
+    SaveConsistencyChecker checker;
+    std::string check_error;
+    if (!checker.Prepare(GetActiveItemCatalog(), g_refDb, check_error)) {
+        LogMessage(LOG_WARNING_LEVEL, (check_error + " Skipping the consistency check.").c_str());
+        return true;
+    }
+    SaveConsistencyReport report;
+    checker.Check(g_saveGameManager.GetSaveData(), report);
+    LogMessage(LOG_INFO_LEVEL, ("Consistency check: " + std::to_string(report.ingredientsChecked) + " ingredients, " +
+               std::to_string(report.inventoryChecked) + " inventory slots, " + std::to_string(report.ProblemCount()) + " problem(s).").c_str());
+    if (report.ProblemCount() == 0) {
+        return true;
+    }
+    for (const std::string& problem : report.problems) {
+        LogMessage(LOG_WARNING_LEVEL, ("Consistency check: " + problem).c_str());
+    }
+    if (report.countsAboveMax + report.negativeCounts + report.parentMismatches == 0) {
+        return true;
+    }
+
+    std::string prompt = "The save has " + std::to_string(report.countsAboveMax) + " count(s) above the item maximum, " +
+        std::to_string(report.negativeCounts) + " negative count(s) and " + std::to_string(report.parentMismatches) +
+        " ingredient(s) with a wrong parent item.\n\n";
+    for (size_t i = 0; i < report.problems.size() && i < 5; ++i) {
+        prompt += report.problems[i] + "\n";
+    }
+    prompt += "\nWrite the save file anyway?";
+    return MessageBox(hDlg, prompt.c_str(), "Consistency Check", MB_ICONWARNING | MB_YESNO | MB_DEFBUTTON2) == IDYES;
+}
+
+// --- Function to import item counts from a CSV file ---
+// Reads "<item>,<count>" rows, joins them against the reference items and applies the valid ones.
+void ImportItemCountsFromFile(HWND hDlg) {
+    OPENFILENAMEA ofn;
+    char szFile[MAX_PATH] = {0}; // Buffer for the selected file path.
+    ZeroMemory(&ofn, sizeof(ofn));
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = hDlg;
+    ofn.lpstrFile = szFile;
+    ofn.nMaxFile = sizeof(szFile);
+    ofn.lpstrFilter = "Item Count Files (*.csv)\0*.csv\0All Files (*.*)\0*.*\0";
+    ofn.nFilterIndex = 1;
+    ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
+    if (GetOpenFileNameA(&ofn) != TRUE) {
+        LogMessage(LOG_INFO_LEVEL, "File selection cancelled.");
+        return;
+    }
+
+    std::string csv_text;
+    std::string import_error;
+    if (!ReadTextFile(ofn.lpstrFile, MAX_COUNT_IMPORT_FILE_BYTES, csv_text, import_error)) {
+        LogMessage(LOG_ERROR_LEVEL, import_error.c_str());
+        MessageBox(hDlg, import_error.c_str(), "Import Error", MB_ICONERROR | MB_OK);
+        return;
+    }
+
+    std::vector<ItemCountChange> changes;
+    ItemCountImportReport report;
+    const ItemCatalog* catalog = GetActiveItemCatalog();
+    const LocalizationTable* names = g_localization.IsLoaded() ? &g_localization : NULL;
+    if (!JoinItemCounts(csv_text, catalog, g_refDb, names, changes, report, import_error)) {
+        LogMessage(LOG_ERROR_LEVEL, import_error.c_str());
+        MessageBox(hDlg, import_error.c_str(), "Import Error", MB_ICONERROR | MB_OK);
+        return;
+    }
+    csv_text.clear();
+    csv_text.shrink_to_fit(); // The file can be large; it is not needed past the join.
+
+    ItemCountApplyResult result;
+    g_saveGameManager.ApplyItemCounts(changes, result);
+    RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+    RequestAutoDiagnosticDump();
+
+    std::string summary = std::to_string(report.rows) + " row(s) read, " + std::to_string(report.accepted) + " accepted, " +
+        std::to_string(report.rejected) + " rejected.\n\n" +
+        "Ingredients set: " + std::to_string(result.ingredientsSet) + "\n" +
+        "Ingredients added: " + std::to_string(result.ingredientsAdded) + "\n" +
+        "Materials set: " + std::to_string(result.materialsSet) + "\n";
+    if (result.materialsNotOwned > 0) {
+        summary += "Materials skipped (not in inventory): " + std::to_string(result.materialsNotOwned) + "\n";
+    }
+    if (!report.problems.empty()) {
+        summary += "\nRejected rows:\n";
+        for (const std::string& problem : report.problems) {
+            summary += problem + "\n";
+        }
+        if (report.rejected > report.problems.size()) {
+            summary += "... and " + std::to_string(report.rejected - report.problems.size()) + " more.\n";
+        }
+    }
+    MessageBox(hDlg, summary.c_str(), "Import Counts", (report.rejected > 0 ? MB_ICONWARNING : MB_ICONINFORMATION) | MB_OK);
+}
+
+// --- Save data change events ---
+// Maps each change to the display parts it affects. Values without a control of their own (ingredients,
+// materials, staff) are counted per section for the status line.
+void OnSaveDataChanged(const SaveChangeEvent& event) {
+    static const struct { const char* path; DisplayPart part; } VALUE_DISPLAYS[] = {
+        { "/PlayerInfo/m_Gold",         DISPLAY_GOLD },
+        { "/PlayerInfo/m_Bei",          DISPLAY_BEI },
+        { "/PlayerInfo/m_ChefFlame",    DISPLAY_FLAME },
+        { "/SNSInfo/m_Follow_Count",    DISPLAY_FOLLOWERS },
+    };
+
+    if (event.kind != SAVE_CHANGE_VALUE) {
+        g_pendingSectionChanges.clear();
+        g_pendingStatusMessage = event.kind == SAVE_CHANGE_LOADED ? "Save file loaded." : "No save file loaded.";
+        RequestDisplayRefresh(DISPLAY_CURRENCIES | DISPLAY_STATUS);
+        return;
+    }
+    for (const auto& display : VALUE_DISPLAYS) {
+        if (event.path == display.path) {
+            RequestDisplayRefresh(display.part);
+            return;
+        }
+    }
+    ++g_pendingSectionChanges[GetSaveChangeSection(event.path)];
+    RequestDisplayRefresh(DISPLAY_STATUS);
+}
+
+// --- Function to schedule a display refresh ---
+// Only the first request after a refresh posts a message; later ones just add their parts to it.
+void RequestDisplayRefresh(unsigned parts) {
+    g_dirtyDisplayParts |= parts;
+    if (!g_displayRefreshPosted && g_hDlg) {
+        g_displayRefreshPosted = PostMessage(g_hDlg, WM_APP_REFRESH_DISPLAY, 0, 0) != FALSE;
     }
+}
+
+// --- Function to redraw the changed display parts ---
+// Retrieves only the values whose controls were marked and rewrites only those controls.
+void RefreshDisplay() {
+    unsigned parts = g_dirtyDisplayParts;
+    g_dirtyDisplayParts = 0;
+    g_displayRefreshPosted = false;
 
-    // Set the text of the static controls.
-    SetWindowTextA(g_hStaticGoldValue, gold_str.c_str());
-    SetWindowTextA(g_hStaticBeiValue, bei_str.c_str());
-    SetWindowTextA(g_hStaticFlameValue, flame_str.c_str());
-    SetWindowTextA(g_hStaticFollowerValue, follower_str.c_str());
+    bool loaded = g_saveGameManager.IsSaveFileLoaded();
+    if (parts & DISPLAY_GOLD) {
+        SetWindowTextA(g_hStaticGoldValue, loaded ? std::to_string(g_saveGameManager.GetGold()).c_str() : "");
+    }
+    if (parts & DISPLAY_BEI) {
+        SetWindowTextA(g_hStaticBeiValue, loaded ? std::to_string(g_saveGameManager.GetBei()).c_str() : "");
+    }
+    if (parts & DISPLAY_FLAME) {
+        SetWindowTextA(g_hStaticFlameValue, loaded ? std::to_string(g_saveGameManager.GetArtisansFlame()).c_str() : "");
+    }
+    if (parts & DISPLAY_FOLLOWERS) {
+        SetWindowTextA(g_hStaticFollowerValue, loaded ? std::to_string(g_saveGameManager.GetFollowerCount()).c_str() : "");
+    }
+    if (parts & DISPLAY_STATUS) {
+        std::string status = g_pendingStatusMessage;
+        if (!g_pendingSectionChanges.empty()) {
+            int total = 0;
+            std::string sections;
+            for (const auto& section : g_pendingSectionChanges) {
+                total += section.second;
+                sections += (sections.empty() ? "" : ", ") + section.first + " " + std::to_string(section.second);
+            }
+            status += (status.empty() ? "" : " ") + std::string("Changed ") + std::to_string(total) + " value(s): " + sections + ".";
+        } else if (status.empty()) {
+            status = "Nothing to change.";
+        }
+        SetWindowTextA(g_hStaticStatus, status.c_str());
+        g_pendingSectionChanges.clear();
+        g_pendingStatusMessage.clear();
+    }
+}
+
+// --- Attach to the parent console ---
+// GUI-subsystem executables have no console of their own. Headless runs attach to the console of the
+// process that launched them (if any) so their output is visible in the terminal.
+static void AttachParentConsole() {
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        FILE* stream = NULL;
+        freopen_s(&stream, "CONOUT$", "w", stdout);
+        freopen_s(&stream, "CONOUT$", "w", stderr);
+    }
 }
 
 // --- Entry Point: WinMain ---
@@ -140,21 +469,75 @@ void UpdateCurrencyDisplay() {
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
     // Suppress unused parameter warnings.
     (void)hPrevInstance;
+    (void)lpCmdLine; // Arguments are read pre-split from __argc/__argv.
+
+    StartupProfiler::Start(); // Begin the startup timeline as early as possible.
+
+    CommandLineOptions options = ParseCommandLine(__argc, __argv);
+    bool headless = IsHeadlessRun(options);
+    if (headless) {
+        AttachParentConsole();
+    }
 
-    // Check for "-log" command line argument to enable file logging.
-    bool enableFileLogging = (strstr(lpCmdLine, "-log") != nullptr);
-    Logger::Initialize("DaveSaveEd", enableFileLogging, BIN_DIRECTORY); // Initialize the logging system.
+    StartupProfiler::BeginPhase("Logger");
+    Logger::Initialize("DaveSaveEd", options.enableFileLogging, BIN_DIRECTORY); // Initialize the logging system.
+    StartupProfiler::EndPhase();
     LogMessage(LOG_INFO_LEVEL, "Application started.");
+    for (const std::string& warning : options.warnings) {
+        LogMessage(LOG_WARNING_LEVEL, warning.c_str());
+    }
+    if (!options.profileFile.empty()) {
+        SamplingProfiler::Start(options.profileFile);
+    }
+    Diagnostics::Initialize(options.dumpDiagnostics, DIAGNOSTICS_DIRECTORY);
+    if (!options.schemaFile.empty()) {
+        g_saveGameManager.LoadSchemaFile(options.schemaFile);
+    }
+
+    if (headless) {
+        int exit_code = RunHeadless(options);
+        Diagnostics::Shutdown();
+        SamplingProfiler::Stop();
+        Logger::Shutdown();
+        return exit_code;
+    }
+    g_saveGameManager.EnableEditJournal(EditJournal::DefaultJournalPath());
+    if (!options.catalogFile.empty()) {
+        std::string catalog_error;
+        StartupProfiler::BeginPhase("Item catalog");
+        bool catalog_open = g_itemCatalog.Open(options.catalogFile, catalog_error);
+        StartupProfiler::EndPhase();
+        if (catalog_open) {
+            g_saveGameManager.SetItemCatalog(&g_itemCatalog);
+            LogMessage(LOG_INFO_LEVEL, ("Using item catalog: " + options.catalogFile).c_str());
+        } else {
+            LogMessage(LOG_ERROR_LEVEL, (catalog_error + " Falling back to the reference database.").c_str());
+        }
+    }
 
     // Initialize COM (Component Object Model) for functions like SHGetKnownFolderPath.
+    StartupProfiler::BeginPhase("COM initialization");
     HRESULT hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+    StartupProfiler::EndPhase();
     if (FAILED(hr)) {
         LogMessage(LOG_ERROR_LEVEL, "COM Initialization Failed!");
         MessageBox(NULL, "COM Initialization Failed!", "Error", MB_ICONERROR | MB_OK);
+        SamplingProfiler::Stop();
         Logger::Shutdown();
         return 1;
     }
 
+    // Start loading the most recent save while the reference database and window are set up; it is
+    // almost always the one the user then opens.
+    {
+        ScopedStartupPhase phase("Save preload");
+        std::string latestSavePath;
+        SaveGameManager::GetDefaultSaveGameDirectoryAndLatestFile(latestSavePath);
+        if (!latestSavePath.empty()) {
+            g_savePreload.Start(latestSavePath);
+        }
+    }
+
     // Register the custom dialog window class.
     WNDCLASSEX wc = {0};
     wc.cbSize        = sizeof(WNDCLASSEX);
@@ -166,36 +549,59 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     wc.hIcon         = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)); // NEW: Set application icon
     wc.hIconSm       = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)); // NEW: Set small icon for taskbar/title bar
 
-    if (!RegisterClassEx(&wc)) {
+    StartupProfiler::BeginPhase("Window class registration");
+    ATOM class_atom = RegisterClassEx(&wc);
+    StartupProfiler::EndPhase();
+    if (!class_atom) {
         LogMessage(LOG_ERROR_LEVEL, "Window Registration Failed!");
         MessageBox(NULL, "Window Registration Failed!", "Error", MB_ICONERROR | MB_OK);
         CoUninitialize();
+        SamplingProfiler::Stop();
         Logger::Shutdown();
         return 1;
     }
 
-    // Create the main dialog window.
+    // Create the main dialog window. WM_CREATE (reference database and controls) runs inside this call.
+    StartupProfiler::BeginPhase("Window creation");
     g_hDlg = CreateWindowEx(
         WS_EX_APPWINDOW | WS_EX_WINDOWEDGE, // Extended window styles.
         "DaveSaveEdDialogClass",            // Class name.
         "DaveSaveEd",                       // NEW: Window title changed to "DaveSaveEd".
         WS_OVERLAPPEDWINDOW | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX, // Window styles.
         CW_USEDEFAULT, CW_USEDEFAULT,       // Default position.
-        450, 340,                           // Initial size.
+        450, 410,                           // Initial size.
         NULL,                               // Parent window.
         NULL,                               // Menu handle.
         hInstance,                          // Application instance.
         NULL                                // Window creation data.
     );
+    StartupProfiler::EndPhase();
 
     if (g_hDlg == NULL) {
         LogMessage(LOG_ERROR_LEVEL, "Window Creation Failed!");
         MessageBox(NULL, "Window Creation Failed!", "Error", MB_ICONERROR | MB_OK);
         CoUninitialize();
+        SamplingProfiler::Stop();
         Logger::Shutdown();
         return 1;
     }
 
+    // Import item display names; items come from the catalog if one is open, else from the database WM_CREATE opened.
+    if (!options.languageFile.empty()) {
+        std::string localization_error;
+        StartupProfiler::BeginPhase("Localization table");
+        bool localization_loaded = g_localization.Import(options.languageFile, &g_itemCatalog, g_refDb, localization_error);
+        StartupProfiler::EndPhase();
+        if (!localization_loaded) {
+            LogMessage(LOG_ERROR_LEVEL, (localization_error + " Items can only be named by text ID.").c_str());
+        } else {
+            if (!options.language.empty() && !g_localization.SetLanguage(options.language)) {
+                LogMessage(LOG_WARNING_LEVEL, ("The localization table has no language '" + options.language + "'.").c_str());
+            }
+            LogMessage(LOG_INFO_LEVEL, ("Imported " + std::to_string(g_localization.GetNameCount()) + " item names; using " + g_localization.GetLanguage() + ".").c_str());
+        }
+    }
+
     // Center the dialog window on the screen.
     RECT rcScreen;
     GetClientRect(GetDesktopWindow(), &rcScreen);
@@ -214,8 +620,12 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
                  SWP_NOSIZE | SWP_NOZORDER);
 
     // Display the window and begin the message loop.
+    StartupProfiler::BeginPhase("First paint");
     ShowWindow(g_hDlg, nCmdShow);
     UpdateWindow(g_hDlg);
+    StartupProfiler::EndPhase();
+    StartupProfiler::MarkInteractive();
+    StartupProfiler::Report();
 
     MSG msg = {0};
     while (GetMessage(&msg, NULL, 0, 0)) {
@@ -229,7 +639,11 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         DeleteObject(g_hBackgroundBrush);
         g_hBackgroundBrush = NULL;
     }
+    g_saveGameManager.DiscardEditJournal(); // Clean exit: unsaved edits were abandoned on purpose.
+    g_savePreload.Close(); // Wait for a preload still running; it logs.
     CoUninitialize(); // Uninitialize COM.
+    Diagnostics::Shutdown(); // Wait for any diagnostic dump still being written.
+    SamplingProfiler::Stop(); // Write the profile, if one was requested.
     Logger::Shutdown(); // Shut down the logging system.
     return (int)msg.wParam;
 }
@@ -250,64 +664,23 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 
             // --- Reference Database Initialization (from embedded_sql.h) ---
             // Opens an in-memory SQLite database and populates it from compressed SQL data.
-            int rc = sqlite3_open(":memory:", &g_refDb);
-            if (rc != SQLITE_OK) {
-                LogMessage(LOG_ERROR_LEVEL, (std::string("Cannot open in-memory reference database: ") + sqlite3_errmsg(g_refDb)).c_str());
-                MessageBox(hDlg, "Failed to open reference database! Application might not function correctly.", "Database Error", MB_ICONERROR | MB_OK);
-            } else {
-                LogMessage(LOG_INFO_LEVEL, "In-memory reference database opened successfully.");
-
-                // Decompress the embedded SQL data using zlib.
-                z_stream strm;
-                strm.zalloc = Z_NULL;
-                strm.zfree = Z_NULL;
-                strm.opaque = Z_NULL;
-                strm.avail_in = 0;
-                strm.next_in = Z_NULL;
-
-                const size_t MAX_UNCOMPRESSED_SIZE = 150000; // Estimated max size for decompressed data.
-                std::vector<char> decompressed_buffer(MAX_UNCOMPRESSED_SIZE);
-
-                rc = inflateInit(&strm); // Initialize the zlib decompression stream.
-                if (rc != Z_OK) {
-                    LogMessage(LOG_ERROR_LEVEL, (std::string("zlib inflateInit failed: ") + std::string(strm.msg ? strm.msg : "Unknown error")).c_str());
-                    MessageBox(hDlg, "Failed to initialize decompressor!", "Decompression Error", MB_ICONERROR | MB_OK);
-                    inflateEnd(&strm);
-                    sqlite3_close(g_refDb);
-                    g_refDb = NULL;
-                    return 0;
-                }
-
-                strm.avail_in = static_cast<uInt>(embedded_sql_compressed_size);
-                strm.next_in = (Bytef*)embedded_sql_compressed;
-                strm.avail_out = static_cast<uInt>(decompressed_buffer.size());
-                strm.next_out = (Bytef*)decompressed_buffer.data();
-
-                rc = inflate(&strm, Z_FINISH); // Perform decompression.
-                if (rc != Z_STREAM_END) {
-                    LogMessage(LOG_ERROR_LEVEL, (std::string("zlib inflate failed: ") + std::string(strm.msg ? strm.msg : "Unknown error")).c_str());
-                    MessageBox(hDlg, "Failed to decompress SQL data!", "Decompression Error", MB_ICONERROR | MB_OK);
-                    inflateEnd(&strm);
-                    sqlite3_close(g_refDb);
-                    g_refDb = NULL;
-                    return 0;
-                }
-
-                inflateEnd(&strm); // Clean up zlib stream.
-
-                std::string decompressed_sql_str(decompressed_buffer.data(), strm.total_out);
-                LogMessage(LOG_INFO_LEVEL, (std::string("SQL data decompressed successfully. Original size: ") + std::to_string(strm.total_out) + " bytes.").c_str());
+            std::string db_error;
+            {
+                ScopedStartupPhase phase("Reference database");
+                g_refDb = ReferenceDatabase::Open(db_error);
+            }
+            if (!g_refDb) {
+                MessageBox(hDlg, db_error.c_str(), "Database Error", MB_ICONERROR | MB_OK);
+            }
 
-                // Execute the decompressed SQL statements to populate the in-memory database.
-                rc = sqlite3_exec(g_refDb, decompressed_sql_str.c_str(), 0, 0, 0);
-                if (rc != SQLITE_OK) {
-                    LogMessage(LOG_ERROR_LEVEL, (std::string("Failed to execute embedded SQL dump for reference DB: ") + sqlite3_errmsg(g_refDb)).c_str());
-                    MessageBox(hDlg, "Failed to populate reference database from embedded SQL!", "Database Error", MB_ICONERROR | MB_OK);
-                } else {
-                    LogMessage(LOG_INFO_LEVEL, "Reference database populated from embedded SQL successfully.");
-                }
+            // Add the diagnostic dump command to the window's system menu.
+            HMENU hSysMenu = GetSystemMenu(hDlg, FALSE);
+            if (hSysMenu) {
+                AppendMenuA(hSysMenu, MF_SEPARATOR, 0, NULL);
+                AppendMenuA(hSysMenu, MF_STRING, IDM_DIAGNOSTIC_DUMP, "Write Diagnostic Dump");
             }
 
+            ScopedStartupPhase controls_phase("Create controls");
             // --- Create UI Elements (Centered Layout) ---
             // Defines dimensions and spacing for UI controls to achieve a centered layout.
             int control_height = 24;
@@ -337,12 +710,14 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 
             // Calculate total height needed for all UI blocks.
             int total_currency_block_height = (control_height * 4) + (spacing_y * 3);
-            int total_ingredient_block_height = control_height;
+            int total_ingredient_block_height = (control_height * 3) + (section_spacing_y * 2);
             int total_file_block_height = control_height + 5; // +5 for slight extra spacing.
+            int total_status_block_height = control_height;
 
             int total_ui_elements_height = total_currency_block_height + section_spacing_y +
                                            total_ingredient_block_height + section_spacing_y +
-                                           total_file_block_height;
+                                           total_file_block_height + spacing_y +
+                                           total_status_block_height;
 
             // Calculate initial Y position to vertically center the UI elements.
             int y_pos_start = (dialog_client_height - total_ui_elements_height) / 2;
@@ -405,6 +780,12 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 ing_x_start + ing_btn_width + ing_btn_spacing, y_pos, ing_btn_width, control_height, hDlg, (HMENU)IDC_BTN_MAX_LEVEL_OWN_STAFF, GetModuleHandle(NULL), NULL);
             y_pos += control_height + section_spacing_y;
 
+            CreateWindowEx(0, "BUTTON", "Import Counts...", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+                ing_x_start, y_pos, ing_btn_width, control_height, hDlg, (HMENU)IDC_BTN_IMPORT_COUNTS, GetModuleHandle(NULL), NULL);
+            CreateWindowEx(0, "BUTTON", "Set Gain Times to Now", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+                ing_x_start + ing_btn_width + ing_btn_spacing, y_pos, ing_btn_width, control_height, hDlg, (HMENU)IDC_BTN_GAIN_TIMES_NOW, GetModuleHandle(NULL), NULL);
+            y_pos += control_height + section_spacing_y;
+
             // Create File Operation UI Elements.
             int file_x_start = (dialog_client_width - file_row_total_width) / 2;
 
@@ -412,10 +793,27 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 file_x_start, y_pos, file_btn_width, control_height + 5, hDlg, (HMENU)IDC_BTN_LOAD_SAVE, GetModuleHandle(NULL), NULL);
             CreateWindowEx(0, "BUTTON", "Write Save File", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
                 file_x_start + file_btn_width + file_btn_spacing, y_pos, file_btn_width, control_height + 5, hDlg, (HMENU)IDC_BTN_WRITE_SAVE, GetModuleHandle(NULL), NULL);
+            y_pos += control_height + 5 + spacing_y;
+
+            // Create the status line, as wide as the ingredient rows.
+            g_hStaticStatus = CreateWindowEx(WS_EX_TRANSPARENT, "STATIC", "No save file loaded.", WS_CHILD | WS_VISIBLE | SS_CENTER | SS_ENDELLIPSIS,
+                ing_x_start, y_pos, ingredient_row_total_width, control_height, hDlg, (HMENU)IDC_STATIC_STATUS, GetModuleHandle(NULL), NULL);
+
+            // Refresh the display from change events instead of after every command.
+            g_saveGameManager.SubscribeToChanges(OnSaveDataChanged);
 
+            PostMessage(hDlg, WM_APP_OFFER_RECOVERY, 0, 0);
             return 0;
         }
 
+        case WM_APP_OFFER_RECOVERY:
+            OfferSessionRecovery(hDlg);
+            return 0;
+
+        case WM_APP_REFRESH_DISPLAY:
+            RefreshDisplay();
+            return 0;
+
         case WM_COMMAND: {
             // Handle button clicks and other command messages.
             WORD controlId = GET_WM_COMMAND_ID(wParam, lParam);
@@ -425,7 +823,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Gold button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.SetGold(999999999); // Set gold to max value.
-                        UpdateCurrencyDisplay(); // Refresh UI.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                         LogMessage(LOG_INFO_LEVEL, "Attempted to set max gold without a loaded save file.");
@@ -435,7 +833,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Bei button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.SetBei(999999999); // Set Bei to max value.
-                        UpdateCurrencyDisplay(); // Refresh UI.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                         LogMessage(LOG_INFO_LEVEL, "Attempted to set max bei without a loaded save file.");
@@ -445,7 +843,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Artisan's Flame button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.SetArtisansFlame(999999); // Set Artisan's Flame to max value.
-                        UpdateCurrencyDisplay(); // Refresh UI.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                         LogMessage(LOG_INFO_LEVEL, "Attempted to set max artisan's flame without a loaded save file.");
@@ -455,7 +853,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Follower Count button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.SetFollowerCount(99999);
-                        UpdateCurrencyDisplay();
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                     }
@@ -464,7 +862,8 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Own Ingredients button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.MaxOwnIngredients(g_refDb); // Pass the reference DB
-                        // Update UI if any changes are visible (e.g., if ingredient counts were displayed).
+                        RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                     }
@@ -473,7 +872,8 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max All Ingredients button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.MaxAllIngredients(g_refDb); // Pass reference DB for ingredient data.
-                        // Update UI if any changes are visible.
+                        RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                     }
@@ -482,7 +882,8 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Own Material button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.MaxOwnMaterials(g_refDb); // Pass the reference DB
-                        // Update UI if any changes are visible (e.g., if ingredient counts were displayed).
+                        RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+                        RequestAutoDiagnosticDump();
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                     }
@@ -491,7 +892,26 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     LogMessage(LOG_INFO_LEVEL, "Max Own Staff Level button clicked.");
                     if (g_saveGameManager.IsSaveFileLoaded()) {
                         g_saveGameManager.MaxOwnStaffLevel(); // Pass the reference DB
-                        // Update UI if any changes are visible (e.g., if ingredient counts were displayed).
+                        RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+                        RequestAutoDiagnosticDump();
+                    } else {
+                        MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
+                    }
+                    break;
+                case IDC_BTN_GAIN_TIMES_NOW:
+                    LogMessage(LOG_INFO_LEVEL, "Set Gain Times to Now button clicked.");
+                    if (g_saveGameManager.IsSaveFileLoaded()) {
+                        g_saveGameManager.SetIngredientGainTimes(CurrentLocalTimestamp());
+                        RequestDisplayRefresh(DISPLAY_STATUS); // Report the outcome, even if nothing changed.
+                        RequestAutoDiagnosticDump();
+                    } else {
+                        MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
+                    }
+                    break;
+                case IDC_BTN_IMPORT_COUNTS:
+                    LogMessage(LOG_INFO_LEVEL, "Import Counts button clicked.");
+                    if (g_saveGameManager.IsSaveFileLoaded()) {
+                        ImportItemCountsFromFile(hDlg);
                     } else {
                         MessageBox(hDlg, "No save file loaded or valid data to modify!", "Error", MB_ICONWARNING | MB_OK);
                     }
@@ -510,7 +930,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     ofn.hwndOwner = hDlg;
                     ofn.lpstrFile = szFile;
                     ofn.nMaxFile = sizeof(szFile);
-                    ofn.lpstrFilter = "Dave the Diver Save Files (*.sav)\0*.sav\0All Files (*.*)\0*.*\0";
+                    ofn.lpstrFilter = "Dave the Diver Save Files (*.sav)\0*.sav\0Save Archives, read-only (*.zip;*.gz)\0*.zip;*.gz\0All Files (*.*)\0*.*\0";
                     ofn.nFilterIndex = 1;
                     ofn.lpstrFileTitle = NULL;
                     ofn.nMaxFileTitle = 0;
@@ -524,21 +944,25 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 
                     // Show the Open File dialog.
                     if (GetOpenFileNameA(&ofn) == TRUE) {
-                        // Attempt to load the selected save file using the SaveGameManager.
-                        if (g_saveGameManager.LoadSaveFile(ofn.lpstrFile)) {
+                        // Take the save preloaded at startup if it is the one selected and unchanged;
+                        // otherwise load the selected save file using the SaveGameManager.
+                        if (g_savePreload.TakeInto(ofn.lpstrFile, g_saveGameManager) || g_saveGameManager.LoadSaveFile(ofn.lpstrFile)) {
+                            MatchCatalogVersionToSave();
                             //MessageBox(hDlg, "Save file loaded successfully!", "Success", MB_ICONINFORMATION | MB_OK);
                         } else {
                             MessageBox(hDlg, "Failed to load or parse save file!", "Load Error", MB_ICONERROR | MB_OK);
                         }
-                        UpdateCurrencyDisplay(); // Always update UI after load attempt.
                     } else {
                         LogMessage(LOG_INFO_LEVEL, "File selection cancelled.");
-                        UpdateCurrencyDisplay(); // Update UI to reflect no file loaded (e.g., clear fields).
                     }
                     break;
                 }
                 case IDC_BTN_WRITE_SAVE:
                     LogMessage(LOG_INFO_LEVEL, "Write Save File button clicked.");
+                    if (!ConfirmSaveConsistency(hDlg)) {
+                        LogMessage(LOG_INFO_LEVEL, "Write cancelled after the consistency check.");
+                        break;
+                    }
                     std::string backup_path;
                     if (g_saveGameManager.WriteSaveFile(backup_path)) {
                         std::string outro = "Save file updated and backed up to " + backup_path += "!"; 
@@ -552,6 +976,15 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
             return 0;
         }
         
+        case WM_SYSCOMMAND:
+            // Handle our custom system menu command; everything else goes to the default handler.
+            if ((wParam & 0xFFF0) == IDM_DIAGNOSTIC_DUMP) {
+                LogMessage(LOG_INFO_LEVEL, "Diagnostic dump requested from the system menu.");
+                Diagnostics::RequestDump(g_saveGameManager.IsSaveFileLoaded() ? &g_saveGameManager.GetSaveData() : NULL, g_refDb);
+                return 0;
+            }
+            return DefWindowProc(hDlg, message, wParam, lParam);
+
         case WM_CLOSE:
             LogMessage(LOG_INFO_LEVEL, "WM_CLOSE received. Destroying window.");
             DestroyWindow(hDlg); // Destroy the window.
@@ -561,8 +994,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
             LogMessage(LOG_INFO_LEVEL, "WM_DESTROY received. Posting quit message.");
             // Close the reference database if it's open.
             if (g_refDb) {
-                sqlite3_close(g_refDb);
-                g_refDb = NULL;
+                ReferenceDatabase::Close(g_refDb);
                 LogMessage(LOG_INFO_LEVEL, "Reference database closed.");
             }
             PostQuitMessage(0); // Signal the application to exit the message loop.
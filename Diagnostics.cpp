@@ -0,0 +1,288 @@
+// Diagnostics.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "Diagnostics.h"
+#include <thread>           // For std::thread
+#include <mutex>            // For std::mutex, std::lock_guard, std::unique_lock
+#include <condition_variable> // For std::condition_variable
+#include <memory>           // For std::unique_ptr
+#include <vector>           // For std::vector
+#include <cstring>          // For strlen
+#include <filesystem>       // For std::filesystem::path, create_directories
+#include <chrono>           // For timing dumps
+#include "BufferedWriter.h" // For BufferedFileWriter, WriteJson
+#include "Logger.h"         // For LogMessage
+#include "WorkerThreads.h"  // For RunWorkerThreads
+
+// A point-in-time copy of everything a dump writes, so the UI can keep editing while it is written.
+struct DiagnosticSnapshot {
+    bool hasSaveData = false;
+    SaveJson saveData;
+    unsigned char* dbImage = nullptr;   // sqlite3_serialize() image of the reference database.
+    sqlite3_int64 dbImageSize = 0;
+
+    ~DiagnosticSnapshot() {
+        if (dbImage) {
+            sqlite3_free(dbImage);
+        }
+    }
+};
+
+// State shared between the UI thread and the background dump thread.
+static bool s_autoDumpEnabled = false;
+static std::filesystem::path s_outputDir;
+static std::mutex s_mutex;
+static std::condition_variable s_wakeUp;
+static std::unique_ptr<DiagnosticSnapshot> s_pending;
+static std::thread s_worker;
+static bool s_stopRequested = false;
+
+// Opens a private read-only connection onto a serialized database image.
+// Each export thread gets its own connection, so tables can be read fully in parallel.
+static sqlite3* OpenSnapshotConnection(const DiagnosticSnapshot& snapshot) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK) {
+        sqlite3_close(db);
+        return nullptr;
+    }
+    int rc = sqlite3_deserialize(db, "main", snapshot.dbImage, snapshot.dbImageSize, snapshot.dbImageSize, SQLITE_DESERIALIZE_READONLY);
+    if (rc != SQLITE_OK) {
+        sqlite3_close(db);
+        return nullptr;
+    }
+    return db;
+}
+
+// Writes one CSV field, quoting it if it contains a delimiter, quote or line break.
+static void WriteCsvField(BufferedFileWriter& out, const char* text) {
+    if (!text) {
+        return; // SQL NULL is written as an empty field.
+    }
+    bool needs_quotes = false;
+    for (const char* p = text; *p; ++p) {
+        if (*p == ',' || *p == '"' || *p == '\n' || *p == '\r') {
+            needs_quotes = true;
+            break;
+        }
+    }
+    if (!needs_quotes) {
+        out.Write(text, strlen(text));
+        return;
+    }
+    out.Put('"');
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"') {
+            out.Put('"');
+        }
+        out.Put(*p);
+    }
+    out.Put('"');
+}
+
+// Exports a single table of the snapshot database to <outputDir>/<table>.csv.
+static void ExportTableToCsv(const DiagnosticSnapshot& snapshot, const std::string& table_name, const std::filesystem::path& output_dir) {
+    sqlite3* db = OpenSnapshotConnection(snapshot);
+    if (!db) {
+        LogMessage(LOG_ERROR_LEVEL, ("Diagnostics: could not open snapshot connection for table " + table_name).c_str());
+        return;
+    }
+
+    std::string quoted_name = "\"";
+    for (char c : table_name) {
+        quoted_name += c;
+        if (c == '"') {
+            quoted_name += '"';
+        }
+    }
+    quoted_name += "\"";
+    std::string query = "SELECT * FROM " + quoted_name + ";";
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        LogMessage(LOG_ERROR_LEVEL, ("Diagnostics: failed to query table " + table_name + ": " + sqlite3_errmsg(db)).c_str());
+        sqlite3_close(db);
+        return;
+    }
+
+    BufferedFileWriter out;
+    std::filesystem::path csv_path = output_dir / (table_name + ".csv");
+    if (!out.Open(csv_path.string())) {
+        LogMessage(LOG_ERROR_LEVEL, ("Diagnostics: failed to open " + csv_path.string() + " for writing.").c_str());
+    } else {
+        int cols = sqlite3_column_count(stmt);
+        for (int i = 0; i < cols; ++i) {
+            if (i > 0) {
+                out.Put(',');
+            }
+            WriteCsvField(out, sqlite3_column_name(stmt, i));
+        }
+        out.Put('\n');
+
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            for (int i = 0; i < cols; ++i) {
+                if (i > 0) {
+                    out.Put(',');
+                }
+                WriteCsvField(out, reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)));
+            }
+            out.Put('\n');
+        }
+        if (!out.Close()) {
+            LogMessage(LOG_ERROR_LEVEL, ("Diagnostics: write error on " + csv_path.string()).c_str());
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+}
+
+// Exports every table of the snapshot database, on up to one thread per core.
+static void ExportDatabase(const DiagnosticSnapshot& snapshot, const std::filesystem::path& output_dir) {
+    std::vector<std::string> table_names;
+    sqlite3* db = OpenSnapshotConnection(snapshot);
+    if (!db) {
+        LogMessage(LOG_ERROR_LEVEL, "Diagnostics: could not open reference database snapshot.");
+        return;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT name FROM sqlite_master WHERE type='table';", -1, &stmt, nullptr) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            table_names.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+        }
+        sqlite3_finalize(stmt);
+    } else {
+        LogMessage(LOG_ERROR_LEVEL, "Diagnostics: failed to list reference tables.");
+    }
+    sqlite3_close(db);
+
+    // Each worker takes the next table name until none are left, so large tables do not pile up on one thread.
+    RunWorkerThreads(table_names.size(), 0, "diagnostics export", [&](std::atomic<size_t>& next) {
+        for (size_t index = next++; index < table_names.size(); index = next++) {
+            ExportTableToCsv(snapshot, table_names[index], output_dir);
+        }
+    });
+}
+
+// Writes the save data snapshot as indented JSON to <outputDir>/save_dump.txt.
+static void DumpSaveData(const DiagnosticSnapshot& snapshot, const std::filesystem::path& output_dir) {
+    std::filesystem::path output_path = output_dir / "save_dump.txt";
+    BufferedFileWriter out;
+    if (!out.Open(output_path.string())) {
+        LogMessage(LOG_ERROR_LEVEL, "Diagnostics: failed to open save_dump.txt for writing.");
+        return;
+    }
+    try {
+        WriteJson(snapshot.saveData, out, 4); // 4 = indent size
+    } catch (const std::exception& ex) {
+        LogMessage(LOG_ERROR_LEVEL, ("Diagnostics: failed to serialize save data: " + std::string(ex.what())).c_str());
+    }
+    if (!out.Close()) {
+        LogMessage(LOG_ERROR_LEVEL, "Diagnostics: write error on save_dump.txt.");
+    }
+}
+
+// Background thread: waits for snapshots and writes them until shutdown is requested.
+static void DumpWorker() {
+    for (;;) {
+        std::unique_ptr<DiagnosticSnapshot> snapshot;
+        {
+            std::unique_lock<std::mutex> lock(s_mutex);
+            s_wakeUp.wait(lock, [] { return s_pending || s_stopRequested; });
+            if (!s_pending) {
+                return; // Stop requested and nothing left to write.
+            }
+            snapshot = std::move(s_pending);
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        try {
+            std::filesystem::create_directories(s_outputDir);
+            if (snapshot->hasSaveData) {
+                DumpSaveData(*snapshot, s_outputDir);
+            }
+            if (snapshot->dbImage) {
+                ExportDatabase(*snapshot, s_outputDir);
+            }
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+            LogMessage(LOG_INFO_LEVEL, ("Diagnostic dump written to " + s_outputDir.string() + " in " + std::to_string(elapsed_ms) + " ms.").c_str());
+        } catch (const std::exception& ex) {
+            LogMessage(LOG_ERROR_LEVEL, ("Diagnostic dump failed: " + std::string(ex.what())).c_str());
+        }
+    }
+}
+
+void Diagnostics::Initialize(bool autoDumpEnabled, const std::string& outputDir) {
+    s_autoDumpEnabled = autoDumpEnabled;
+    s_outputDir = outputDir;
+    if (autoDumpEnabled) {
+        LogMessage(LOG_INFO_LEVEL, ("Diagnostic dumps enabled after each edit. Output directory: " + outputDir).c_str());
+    }
+}
+
+bool Diagnostics::IsAutoDumpEnabled() {
+    return s_autoDumpEnabled;
+}
+
+void Diagnostics::RequestDump(const SaveJson* saveData, sqlite3* db) {
+    auto snapshot = std::make_unique<DiagnosticSnapshot>();
+    if (saveData) {
+        snapshot->hasSaveData = true;
+        snapshot->saveData = *saveData;
+    }
+    if (db) {
+        snapshot->dbImage = sqlite3_serialize(db, "main", &snapshot->dbImageSize, 0);
+        if (!snapshot->dbImage) {
+            LogMessage(LOG_ERROR_LEVEL, "Diagnostics: failed to snapshot the reference database.");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_pending) {
+        LogMessage(LOG_INFO_LEVEL, "Diagnostics: replacing a queued dump with a newer snapshot.");
+    }
+    s_pending = std::move(snapshot);
+    if (!s_worker.joinable()) {
+        s_stopRequested = false;
+        s_worker = std::thread(DumpWorker);
+    }
+    s_wakeUp.notify_one();
+}
+
+void Diagnostics::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_stopRequested = true;
+    }
+    s_wakeUp.notify_one();
+    if (s_worker.joinable()) {
+        s_worker.join();
+    }
+}
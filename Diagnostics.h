@@ -0,0 +1,62 @@
+// Diagnostics.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include "SaveJson.h"       // For SaveJson
+#include "sqlite3.h"        // For sqlite3
+
+// The Diagnostics class writes diagnostic dumps of the loaded save data and the reference database.
+// Dumps are off by default. When requested, the caller's state is snapshotted and written on a
+// background thread: the save data as pretty-printed JSON, and each reference table as its own CSV
+// file, with tables exported in parallel.
+class Diagnostics {
+public:
+    // Configures the diagnostics subsystem.
+    // Parameters:
+    //   autoDumpEnabled: If true (the -dump flag), a dump is written after every edit operation.
+    //   outputDir: Directory the dump files are written to. Created on first use.
+    static void Initialize(bool autoDumpEnabled, const std::string& outputDir);
+
+    // Returns true if dumps should be written automatically after edit operations.
+    static bool IsAutoDumpEnabled();
+
+    // Snapshots the given state and queues it to be written on the background thread.
+    // If a previous dump is still waiting to start, it is replaced by this newer snapshot.
+    // Parameters:
+    //   saveData: The save data to dump, or NULL if no save file is loaded.
+    //   db: The reference database to export, or NULL to skip it.
+    static void RequestDump(const SaveJson* saveData, sqlite3* db);
+
+    // Waits for any queued or running dump to finish and stops the background thread.
+    static void Shutdown();
+};
@@ -0,0 +1,292 @@
+// EditJournal.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#define NOMINMAX // Prevent Windows.h from defining min/max macros
+
+#include "EditJournal.h"
+#include <windows.h>    // For GetTempPathW, FlushFileBuffers
+#include <io.h>         // For _get_osfhandle
+#include <cstring>      // For memcpy
+#include <filesystem>   // For std::filesystem::file_size, last_write_time, remove
+#include "zlib.h"       // For crc32
+#include "Logger.h"     // For LogMessage
+
+// --- Journal file layout ---
+// Header:  magic "DSEJ", uint32 version, uint64 source size, int64 source write time,
+//          uint32 source path length, source path bytes.
+// Records: JournalRecord, repeated until end of file.
+static const char JOURNAL_MAGIC[4] = { 'D', 'S', 'E', 'J' };
+static const uint32_t JOURNAL_VERSION = 2;
+// Upper bound on the stored source path, to reject garbage headers before allocating.
+static const uint32_t JOURNAL_MAX_PATH_LENGTH = 32768;
+// Minimum time between forced disk flushes.
+static const std::chrono::milliseconds JOURNAL_SYNC_INTERVAL_MS(500);
+
+#pragma pack(push, 1)
+struct JournalRecord {
+    uint32_t op;
+    uint32_t checksum;  // crc32 over op, value and catalogVersion; detects records torn by a crash mid-write.
+    int64_t value;
+    uint32_t catalogVersion;
+};
+#pragma pack(pop)
+
+static uint32_t RecordChecksum(uint32_t op, int64_t value, uint32_t catalogVersion) {
+    unsigned char bytes[sizeof(op) + sizeof(value) + sizeof(catalogVersion)];
+    memcpy(bytes, &op, sizeof(op));
+    memcpy(bytes + sizeof(op), &value, sizeof(value));
+    memcpy(bytes + sizeof(op) + sizeof(value), &catalogVersion, sizeof(catalogVersion));
+    return static_cast<uint32_t>(crc32(0L, bytes, sizeof(bytes)));
+}
+
+bool EditJournal::GetSourceFingerprint(const std::string& sourcePath, uint64_t& size, int64_t& writeTime) {
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::path(sourcePath);
+    size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+EditJournal::EditJournal()
+    : m_file(NULL), m_catalogVersion(0), m_handle(NULL), m_syncPending(false), m_flushing(false), m_stopSync(false) {}
+
+EditJournal::~EditJournal() {
+    if (m_syncThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_syncMutex);
+            m_stopSync = true;
+        }
+        m_syncWake.notify_all();
+        m_syncThread.join();
+    }
+    // Keep the file: a journal still open at destruction belongs to a session that was never written.
+    if (m_file) {
+        if (m_syncPending) {
+            FlushFileBuffers(static_cast<HANDLE>(m_handle));
+        }
+        CloseFile();
+    }
+}
+
+void EditJournal::CloseFile() {
+    {
+        std::unique_lock<std::mutex> lock(m_syncMutex);
+        m_syncWake.wait(lock, [this] { return !m_flushing; });
+        m_handle = NULL;
+        m_syncPending = false;
+    }
+    fclose(m_file);
+    m_file = NULL;
+}
+
+void EditJournal::SyncLoop() {
+    std::unique_lock<std::mutex> lock(m_syncMutex);
+    while (!m_stopSync) {
+        if (!m_syncPending || !m_handle) {
+            m_syncWake.wait(lock);
+            continue;
+        }
+        // Appends within the interval of the last flush share the next one.
+        const auto due = m_lastSync + JOURNAL_SYNC_INTERVAL_MS;
+        if (std::chrono::steady_clock::now() < due) {
+            m_syncWake.wait_until(lock, due);
+            continue;
+        }
+        HANDLE handle = static_cast<HANDLE>(m_handle);
+        m_syncPending = false;
+        m_flushing = true;
+        lock.unlock();
+        // The OS handle, not _commit: the CRT would hold the descriptor's lock for the whole flush and
+        // stall appends meanwhile.
+        FlushFileBuffers(handle);
+        lock.lock();
+        m_flushing = false;
+        m_lastSync = std::chrono::steady_clock::now();
+        m_syncWake.notify_all();
+    }
+}
+
+bool EditJournal::Begin(const std::string& journalPath, const std::string& sourcePath, uint64_t sourceSize, int64_t sourceWriteTime) {
+    if (m_file) {
+        CloseFile();
+    }
+    m_path = journalPath;
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(journalPath).parent_path(), ec);
+    m_file = fopen(journalPath.c_str(), "wb");
+    if (!m_file) {
+        LogMessage(LOG_ERROR_LEVEL, ("Could not create edit journal: " + journalPath).c_str());
+        return false;
+    }
+
+    uint32_t path_length = static_cast<uint32_t>(sourcePath.size());
+    bool ok = fwrite(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC), 1, m_file) == 1 &&
+              fwrite(&JOURNAL_VERSION, sizeof(JOURNAL_VERSION), 1, m_file) == 1 &&
+              fwrite(&sourceSize, sizeof(sourceSize), 1, m_file) == 1 &&
+              fwrite(&sourceWriteTime, sizeof(sourceWriteTime), 1, m_file) == 1 &&
+              fwrite(&path_length, sizeof(path_length), 1, m_file) == 1 &&
+              fwrite(sourcePath.data(), 1, path_length, m_file) == path_length;
+    if (!ok) {
+        LogMessage(LOG_ERROR_LEVEL, ("Could not write edit journal header: " + journalPath).c_str());
+        Discard();
+        return false;
+    }
+    fflush(m_file);
+    {
+        std::lock_guard<std::mutex> lock(m_syncMutex);
+        m_handle = reinterpret_cast<void*>(_get_osfhandle(_fileno(m_file)));
+        m_syncPending = true;
+    }
+    if (!m_syncThread.joinable()) {
+        m_syncThread = std::thread(&EditJournal::SyncLoop, this);
+    }
+    m_syncWake.notify_all();
+    LogMessage(LOG_INFO_LEVEL, ("Edit journal started: " + journalPath).c_str());
+    return true;
+}
+
+bool EditJournal::Append(JournalOp op, long long value) {
+    JournalEntry entry;
+    entry.op = op;
+    entry.value = value;
+    entry.catalogVersion = m_catalogVersion;
+    return Append(entry);
+}
+
+bool EditJournal::Append(const JournalEntry& entry) {
+    if (!m_file) {
+        return false;
+    }
+    JournalRecord record;
+    record.op = static_cast<uint32_t>(entry.op);
+    record.value = static_cast<int64_t>(entry.value);
+    record.catalogVersion = entry.catalogVersion;
+    record.checksum = RecordChecksum(record.op, record.value, record.catalogVersion);
+    if (fwrite(&record, sizeof(record), 1, m_file) != 1 || fflush(m_file) != 0) {
+        LogMessage(LOG_ERROR_LEVEL, "Failed to append to the edit journal.");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_syncMutex);
+        m_syncPending = true;
+    }
+    m_syncWake.notify_all();
+    return true;
+}
+
+void EditJournal::Discard() {
+    if (m_file) {
+        CloseFile();
+    }
+    if (!m_path.empty()) {
+        Remove(m_path);
+    }
+}
+
+void EditJournal::Remove(const std::string& journalPath) {
+    std::error_code ec;
+    if (std::filesystem::remove(std::filesystem::path(journalPath), ec)) {
+        LogMessage(LOG_INFO_LEVEL, ("Edit journal removed: " + journalPath).c_str());
+    }
+}
+
+std::string EditJournal::DefaultJournalPath() {
+    std::filesystem::path journal_dir;
+    wchar_t tempPathBuffer[MAX_PATH];
+    DWORD length = GetTempPathW(MAX_PATH, tempPathBuffer);
+    if (length == 0 || length > MAX_PATH) {
+        journal_dir = std::filesystem::path("DaveSaveEd_Journal"); // Fall back to the working directory.
+    } else {
+        journal_dir = std::filesystem::path(tempPathBuffer) / "DaveSaveEd_Journal";
+    }
+    return (journal_dir / "session.journal").string();
+}
+
+bool EditJournal::Read(const std::string& journalPath, JournalContents& out) {
+    out = JournalContents();
+    FILE* file = fopen(journalPath.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[sizeof(JOURNAL_MAGIC)];
+    uint32_t version = 0;
+    uint32_t path_length = 0;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, file) == 1 && version == JOURNAL_VERSION &&
+              fread(&out.sourceSize, sizeof(out.sourceSize), 1, file) == 1 &&
+              fread(&out.sourceWriteTime, sizeof(out.sourceWriteTime), 1, file) == 1 &&
+              fread(&path_length, sizeof(path_length), 1, file) == 1 && path_length <= JOURNAL_MAX_PATH_LENGTH;
+    if (ok) {
+        out.sourcePath.resize(path_length);
+        ok = fread(&out.sourcePath[0], 1, path_length, file) == path_length;
+    }
+    if (!ok) {
+        LogMessage(LOG_WARNING_LEVEL, ("Edit journal has an invalid header: " + journalPath).c_str());
+        fclose(file);
+        return false;
+    }
+
+    JournalRecord record;
+    const size_t record_size = sizeof(JournalRecord);
+    size_t read;
+    while ((read = fread(&record, 1, record_size, file)) == record_size) {
+        if (record.checksum != RecordChecksum(record.op, record.value, record.catalogVersion)) {
+            out.truncated = true;
+            break;
+        }
+        JournalEntry entry;
+        entry.op = static_cast<JournalOp>(record.op);
+        entry.value = static_cast<long long>(record.value);
+        entry.catalogVersion = record.catalogVersion;
+        out.entries.push_back(entry);
+    }
+    if (read != 0 && read != record_size) {
+        out.truncated = true; // Partial final record.
+    }
+    fclose(file);
+    return true;
+}
+
+bool EditJournal::SourceMatches(const JournalContents& contents) {
+    uint64_t size = 0;
+    int64_t write_time = 0;
+    return GetSourceFingerprint(contents.sourcePath, size, write_time) &&
+           size == contents.sourceSize && write_time == contents.sourceWriteTime;
+}
@@ -0,0 +1,157 @@
+// EditJournal.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Edit operations recorded in the journal. Values are stored in the file, so never renumber them.
+enum JournalOp : uint32_t {
+    JOURNAL_OP_SET_GOLD = 1,
+    JOURNAL_OP_SET_BEI = 2,
+    JOURNAL_OP_SET_ARTISANS_FLAME = 3,
+    JOURNAL_OP_SET_FOLLOWER_COUNT = 4,
+    JOURNAL_OP_MAX_OWN_INGREDIENTS = 5,
+    JOURNAL_OP_MAX_ALL_INGREDIENTS = 6,
+    JOURNAL_OP_MAX_OWN_MATERIALS = 7,
+    JOURNAL_OP_MAX_OWN_STAFF_LEVEL = 8,
+    JOURNAL_OP_SET_INGREDIENT_COUNT = 9,    // Value: see PackJournalItemCount.
+    JOURNAL_OP_SET_MATERIAL_COUNT = 10,     // Value: see PackJournalItemCount.
+    JOURNAL_OP_SET_INGREDIENT_PARENT = 11,  // Value: ingredientsID and parent TID, packed as by PackJournalItemCount.
+                                            // Precedes the count record of an ingredient the import adds.
+    JOURNAL_OP_SET_INGREDIENT_GAIN_TIME = 12, // Value: SaveTimestamp::SortKey() of the time set.
+};
+
+// Packs an item or ingredient ID and a count into the value of a JOURNAL_OP_SET_*_COUNT record.
+inline long long PackJournalItemCount(int32_t id, int32_t count) {
+    return static_cast<long long>((static_cast<uint64_t>(static_cast<uint32_t>(id)) << 32) | static_cast<uint32_t>(count));
+}
+
+inline void UnpackJournalItemCount(long long value, int32_t& out_id, int32_t& out_count) {
+    out_id = static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+    out_count = static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(value)));
+}
+
+// Returns true for the operations a count import records.
+inline bool IsJournalItemCountOp(JournalOp op) {
+    return op == JOURNAL_OP_SET_INGREDIENT_COUNT || op == JOURNAL_OP_SET_MATERIAL_COUNT || op == JOURNAL_OP_SET_INGREDIENT_PARENT;
+}
+
+// One recorded edit: the operation, its argument (0 for operations without one) and the reference
+// catalog version (see ReferenceDatabase::ApplyCatalogVersion) whose item data it was made with.
+struct JournalEntry {
+    JournalOp op;
+    long long value;
+    uint32_t catalogVersion = 0;
+};
+
+// Everything read back from a journal file.
+struct JournalContents {
+    std::string sourcePath;             // Save file the edits were made against.
+    uint64_t sourceSize = 0;            // Size of the save file when the session started.
+    int64_t sourceWriteTime = 0;        // Last write time of the save file when the session started.
+    std::vector<JournalEntry> entries;  // Edits in the order they were made.
+    bool truncated = false;             // True if a torn or corrupt record ended the journal early.
+};
+
+// Write-ahead journal of the edits made to a loaded save file.
+// Each edit is appended as a small fixed-size record before it is applied, so a crashed session can be
+// rebuilt by reloading the source save and replaying the records. The records are handed to the OS after
+// every append (surviving an editor crash). A background thread forces them to disk within
+// JOURNAL_SYNC_INTERVAL_MS of an append, batching the appends made meanwhile, which bounds what a system
+// crash can lose without the editing thread ever waiting on the disk.
+class EditJournal {
+public:
+    EditJournal();
+    ~EditJournal();
+
+    // Starts a new journal at journalPath for edits against sourcePath, replacing any existing journal.
+    // sourceSize and sourceWriteTime (see GetSourceFingerprint) identify the source file the edits were
+    // made on; pass those it had when it was read, not its current ones, so recovery can tell whether the
+    // file has changed since. Returns false (leaving the journal inactive) if the file cannot be created.
+    bool Begin(const std::string& journalPath, const std::string& sourcePath, uint64_t sourceSize, int64_t sourceWriteTime);
+
+    // Appends one edit record, made with the current catalog version. Does nothing if the journal is not active.
+    bool Append(JournalOp op, long long value);
+    // Appends a record read back from another journal, keeping its catalog version.
+    bool Append(const JournalEntry& entry);
+
+    // Sets the catalog version recorded with the edits appended from now on (0, the base, until set).
+    void SetCatalogVersion(uint32_t version) { m_catalogVersion = version; }
+
+    // Closes the journal and deletes its file. Called once the edits are safely written or abandoned.
+    void Discard();
+
+    bool IsActive() const { return m_file != NULL; }
+
+    // Deletes a journal file that is not open (e.g., a recovered or declined one).
+    static void Remove(const std::string& journalPath);
+
+    // Returns the journal location used by the editor: a fixed file under the system temporary directory.
+    static std::string DefaultJournalPath();
+
+    // Reads a journal file. Returns false if the file is missing or its header is invalid.
+    // Records after the first torn or corrupt one are ignored and reported via out.truncated.
+    static bool Read(const std::string& journalPath, JournalContents& out);
+
+    // Returns true if the journal's source save file still has the size and write time it had when the
+    // session started, i.e. replaying the journal onto it reproduces the crashed session exactly.
+    static bool SourceMatches(const JournalContents& contents);
+
+    // Reads the size and last write time used to recognize a source save file.
+    static bool GetSourceFingerprint(const std::string& sourcePath, uint64_t& size, int64_t& writeTime);
+
+private:
+    // Body of the sync thread: flushes m_handle once records are pending and the interval has passed.
+    void SyncLoop();
+    // Closes m_file, waiting for a flush of it in progress on the sync thread.
+    void CloseFile();
+
+    FILE* m_file;
+    std::string m_path;
+    uint32_t m_catalogVersion;          // Recorded with each appended edit.
+
+    std::thread m_syncThread;           // Started with the first journal, stopped on destruction.
+    std::mutex m_syncMutex;             // Guards the members below.
+    std::condition_variable m_syncWake; // Signals appends, finished flushes and stopping.
+    void* m_handle;                     // OS handle of m_file, or NULL when closed.
+    bool m_syncPending;                 // Records were appended since the last flush.
+    bool m_flushing;                    // The sync thread is flushing m_handle outside the lock.
+    bool m_stopSync;
+    std::chrono::steady_clock::time_point m_lastSync;
+};
@@ -0,0 +1,300 @@
+// HeadlessRunner.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "HeadlessRunner.h"
+#include <cstdio>               // For snprintf
+#include <string>               // For std::string
+#include <fstream>              // For std::ofstream
+#include <map>                  // For std::map
+#include <vector>               // For std::vector
+#include "sqlite3.h"            // For sqlite3
+#include "Logger.h"             // For LogMessage
+#include "ReferenceDatabase.h"  // For building the reference database
+#include "StartupProfiler.h"    // For phase timing
+#include "SaveGameManager.h"    // For loading saves
+#include "SaveSchema.h"         // For SaveSchemaInferrer
+#include "LoadStressCheck.h"    // For RunLoadStressCheck
+#include "SaveBenchmark.h"      // For RunSaveBenchmark
+#include "ItemCatalog.h"        // For generating and mapping item catalogs
+#include "LocalizationTable.h"  // For item display names
+#include "BatchRunner.h"        // For RunBatchCheck, RunSaveQuery and BatchSourceList
+#include "CsvReader.h"          // For ReadTextFile
+
+// File the inferred schema is written to, in the working directory.
+const char* const INFERRED_SCHEMA_FILENAME = "save_schema.json";
+
+// Times core initialization (logger, reference database) without creating any UI, and fails if the
+// total exceeds the configured budget. Used to keep startup regressions from creeping back in.
+static int RunStartupCheck(const CommandLineOptions& options) {
+    LogMessage(LOG_INFO_LEVEL, "Running headless startup check.");
+
+    bool ok = true;
+    sqlite3* db = NULL;
+    {
+        ScopedStartupPhase phase("Reference database");
+        std::string db_error;
+        db = ReferenceDatabase::Open(db_error);
+        if (!db) {
+            LogMessage(LOG_ERROR_LEVEL, ("Startup check: reference database failed to initialize: " + db_error).c_str());
+            ok = false;
+        }
+    }
+    ItemCatalog catalog;
+    if (!options.catalogFile.empty()) {
+        ScopedStartupPhase phase("Item catalog");
+        std::string catalog_error;
+        if (!catalog.Open(options.catalogFile, catalog_error)) {
+            LogMessage(LOG_ERROR_LEVEL, ("Startup check: " + catalog_error).c_str());
+            ok = false;
+        }
+    }
+    if (!options.languageFile.empty()) {
+        ScopedStartupPhase phase("Localization table");
+        LocalizationTable localization;
+        std::string localization_error;
+        if (!localization.Import(options.languageFile, &catalog, db, localization_error)) {
+            LogMessage(LOG_ERROR_LEVEL, ("Startup check: " + localization_error).c_str());
+            ok = false;
+        }
+    }
+    ReferenceDatabase::Close(db);
+    StartupProfiler::MarkInteractive();
+    StartupProfiler::Report();
+
+    double core_ms = StartupProfiler::TotalPhaseMilliseconds();
+    char summary[160];
+    snprintf(summary, sizeof(summary), "Startup check: core initialization took %.2f ms (budget %.2f ms).", core_ms, options.startupBudgetMs);
+    if (core_ms > options.startupBudgetMs) {
+        LogMessage(LOG_ERROR_LEVEL, summary);
+        LogMessage(LOG_ERROR_LEVEL, "Startup check FAILED: initialization exceeded its budget.");
+        return 1;
+    }
+    LogMessage(LOG_INFO_LEVEL, summary);
+    if (!ok) {
+        LogMessage(LOG_ERROR_LEVEL, "Startup check FAILED: initialization did not complete.");
+        return 1;
+    }
+    LogMessage(LOG_INFO_LEVEL, "Startup check passed.");
+    return 0;
+}
+
+// Infers a save schema from every .sav file under a directory (including backup subfolders and zip or
+// gzip archives of backups), or in one archive, and writes it to save_schema.json, ready to be reviewed
+// and passed back with -schema=<file>.
+static int RunSchemaInference(const CommandLineOptions& options) {
+    LogMessage(LOG_INFO_LEVEL, ("Inferring save schema from saves in: " + options.inferSchemaDir).c_str());
+    SaveSchemaInferrer inferrer;
+    size_t failed = 0;
+    std::map<std::string, size_t> codec_counts; // Saves per detected encoding; corpora may mix formats.
+    try {
+        BatchSourceList sources;
+        sources.Add(options.inferSchemaDir);
+        for (const std::string& error : sources.GetErrors()) {
+            LogMessage(LOG_ERROR_LEVEL, ("Schema inference: " + error).c_str());
+        }
+        failed += sources.GetErrors().size();
+        // No arena here: the inferrer keeps values from the samples it has seen.
+        SaveGameManager manager;
+        std::string bytes;
+        for (size_t i = 0; i < sources.GetSources().size(); ++i) {
+            if (sources.Load(i, manager, bytes)) {
+                inferrer.AddSample(manager.GetSaveData());
+                codec_counts[manager.GetSaveCodec().Describe()]++;
+            } else {
+                failed++;
+            }
+        }
+    } catch (const std::exception& e) {
+        LogMessage(LOG_ERROR_LEVEL, ("Schema inference failed: " + std::string(e.what())).c_str());
+        return 1;
+    }
+
+    if (inferrer.GetSampleCount() == 0) {
+        LogMessage(LOG_ERROR_LEVEL, "Schema inference found no loadable save files.");
+        return 1;
+    }
+    std::ofstream out(INFERRED_SCHEMA_FILENAME, std::ios::trunc);
+    if (!out) {
+        LogMessage(LOG_ERROR_LEVEL, (std::string("Could not open ") + INFERRED_SCHEMA_FILENAME + " for writing.").c_str());
+        return 1;
+    }
+    out << inferrer.BuildSchemaDocument().dump(4) << std::endl;
+    for (const auto& codec_count : codec_counts) {
+        LogMessage(LOG_INFO_LEVEL, ("Save encoding " + codec_count.first + ": " + std::to_string(codec_count.second) + " file(s).").c_str());
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Inferred schema from " + std::to_string(inferrer.GetSampleCount()) + " save(s) (" + std::to_string(failed) + " failed to load) and wrote " + INFERRED_SCHEMA_FILENAME + ".").c_str());
+    return 0;
+}
+
+// Generates an item catalog from the reference database, then maps it back and checks it against the
+// database so a broken generator is caught before the file is deployed.
+static int RunCatalogExport(const CommandLineOptions& options) {
+    std::string error;
+    sqlite3* db = ReferenceDatabase::Open(error);
+    if (!db) {
+        LogMessage(LOG_ERROR_LEVEL, ("Catalog export: reference database failed to initialize: " + error).c_str());
+        return 1;
+    }
+    bool ok = ItemCatalog::Generate(db, options.exportCatalogFile, error);
+    if (!ok) {
+        LogMessage(LOG_ERROR_LEVEL, ("Catalog export failed: " + error).c_str());
+    }
+
+    ItemCatalog catalog;
+    if (ok && !catalog.Open(options.exportCatalogFile, error)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Catalog export: the written catalog does not open: " + error).c_str());
+        ok = false;
+    }
+    // Every item must be found through the TID index with the MaxCount the database holds.
+    sqlite3_stmt* stmt = NULL;
+    if (ok && sqlite3_prepare_v2(db, "SELECT TID, MaxCount FROM Items;", -1, &stmt, NULL) == SQLITE_OK) {
+        size_t checked = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            ItemCatalogRows rows = catalog.Find(CATALOG_INDEX_ITEM_BY_TID, sqlite3_column_int(stmt, 0));
+            if (rows.count != 1 || catalog.GetInt(CATALOG_ITEM_MAX_COUNT, rows.rows[0]) != sqlite3_column_int(stmt, 1)) {
+                LogMessage(LOG_ERROR_LEVEL, ("Catalog export: item " + std::to_string(sqlite3_column_int(stmt, 0)) + " does not match the database.").c_str());
+                ok = false;
+                break;
+            }
+            checked++;
+        }
+        if (ok && checked != catalog.GetItemCount()) {
+            LogMessage(LOG_ERROR_LEVEL, "Catalog export: the catalog's item count does not match the database.");
+            ok = false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    ReferenceDatabase::Close(db);
+    return ok ? 0 : 1;
+}
+
+// Largest SQL dump accepted by -catalog-version-sql; the base catalog's is about 140 KB.
+const size_t MAX_CATALOG_DUMP_BYTES = 64 * 1024 * 1024;
+
+// Generates a reference catalog version from another game build's SQL dump. The generator checks the
+// entry by applying it to a fresh base before writing it.
+static int RunCatalogVersionExport(const CommandLineOptions& options) {
+    if (options.catalogVersionSqlFile.empty()) {
+        LogMessage(LOG_ERROR_LEVEL, "Catalog version export: pass the build's SQL dump with -catalog-version-sql=<file>.");
+        return 1;
+    }
+    std::string dump;
+    std::string error;
+    if (!ReadTextFile(options.catalogVersionSqlFile, MAX_CATALOG_DUMP_BYTES, dump, error) ||
+        !ReferenceDatabase::GenerateCatalogVersion(dump, options.exportCatalogVersionFile, error)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Catalog version export failed: " + error).c_str());
+        return 1;
+    }
+    return 0;
+}
+
+// Lists the items whose display name (in the -lang language) or ItemTextID contains the -find-item text.
+static int RunItemSearch(const CommandLineOptions& options) {
+    if (options.languageFile.empty()) {
+        LogMessage(LOG_ERROR_LEVEL, "Item search: -find-item needs a localization table (-lang-file=<file>).");
+        return 1;
+    }
+    std::string error;
+    ItemCatalog catalog;
+    if (!options.catalogFile.empty() && !catalog.Open(options.catalogFile, error)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Item search: " + error).c_str());
+        return 1;
+    }
+    sqlite3* db = catalog.IsOpen() ? NULL : ReferenceDatabase::Open(error);
+    if (!catalog.IsOpen() && !db) {
+        LogMessage(LOG_ERROR_LEVEL, ("Item search: reference database failed to initialize: " + error).c_str());
+        return 1;
+    }
+    LocalizationTable localization;
+    bool ok = localization.Import(options.languageFile, &catalog, db, error);
+    ReferenceDatabase::Close(db);
+    if (!ok) {
+        LogMessage(LOG_ERROR_LEVEL, ("Item search: " + error).c_str());
+        return 1;
+    }
+    if (!options.language.empty() && !localization.SetLanguage(options.language)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Item search: the localization table has no language '" + options.language + "'.").c_str());
+        return 1;
+    }
+
+    std::vector<int32_t> tids;
+    localization.FindItems(options.findItemText, tids);
+    for (int32_t tid : tids) {
+        LogMessage(LOG_INFO_LEVEL, (std::to_string(tid) + "  " + localization.GetItemTextId(tid) + "  " + localization.GetItemName(tid)).c_str());
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Item search: " + std::to_string(tids.size()) + " item(s) match '" + options.findItemText + "' in " + localization.GetLanguage() + ".").c_str());
+    return 0;
+}
+
+// Runs the benchmarks, with the item catalog from -catalog if one was given.
+static int RunBenchmark(const CommandLineOptions& options) {
+    ItemCatalog catalog;
+    if (!options.catalogFile.empty()) {
+        std::string error;
+        if (!catalog.Open(options.catalogFile, error)) {
+            LogMessage(LOG_ERROR_LEVEL, ("Benchmark: " + error).c_str());
+            return 1;
+        }
+    }
+    return RunSaveBenchmark(options.benchmarkFile, options.benchmarkIterations, options.perfCounters, catalog.IsOpen() ? &catalog : NULL);
+}
+
+int RunHeadless(const CommandLineOptions& options) {
+    if (options.startupCheck) {
+        return RunStartupCheck(options);
+    }
+    if (!options.inferSchemaDir.empty()) {
+        return RunSchemaInference(options);
+    }
+    if (options.stressLoad) {
+        return RunLoadStressCheck();
+    }
+    if (!options.benchmarkFile.empty()) {
+        return RunBenchmark(options);
+    }
+    if (!options.exportCatalogFile.empty()) {
+        return RunCatalogExport(options);
+    }
+    if (!options.exportCatalogVersionFile.empty()) {
+        return RunCatalogVersionExport(options);
+    }
+    if (!options.findItemText.empty()) {
+        return RunItemSearch(options);
+    }
+    if (!options.batchCheckPath.empty()) {
+        return RunBatchCheck(options);
+    }
+    if (!options.query.empty()) {
+        return RunSaveQuery(options);
+    }
+    LogMessage(LOG_ERROR_LEVEL, "No headless mode requested.");
+    return 1;
+}
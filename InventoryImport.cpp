@@ -0,0 +1,245 @@
+// InventoryImport.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "InventoryImport.h"
+#include <cerrno>           // For errno (count range checks)
+#include <cstdlib>          // For strtol
+#include <unordered_map>    // For the join's hash tables
+#include "CsvReader.h"      // For CsvReader
+
+// Marks a name shared by more than one item in the name table.
+const uint32_t AMBIGUOUS_ITEM = UINT32_MAX;
+
+// A reference item, as the join needs it.
+struct ImportItem {
+    int32_t tid;
+    int32_t dataId;
+    int32_t maxCount;
+    bool isIngredient;      // ItemDataID is an Ingredients TID, so the count goes to the Ingredients section.
+};
+
+static void LowercaseAscii(std::string& text) {
+    for (char& c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+}
+
+static void TrimSpaces(std::string& text) {
+    size_t end = text.find_last_not_of(" \t");
+    if (end == std::string::npos) {
+        text.clear();
+        return;
+    }
+    text.erase(end + 1);
+    text.erase(0, text.find_first_not_of(" \t"));
+}
+
+// Parses a whole field as a decimal int32.
+static bool ParseInt32(const std::string& text, int32_t& out_value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = NULL;
+    errno = 0;
+    long value = strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || value < INT32_MIN || value > INT32_MAX) {
+        return false;
+    }
+    out_value = static_cast<int32_t>(value);
+    return true;
+}
+
+static void AddName(std::unordered_map<std::string, uint32_t>& by_name, std::string name, uint32_t index) {
+    LowercaseAscii(name);
+    auto inserted = by_name.emplace(name, index);
+    if (!inserted.second && inserted.first->second != index) {
+        inserted.first->second = AMBIGUOUS_ITEM;
+    }
+}
+
+// Reads the reference items and their names; text IDs always, display names when a table is loaded.
+static bool ReadImportItems(const ItemCatalog* catalog, sqlite3* db, const LocalizationTable* names,
+                            std::vector<ImportItem>& out_items, std::unordered_map<std::string, uint32_t>& out_by_name, std::string& out_error) {
+    if (catalog && catalog->IsOpen()) {
+        out_items.reserve(catalog->GetItemCount());
+        for (uint32_t row = 0; row < catalog->GetItemCount(); ++row) {
+            ImportItem item;
+            item.tid = catalog->GetInt(CATALOG_ITEM_TID, row);
+            item.dataId = catalog->GetInt(CATALOG_ITEM_DATA_ID, row);
+            item.maxCount = catalog->GetInt(CATALOG_ITEM_MAX_COUNT, row);
+            item.isIngredient = catalog->Find(CATALOG_INDEX_INGREDIENT_BY_TID, item.dataId).count > 0;
+            AddName(out_by_name, catalog->GetString(CATALOG_ITEM_TEXT_ID, row), static_cast<uint32_t>(out_items.size()));
+            out_items.push_back(item);
+        }
+    } else if (db) {
+        sqlite3_stmt* stmt = NULL;
+        const char* sql =
+            "SELECT T.TID, T.ItemDataID, T.MaxCount, T.ItemTextID, "
+            "EXISTS (SELECT 1 FROM Ingredients AS I WHERE I.TID = T.ItemDataID) "
+            "FROM Items AS T ORDER BY T.TID;";
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+            out_error = "SQL prepare failed for the count import: " + std::string(sqlite3_errmsg(db));
+            return false;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            ImportItem item;
+            item.tid = sqlite3_column_int(stmt, 0);
+            item.dataId = sqlite3_column_int(stmt, 1);
+            item.maxCount = sqlite3_column_int(stmt, 2);
+            item.isIngredient = sqlite3_column_int(stmt, 4) != 0;
+            const unsigned char* text_id = sqlite3_column_text(stmt, 3);
+            AddName(out_by_name, text_id ? reinterpret_cast<const char*>(text_id) : "", static_cast<uint32_t>(out_items.size()));
+            out_items.push_back(item);
+        }
+        sqlite3_finalize(stmt);
+    } else {
+        out_error = "No item catalog or reference database to import counts against.";
+        return false;
+    }
+
+    if (names && names->IsLoaded()) {
+        for (uint32_t index = 0; index < out_items.size(); ++index) {
+            const char* name = names->GetItemName(out_items[index].tid);
+            const char* text_id = names->GetItemTextId(out_items[index].tid);
+            if (name && text_id && name != text_id) { // Same pointer: no display name, only the text ID.
+                AddName(out_by_name, name, index);
+            }
+        }
+    }
+    return true;
+}
+
+bool JoinItemCounts(const std::string& csvText, const ItemCatalog* catalog, sqlite3* db, const LocalizationTable* names,
+                    std::vector<ItemCountChange>& out_changes, ItemCountImportReport& out_report, std::string& out_error) {
+    out_changes.clear();
+    out_report = ItemCountImportReport();
+
+    // 1. Build side: the reference items, hashed by TID and by name.
+    std::vector<ImportItem> items;
+    std::unordered_map<std::string, uint32_t> by_name;
+    if (!ReadImportItems(catalog, db, names, items, by_name, out_error)) {
+        return false;
+    }
+    std::unordered_map<int32_t, uint32_t> by_tid;
+    by_tid.reserve(items.size());
+    for (uint32_t index = 0; index < items.size(); ++index) {
+        by_tid.emplace(items[index].tid, index);
+    }
+
+    // 2. Probe side: stream the rows, keeping the last valid count per item.
+    std::vector<int32_t> desired(items.size(), -1);
+    CsvReader reader(csvText);
+    std::vector<std::string> fields;
+    std::string key;
+    bool first_row = true;
+    auto reject = [&](const std::string& problem) {
+        out_report.rejected++;
+        if (out_report.problems.size() < MAX_REPORTED_IMPORT_PROBLEMS) {
+            out_report.problems.push_back("Line " + std::to_string(reader.GetRecordLine()) + ": " + problem);
+        }
+    };
+    while (reader.ReadRecord(fields)) {
+        int32_t count = 0;
+        if (fields.size() >= 2) {
+            TrimSpaces(fields[1]);
+        }
+        bool count_ok = fields.size() >= 2 && ParseInt32(fields[1], count);
+        if (first_row) {
+            first_row = false;
+            if (!count_ok && fields.size() >= 2) {
+                continue; // Header row.
+            }
+        }
+        out_report.rows++;
+        if (fields.size() < 2) {
+            reject("expected \"<item>,<count>\".");
+            continue;
+        }
+        key = fields[0];
+        TrimSpaces(key);
+        if (!count_ok) {
+            reject("count '" + fields[1] + "' for '" + key + "' is not a whole number.");
+            continue;
+        }
+
+        uint32_t index = AMBIGUOUS_ITEM;
+        int32_t tid = 0;
+        if (ParseInt32(key, tid)) {
+            auto found = by_tid.find(tid);
+            if (found == by_tid.end()) {
+                reject("no item has TID " + key + ".");
+                continue;
+            }
+            index = found->second;
+        } else {
+            LowercaseAscii(key);
+            auto found = by_name.find(key);
+            if (found == by_name.end()) {
+                reject("no item is named '" + fields[0] + "'.");
+                continue;
+            }
+            if (found->second == AMBIGUOUS_ITEM) {
+                reject("several items are named '" + fields[0] + "'; use the TID.");
+                continue;
+            }
+            index = found->second;
+        }
+
+        const ImportItem& item = items[index];
+        if (item.maxCount <= 1) {
+            reject("item " + std::to_string(item.tid) + " has MaxCount " + std::to_string(item.maxCount) + " and is left alone to protect quest progression.");
+            continue;
+        }
+        if (count < 0 || count > item.maxCount) {
+            reject("count " + std::to_string(count) + " for item " + std::to_string(item.tid) + " is outside 0.." + std::to_string(item.maxCount) + ".");
+            continue;
+        }
+        desired[index] = count;
+        out_report.accepted++;
+    }
+
+    // 3. One change per item, in TID order.
+    for (uint32_t index = 0; index < items.size(); ++index) {
+        if (desired[index] < 0) {
+            continue;
+        }
+        const ImportItem& item = items[index];
+        ItemCountChange change;
+        change.target = item.isIngredient ? ITEM_COUNT_INGREDIENT : ITEM_COUNT_MATERIAL;
+        change.id = item.isIngredient ? item.dataId : item.tid;
+        change.parentId = item.tid;
+        change.count = desired[index];
+        out_changes.push_back(change);
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+// InventoryImport.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "sqlite3.h"            // For reading the reference items from the database
+#include "ItemCatalog.h"        // For reading the reference items from an item catalog
+#include "LocalizationTable.h"  // For matching items by display name
+
+// Largest count import file accepted.
+const size_t MAX_COUNT_IMPORT_FILE_BYTES = 256 * 1024 * 1024;
+// Rejected rows described individually in an import report; the rest are only counted.
+const size_t MAX_REPORTED_IMPORT_PROBLEMS = 20;
+
+// Save section an imported count is written to.
+enum ItemCountTarget {
+    ITEM_COUNT_INGREDIENT,  // Ingredients["<ingredientsID>"].count
+    ITEM_COUNT_MATERIAL,    // The InventoryItemSlot entry whose itemID is the item's TID, .totalCount
+};
+
+// One validated count to write to the save.
+struct ItemCountChange {
+    ItemCountTarget target;
+    int32_t id;         // ingredientsID (the item's ItemDataID) for ingredients; the item TID for materials.
+    int32_t parentId;   // The item TID; recorded in Ingredients entries the import adds.
+    int32_t count;
+};
+
+// What happened to the rows of an import.
+struct ItemCountImportReport {
+    size_t rows = 0;                    // Data rows read (excluding a header row).
+    size_t accepted = 0;                // Rows that passed validation; a later row for the same item replaces an earlier one.
+    size_t rejected = 0;                // Rows that did not parse, matched no item, or failed validation.
+    std::vector<std::string> problems;  // The first MAX_REPORTED_IMPORT_PROBLEMS rejections, with line numbers.
+};
+
+// Joins a CSV of desired item counts against the reference items.
+// Each row is "<item>,<count>". <item> is an item TID, an ItemTextID, or a display name in the active
+// language of names (matched case-insensitively). A first row whose count is not a number is a header.
+// The reference items are read once, from catalog if it is open or else from db with one query, into
+// hash tables keyed by TID and by name; each row then costs one hash lookup and no SQL.
+// Rows are rejected if the count is negative or above the item's MaxCount, if the item has MaxCount 1
+// (left alone to protect quest progression, as in the Max operations), or if the name is shared by
+// several items. out_changes receives one change per item, in TID order.
+// Returns false only if the reference items cannot be read; row problems go to out_report.
+bool JoinItemCounts(const std::string& csvText, const ItemCatalog* catalog, sqlite3* db, const LocalizationTable* names,
+                    std::vector<ItemCountChange>& out_changes, ItemCountImportReport& out_report, std::string& out_error);
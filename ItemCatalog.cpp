@@ -0,0 +1,523 @@
+// ItemCatalog.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#define NOMINMAX // Prevent Windows.h from defining min/max macros
+
+#include "ItemCatalog.h"
+#include <windows.h>            // For CreateFileA, CreateFileMappingA, MapViewOfFile
+#include <algorithm>            // For std::stable_sort
+#include <cstdio>               // For fopen, fwrite
+#include <cstring>              // For memcmp, memcpy
+#include <numeric>              // For std::iota
+#include <unordered_map>        // For pooling strings
+#include <vector>               // For std::vector
+#include "Logger.h"             // For LogMessage
+#include "ReferenceDatabase.h"  // For the embedded source checksum
+
+// --- Catalog file layout ---
+// ItemCatalogHeader at offset 0, then every section at a 64-byte aligned offset recorded in the header.
+// All values are little-endian as written by the generator; byteOrderMark rejects files from a machine
+// of the other byte order.
+static const char CATALOG_MAGIC[4] = { 'D', 'S', 'E', 'C' };
+static const uint32_t CATALOG_BYTE_ORDER_MARK = 0x01020304;
+static const uint64_t CATALOG_ALIGNMENT = 64;
+
+struct ItemCatalogSectionEntry {
+    uint64_t offset;    // From the start of the file.
+    uint64_t size;      // In bytes.
+};
+
+struct ItemCatalogHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t headerSize;
+    uint64_t fileSize;
+    uint32_t sourceChecksum;    // ReferenceDatabase::EmbeddedSourceChecksum() of the data it was generated from.
+    uint32_t sourceSize;        // ReferenceDatabase::EmbeddedSourceSize() of the data it was generated from.
+    uint32_t itemCount;
+    uint32_t ingredientCount;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    ItemCatalogSectionEntry sections[CATALOG_SECTION_COUNT];
+};
+
+// One hash index slot. Empty slots have a count of 0.
+struct ItemCatalogIndexSlot {
+    int32_t key;
+    uint32_t first;     // Index of the first matching row in the index's row list.
+    uint32_t count;     // Number of matching rows.
+};
+static_assert(sizeof(ItemCatalogIndexSlot) == 12, "Index slots must be packed without padding.");
+
+enum CatalogSectionKind {
+    SECTION_ITEM_INT,
+    SECTION_ITEM_DOUBLE,
+    SECTION_ITEM_STRING,
+    SECTION_INGREDIENT_INT,
+    SECTION_STRING_POOL,
+    SECTION_INDEX_SLOTS,
+    SECTION_INDEX_ROWS
+};
+
+struct CatalogSectionInfo {
+    CatalogSectionKind kind;
+    const char* sqlColumn;  // Column the section is generated from, for column sections.
+};
+
+// Indexed by ItemCatalogSection.
+static const CatalogSectionInfo SECTION_INFO[] = {
+    { SECTION_ITEM_INT,         "TID" },
+    { SECTION_ITEM_INT,         "ItemType" },
+    { SECTION_ITEM_INT,         "ItemLevel" },
+    { SECTION_ITEM_INT,         "ItemGrade" },
+    { SECTION_ITEM_INT,         "ItemRank" },
+    { SECTION_ITEM_INT,         "ItemMaxStackCount" },
+    { SECTION_ITEM_INT,         "IsDisposable" },
+    { SECTION_ITEM_INT,         "ItemBuyPrice" },
+    { SECTION_ITEM_INT,         "ItemSellPrice" },
+    { SECTION_ITEM_INT,         "IsNotSale" },
+    { SECTION_ITEM_INT,         "ItemDataID" },
+    { SECTION_ITEM_INT,         "MaxCount" },
+    { SECTION_ITEM_INT,         "SourcePathID" },
+    { SECTION_ITEM_INT,         "DLCType" },
+    { SECTION_ITEM_DOUBLE,      "ItemWeight" },
+    { SECTION_ITEM_STRING,      "ItemTextID" },
+    { SECTION_ITEM_STRING,      "ItemDescID" },
+    { SECTION_ITEM_STRING,      "ItemIcon" },
+    { SECTION_ITEM_STRING,      "ItemUIIcon" },
+    { SECTION_ITEM_STRING,      "SpawnObject" },
+    { SECTION_ITEM_STRING,      "DataExchangeFormula" },
+    { SECTION_ITEM_STRING,      "ItemDetailImage" },
+    { SECTION_INGREDIENT_INT,   "TID" },
+    { SECTION_INGREDIENT_INT,   "Type" },
+    { SECTION_STRING_POOL,      NULL },
+    { SECTION_INDEX_SLOTS,      NULL },
+    { SECTION_INDEX_ROWS,       NULL },
+    { SECTION_INDEX_SLOTS,      NULL },
+    { SECTION_INDEX_ROWS,       NULL },
+    { SECTION_INDEX_SLOTS,      NULL },
+    { SECTION_INDEX_ROWS,       NULL },
+};
+static_assert(sizeof(SECTION_INFO) / sizeof(SECTION_INFO[0]) == CATALOG_SECTION_COUNT, "SECTION_INFO must describe every section.");
+
+struct CatalogIndexInfo {
+    ItemCatalogSection keyColumn;
+    ItemCatalogSection slots;
+    ItemCatalogSection rows;
+};
+
+// Indexed by ItemCatalogIndex.
+static const CatalogIndexInfo INDEX_INFO[CATALOG_INDEX_COUNT] = {
+    { CATALOG_ITEM_TID,         CATALOG_INDEX_ITEM_BY_TID_SLOTS,        CATALOG_INDEX_ITEM_BY_TID_ROWS },
+    { CATALOG_ITEM_DATA_ID,     CATALOG_INDEX_ITEM_BY_DATA_ID_SLOTS,    CATALOG_INDEX_ITEM_BY_DATA_ID_ROWS },
+    { CATALOG_INGREDIENT_TID,   CATALOG_INDEX_INGREDIENT_BY_TID_SLOTS,  CATALOG_INDEX_INGREDIENT_BY_TID_ROWS },
+};
+
+// Home slot of a key in a table of (mask + 1) slots; collisions probe linearly.
+static uint32_t HashSlot(int32_t key, uint32_t mask) {
+    uint32_t h = static_cast<uint32_t>(key) * 2654435761u;
+    h ^= h >> 16;
+    return h & mask;
+}
+
+static uint64_t AlignUp(uint64_t value) {
+    return (value + CATALOG_ALIGNMENT - 1) & ~(CATALOG_ALIGNMENT - 1);
+}
+
+// --- Reading ---
+
+ItemCatalog::ItemCatalog() : m_file(NULL), m_mapping(NULL), m_base(NULL), m_header(NULL) {}
+
+ItemCatalog::~ItemCatalog() {
+    Close();
+}
+
+void ItemCatalog::Close() {
+    if (m_base) {
+        UnmapViewOfFile(m_base);
+        m_base = NULL;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+        m_file = NULL;
+    }
+    m_header = NULL;
+}
+
+// Checks that a section lies within the file, is aligned, and has the size its kind requires.
+static bool ValidateSection(const ItemCatalogHeader& header, ItemCatalogSection section, const unsigned char* base) {
+    const ItemCatalogSectionEntry& entry = header.sections[section];
+    if (entry.offset % CATALOG_ALIGNMENT != 0 || entry.offset < header.headerSize ||
+        entry.offset > header.fileSize || entry.size > header.fileSize - entry.offset) {
+        return false;
+    }
+    switch (SECTION_INFO[section].kind) {
+        case SECTION_ITEM_INT:
+        case SECTION_ITEM_STRING:
+            return entry.size == static_cast<uint64_t>(header.itemCount) * sizeof(uint32_t);
+        case SECTION_ITEM_DOUBLE:
+            return entry.size == static_cast<uint64_t>(header.itemCount) * sizeof(double);
+        case SECTION_INGREDIENT_INT:
+            return entry.size == static_cast<uint64_t>(header.ingredientCount) * sizeof(int32_t);
+        case SECTION_STRING_POOL:
+            // Every string offset below the pool size then ends at a NUL inside the pool.
+            return entry.size > 0 && base[entry.offset + entry.size - 1] == '\0';
+        case SECTION_INDEX_SLOTS: {
+            if (entry.size == 0 || entry.size % sizeof(ItemCatalogIndexSlot) != 0) {
+                return false;
+            }
+            uint64_t slot_count = entry.size / sizeof(ItemCatalogIndexSlot);
+            return slot_count <= 0xFFFFFFFFu && (slot_count & (slot_count - 1)) == 0;
+        }
+        case SECTION_INDEX_ROWS:
+            return entry.size % sizeof(uint32_t) == 0;
+    }
+    return false;
+}
+
+bool ItemCatalog::Open(const std::string& filepath, std::string& out_error) {
+    Close();
+    out_error.clear();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        out_error = "Could not open item catalog: " + filepath;
+        return false;
+    }
+    m_file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || static_cast<uint64_t>(size.QuadPart) < sizeof(ItemCatalogHeader)) {
+        out_error = "Item catalog is too small to be valid: " + filepath;
+        Close();
+        return false;
+    }
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_mapping) {
+        out_error = "Could not map item catalog: " + filepath;
+        Close();
+        return false;
+    }
+    m_base = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_base) {
+        out_error = "Could not map a view of item catalog: " + filepath;
+        Close();
+        return false;
+    }
+
+    const ItemCatalogHeader* header = reinterpret_cast<const ItemCatalogHeader*>(m_base);
+    if (memcmp(header->magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) != 0 || header->byteOrderMark != CATALOG_BYTE_ORDER_MARK) {
+        out_error = "Not an item catalog file: " + filepath;
+        Close();
+        return false;
+    }
+    if (header->version != ITEM_CATALOG_VERSION || header->headerSize != sizeof(ItemCatalogHeader) ||
+        header->sectionCount != CATALOG_SECTION_COUNT) {
+        out_error = "Item catalog has unsupported version " + std::to_string(header->version) + " (expected " +
+                    std::to_string(ITEM_CATALOG_VERSION) + "); regenerate it with -export-catalog: " + filepath;
+        Close();
+        return false;
+    }
+    if (header->fileSize != static_cast<uint64_t>(size.QuadPart)) {
+        out_error = "Item catalog is truncated or damaged: " + filepath;
+        Close();
+        return false;
+    }
+    if (header->sourceChecksum != ReferenceDatabase::EmbeddedSourceChecksum() ||
+        header->sourceSize != ReferenceDatabase::EmbeddedSourceSize()) {
+        out_error = "Item catalog was generated from different reference data; regenerate it with -export-catalog: " + filepath;
+        Close();
+        return false;
+    }
+    for (int section = 0; section < CATALOG_SECTION_COUNT; ++section) {
+        if (!ValidateSection(*header, static_cast<ItemCatalogSection>(section), m_base)) {
+            out_error = "Item catalog section " + std::to_string(section) + " is damaged: " + filepath;
+            Close();
+            return false;
+        }
+    }
+    m_header = header;
+    return true;
+}
+
+uint64_t ItemCatalog::SectionOffset(ItemCatalogSection section) const {
+    return m_header->sections[section].offset;
+}
+
+uint32_t ItemCatalog::GetItemCount() const {
+    return m_header ? m_header->itemCount : 0;
+}
+
+uint32_t ItemCatalog::GetIngredientCount() const {
+    return m_header ? m_header->ingredientCount : 0;
+}
+
+int32_t ItemCatalog::GetInt(ItemCatalogSection column, uint32_t row) const {
+    if (!m_header) {
+        return 0;
+    }
+    CatalogSectionKind kind = SECTION_INFO[column].kind;
+    if ((kind == SECTION_ITEM_INT && row < m_header->itemCount) ||
+        (kind == SECTION_INGREDIENT_INT && row < m_header->ingredientCount)) {
+        return static_cast<const int32_t*>(SectionData(column))[row];
+    }
+    return 0;
+}
+
+const int32_t* ItemCatalog::GetIntColumn(ItemCatalogSection column) const {
+    if (!m_header) {
+        return NULL;
+    }
+    CatalogSectionKind kind = SECTION_INFO[column].kind;
+    if (kind == SECTION_ITEM_INT || kind == SECTION_INGREDIENT_INT) {
+        return static_cast<const int32_t*>(SectionData(column));
+    }
+    return NULL;
+}
+
+double ItemCatalog::GetItemWeight(uint32_t row) const {
+    if (!m_header || row >= m_header->itemCount) {
+        return 0.0;
+    }
+    return static_cast<const double*>(SectionData(CATALOG_ITEM_WEIGHT))[row];
+}
+
+const char* ItemCatalog::GetString(ItemCatalogSection column, uint32_t row) const {
+    if (!m_header || SECTION_INFO[column].kind != SECTION_ITEM_STRING || row >= m_header->itemCount) {
+        return "";
+    }
+    uint32_t offset = static_cast<const uint32_t*>(SectionData(column))[row];
+    if (offset >= m_header->sections[CATALOG_STRING_POOL].size) {
+        return "";
+    }
+    return static_cast<const char*>(SectionData(CATALOG_STRING_POOL)) + offset;
+}
+
+ItemCatalogRows ItemCatalog::Find(ItemCatalogIndex index, int32_t key) const {
+    ItemCatalogRows result = { NULL, 0 };
+    if (!m_header) {
+        return result;
+    }
+    const CatalogIndexInfo& info = INDEX_INFO[index];
+    const ItemCatalogIndexSlot* slots = static_cast<const ItemCatalogIndexSlot*>(SectionData(info.slots));
+    const uint32_t slot_count = static_cast<uint32_t>(m_header->sections[info.slots].size / sizeof(ItemCatalogIndexSlot));
+    const uint64_t row_count = m_header->sections[info.rows].size / sizeof(uint32_t);
+    const uint32_t mask = slot_count - 1;
+    uint32_t slot = HashSlot(key, mask);
+    for (uint32_t probe = 0; probe < slot_count; ++probe) {
+        const ItemCatalogIndexSlot& candidate = slots[slot];
+        if (candidate.count == 0) {
+            break;
+        }
+        if (candidate.key == key) {
+            if (static_cast<uint64_t>(candidate.first) + candidate.count <= row_count) {
+                result.rows = static_cast<const uint32_t*>(SectionData(info.rows)) + candidate.first;
+                result.count = candidate.count;
+            }
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return result;
+}
+
+// --- Generation ---
+
+template <typename T>
+static void AppendValue(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Builds a hash index over keys (one per row, rows in TID order) into slot and row-list sections.
+static void BuildIndex(const std::vector<int32_t>& keys, std::vector<unsigned char>& slots_out, std::vector<unsigned char>& rows_out) {
+    std::vector<uint32_t> rows(keys.size());
+    std::iota(rows.begin(), rows.end(), 0u);
+    // Stable, so rows sharing a key stay in TID order.
+    std::stable_sort(rows.begin(), rows.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    size_t distinct = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (i == 0 || keys[rows[i]] != keys[rows[i - 1]]) {
+            distinct++;
+        }
+    }
+    uint32_t slot_count = 1;
+    while (slot_count < distinct * 2) { // Load factor of at most one half keeps probe sequences short.
+        slot_count <<= 1;
+    }
+    std::vector<ItemCatalogIndexSlot> slots(slot_count, ItemCatalogIndexSlot{ 0, 0, 0 });
+    const uint32_t mask = slot_count - 1;
+    for (size_t i = 0; i < rows.size();) {
+        size_t run_end = i + 1;
+        while (run_end < rows.size() && keys[rows[run_end]] == keys[rows[i]]) {
+            run_end++;
+        }
+        int32_t key = keys[rows[i]];
+        uint32_t slot = HashSlot(key, mask);
+        while (slots[slot].count != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = ItemCatalogIndexSlot{ key, static_cast<uint32_t>(i), static_cast<uint32_t>(run_end - i) };
+        i = run_end;
+    }
+
+    slots_out.resize(slots.size() * sizeof(ItemCatalogIndexSlot));
+    memcpy(slots_out.data(), slots.data(), slots_out.size());
+    rows_out.resize(rows.size() * sizeof(uint32_t));
+    if (!rows.empty()) {
+        memcpy(rows_out.data(), rows.data(), rows_out.size());
+    }
+}
+
+bool ItemCatalog::Generate(sqlite3* db, const std::string& filepath, std::string& out_error) {
+    out_error.clear();
+    if (!db) {
+        out_error = "The reference database is not open.";
+        return false;
+    }
+
+    std::vector<std::vector<unsigned char>> sections(CATALOG_SECTION_COUNT);
+    std::vector<int32_t> item_tids, item_data_ids, ingredient_tids;
+    std::string string_pool(1, '\0'); // Offset 0 is the empty string.
+    std::unordered_map<std::string, uint32_t> string_offsets = { { "", 0 } };
+
+    // Items: one query selecting every item column in section order.
+    std::string item_query = "SELECT ";
+    std::vector<ItemCatalogSection> item_columns;
+    for (int section = 0; section < CATALOG_SECTION_COUNT; ++section) {
+        CatalogSectionKind kind = SECTION_INFO[section].kind;
+        if (kind == SECTION_ITEM_INT || kind == SECTION_ITEM_DOUBLE || kind == SECTION_ITEM_STRING) {
+            item_query += (item_columns.empty() ? "\"" : ", \"") + std::string(SECTION_INFO[section].sqlColumn) + "\"";
+            item_columns.push_back(static_cast<ItemCatalogSection>(section));
+        }
+    }
+    item_query += " FROM Items ORDER BY TID;";
+
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(db, item_query.c_str(), -1, &stmt, NULL) != SQLITE_OK) {
+        out_error = "SQL prepare failed for the item catalog: " + std::string(sqlite3_errmsg(db));
+        return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        for (size_t column = 0; column < item_columns.size(); ++column) {
+            ItemCatalogSection section = item_columns[column];
+            switch (SECTION_INFO[section].kind) {
+                case SECTION_ITEM_INT: {
+                    int32_t value = sqlite3_column_int(stmt, static_cast<int>(column));
+                    AppendValue(sections[section], value);
+                    if (section == CATALOG_ITEM_TID) item_tids.push_back(value);
+                    if (section == CATALOG_ITEM_DATA_ID) item_data_ids.push_back(value);
+                    break;
+                }
+                case SECTION_ITEM_DOUBLE:
+                    AppendValue(sections[section], sqlite3_column_double(stmt, static_cast<int>(column)));
+                    break;
+                default: {
+                    const unsigned char* text = sqlite3_column_text(stmt, static_cast<int>(column));
+                    std::string value = text ? reinterpret_cast<const char*>(text) : "";
+                    auto inserted = string_offsets.emplace(value, static_cast<uint32_t>(string_pool.size()));
+                    if (inserted.second) {
+                        string_pool.append(value.c_str(), value.size() + 1);
+                    }
+                    AppendValue(sections[section], inserted.first->second);
+                    break;
+                }
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    // Ingredients
+    if (sqlite3_prepare_v2(db, "SELECT TID, Type FROM Ingredients ORDER BY TID;", -1, &stmt, NULL) != SQLITE_OK) {
+        out_error = "SQL prepare failed for the item catalog: " + std::string(sqlite3_errmsg(db));
+        return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int32_t tid = sqlite3_column_int(stmt, 0);
+        AppendValue(sections[CATALOG_INGREDIENT_TID], tid);
+        AppendValue(sections[CATALOG_INGREDIENT_TYPE], static_cast<int32_t>(sqlite3_column_int(stmt, 1)));
+        ingredient_tids.push_back(tid);
+    }
+    sqlite3_finalize(stmt);
+
+    sections[CATALOG_STRING_POOL].assign(string_pool.begin(), string_pool.end());
+    BuildIndex(item_tids, sections[CATALOG_INDEX_ITEM_BY_TID_SLOTS], sections[CATALOG_INDEX_ITEM_BY_TID_ROWS]);
+    BuildIndex(item_data_ids, sections[CATALOG_INDEX_ITEM_BY_DATA_ID_SLOTS], sections[CATALOG_INDEX_ITEM_BY_DATA_ID_ROWS]);
+    BuildIndex(ingredient_tids, sections[CATALOG_INDEX_INGREDIENT_BY_TID_SLOTS], sections[CATALOG_INDEX_INGREDIENT_BY_TID_ROWS]);
+
+    // Lay the sections out after the header, each at an aligned offset.
+    ItemCatalogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+    header.version = ITEM_CATALOG_VERSION;
+    header.byteOrderMark = CATALOG_BYTE_ORDER_MARK;
+    header.headerSize = sizeof(ItemCatalogHeader);
+    header.sourceChecksum = ReferenceDatabase::EmbeddedSourceChecksum();
+    header.sourceSize = ReferenceDatabase::EmbeddedSourceSize();
+    header.itemCount = static_cast<uint32_t>(item_tids.size());
+    header.ingredientCount = static_cast<uint32_t>(ingredient_tids.size());
+    header.sectionCount = CATALOG_SECTION_COUNT;
+    uint64_t offset = AlignUp(sizeof(ItemCatalogHeader));
+    for (int section = 0; section < CATALOG_SECTION_COUNT; ++section) {
+        header.sections[section].offset = offset;
+        header.sections[section].size = sections[section].size();
+        offset = AlignUp(offset + sections[section].size());
+    }
+    header.fileSize = offset;
+
+    std::vector<unsigned char> image(static_cast<size_t>(header.fileSize), 0);
+    memcpy(image.data(), &header, sizeof(header));
+    for (int section = 0; section < CATALOG_SECTION_COUNT; ++section) {
+        if (!sections[section].empty()) {
+            memcpy(image.data() + header.sections[section].offset, sections[section].data(), sections[section].size());
+        }
+    }
+
+    FILE* out = fopen(filepath.c_str(), "wb");
+    if (!out) {
+        out_error = "Could not open " + filepath + " for writing.";
+        return false;
+    }
+    bool written = fwrite(image.data(), 1, image.size(), out) == image.size();
+    written = (fclose(out) == 0) && written;
+    if (!written) {
+        out_error = "Could not write item catalog: " + filepath;
+        return false;
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Wrote item catalog " + filepath + ": " + std::to_string(header.itemCount) + " items, " +
+               std::to_string(header.ingredientCount) + " ingredients, " + std::to_string(header.fileSize) + " bytes.").c_str());
+    return true;
+}
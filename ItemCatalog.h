@@ -0,0 +1,149 @@
+// ItemCatalog.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "sqlite3.h"        // For generating a catalog from the reference database
+
+// Version of the item catalog file format. Bump when the layout or the set of sections changes.
+const uint32_t ITEM_CATALOG_VERSION = 1;
+
+// Sections of an item catalog file. Item and ingredient columns hold one fixed-width value per row, with
+// rows in ascending TID order. String columns hold uint32 offsets into the shared string pool.
+enum ItemCatalogSection {
+    // Items: int32 columns
+    CATALOG_ITEM_TID,
+    CATALOG_ITEM_TYPE,
+    CATALOG_ITEM_LEVEL,
+    CATALOG_ITEM_GRADE,
+    CATALOG_ITEM_RANK,
+    CATALOG_ITEM_MAX_STACK_COUNT,
+    CATALOG_ITEM_IS_DISPOSABLE,
+    CATALOG_ITEM_BUY_PRICE,
+    CATALOG_ITEM_SELL_PRICE,
+    CATALOG_ITEM_IS_NOT_SALE,
+    CATALOG_ITEM_DATA_ID,
+    CATALOG_ITEM_MAX_COUNT,
+    CATALOG_ITEM_SOURCE_PATH_ID,
+    CATALOG_ITEM_DLC_TYPE,
+    // Items: double column
+    CATALOG_ITEM_WEIGHT,
+    // Items: string columns
+    CATALOG_ITEM_TEXT_ID,
+    CATALOG_ITEM_DESC_ID,
+    CATALOG_ITEM_ICON,
+    CATALOG_ITEM_UI_ICON,
+    CATALOG_ITEM_SPAWN_OBJECT,
+    CATALOG_ITEM_DATA_EXCHANGE_FORMULA,
+    CATALOG_ITEM_DETAIL_IMAGE,
+    // Ingredients: int32 columns
+    CATALOG_INGREDIENT_TID,
+    CATALOG_INGREDIENT_TYPE,
+    // NUL-terminated strings; offset 0 is the empty string.
+    CATALOG_STRING_POOL,
+    // Hash indexes: an open-addressing slot table and the row lists its slots point into.
+    CATALOG_INDEX_ITEM_BY_TID_SLOTS,
+    CATALOG_INDEX_ITEM_BY_TID_ROWS,
+    CATALOG_INDEX_ITEM_BY_DATA_ID_SLOTS,
+    CATALOG_INDEX_ITEM_BY_DATA_ID_ROWS,
+    CATALOG_INDEX_INGREDIENT_BY_TID_SLOTS,
+    CATALOG_INDEX_INGREDIENT_BY_TID_ROWS,
+    CATALOG_SECTION_COUNT
+};
+
+// Hash indexes stored in an item catalog.
+enum ItemCatalogIndex {
+    CATALOG_INDEX_ITEM_BY_TID,          // Items.TID -> item row (unique)
+    CATALOG_INDEX_ITEM_BY_DATA_ID,      // Items.ItemDataID -> item rows, in TID order
+    CATALOG_INDEX_INGREDIENT_BY_TID,    // Ingredients.TID -> ingredient row (unique)
+    CATALOG_INDEX_COUNT
+};
+
+// Rows matching an index lookup, in ascending TID order. Points into the mapped file.
+struct ItemCatalogRows {
+    const uint32_t* rows;
+    uint32_t count;
+};
+
+struct ItemCatalogHeader;
+
+// Read-only view of a binary item catalog: the reference item data from embedded_sql.h laid out as a
+// header, fixed-width column arrays, a string pool and hash indexes, each section 64-byte aligned.
+// Opening a catalog maps the file and checks the header and section bounds; nothing is parsed or copied,
+// so processes that open the same file share its pages through the system file cache.
+class ItemCatalog {
+public:
+    ItemCatalog();
+    ~ItemCatalog();
+
+    ItemCatalog(const ItemCatalog&) = delete;
+    ItemCatalog& operator=(const ItemCatalog&) = delete;
+
+    // Maps a catalog file read-only. Fails if the file is not a catalog of this version, is damaged, or
+    // was generated from reference data other than the embedded_sql.h this build contains.
+    // Parameters:
+    //   filepath: Catalog file to map.
+    //   out_error: Receives a description of the failure, if any.
+    bool Open(const std::string& filepath, std::string& out_error);
+    // Unmaps the catalog, if open.
+    void Close();
+    bool IsOpen() const { return m_header != NULL; }
+
+    uint32_t GetItemCount() const;
+    uint32_t GetIngredientCount() const;
+
+    // Returns an int32 column value, or 0 if the section is not an int32 column or the row is out of range.
+    int32_t GetInt(ItemCatalogSection column, uint32_t row) const;
+    // Returns a whole int32 column (GetItemCount or GetIngredientCount values), or NULL if the section is
+    // not an int32 column. For loops over every row.
+    const int32_t* GetIntColumn(ItemCatalogSection column) const;
+    // Returns an item's weight, or 0.0 if the row is out of range.
+    double GetItemWeight(uint32_t row) const;
+    // Returns a string column value, or "" if the section is not a string column or the row is out of range.
+    const char* GetString(ItemCatalogSection column, uint32_t row) const;
+    // Returns the rows whose indexed column equals key (count 0 if there are none).
+    ItemCatalogRows Find(ItemCatalogIndex index, int32_t key) const;
+
+    // Generates a catalog file from the reference database (see ReferenceDatabase::Open), so the catalog
+    // is built from the same source as embedded_sql.h.
+    static bool Generate(sqlite3* db, const std::string& filepath, std::string& out_error);
+
+private:
+    void* m_file;                       // File handle, or NULL.
+    void* m_mapping;                    // File mapping handle, or NULL.
+    const unsigned char* m_base;        // Start of the mapped view.
+    const ItemCatalogHeader* m_header;  // Header at m_base once validated, or NULL if not open.
+
+    const void* SectionData(ItemCatalogSection section) const { return m_base + SectionOffset(section); }
+    uint64_t SectionOffset(ItemCatalogSection section) const;
+};
@@ -0,0 +1,256 @@
+// LoadStressCheck.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#define NOMINMAX // Prevent Windows.h from defining min/max macros
+
+#include "LoadStressCheck.h"
+#include <windows.h>        // For QueryPerformanceCounter, GetCurrentProcess
+#include <psapi.h>          // For GetProcessMemoryInfo
+#include <algorithm>        // For std::min, std::max
+#include <cstdio>           // For snprintf
+#include <string>
+#include "Logger.h"         // For LogMessage
+#include "SaveGameManager.h" // For LoadSaveFromMemory, MAX_SAVE_NESTING_DEPTH
+
+// Each case is loaded at base, 2x, 4x and 8x its base size.
+static const int STRESS_SIZE_STEPS = 4;
+// Loads per size; the fastest is kept to filter out scheduling noise.
+static const int STRESS_REPETITIONS = 3;
+// Largest allowed growth of time (or memory) per unit between the smallest and largest size.
+// Linear growth gives about 1; quadratic growth at 8x the base size gives about 8.
+static const double STRESS_LINEARITY_TOLERANCE = 3.0;
+// No single load may take longer than this, whatever the input.
+static const double STRESS_MAX_LOAD_MS = 2000.0;
+// Memory deltas below this are dominated by allocator noise and are not compared.
+static const size_t STRESS_MIN_MEASURABLE_BYTES = 1024 * 1024;
+
+// A family of pathological inputs, generated at a given size in abstract units.
+struct StressCase {
+    const char* name;
+    size_t baseUnits;
+    bool expectLoad;    // False if the loader is expected to reject the input (quickly).
+    void (*generate)(size_t units, std::string& out);
+};
+
+// Arrays nested just under the depth limit, repeated.
+static void GenerateNestedAtLimit(size_t units, std::string& out) {
+    const size_t depth = MAX_SAVE_NESTING_DEPTH - 2; // The outer object and array count as two levels.
+    out = "{\"a\":[";
+    for (size_t i = 0; i < units; ++i) {
+        if (i) out += ',';
+        out.append(depth, '[');
+        out += '0';
+        out.append(depth, ']');
+    }
+    out += "]}";
+}
+
+// A single array nested far beyond the depth limit; must be rejected without recursing.
+static void GenerateNestedBeyondLimit(size_t units, std::string& out) {
+    out = "{\"a\":";
+    out.append(units, '[');
+    out.append(units, ']');
+    out += '}';
+}
+
+// One long string made almost entirely of escape sequences, including surrogate pairs.
+static void GenerateEscapedString(size_t units, std::string& out) {
+    out = "{\"s\":\"";
+    for (size_t i = 0; i < units; ++i) {
+        out += "\\n\\t\\\"\\\\\\/\\u00e9\\ud83d\\ude00x";
+    }
+    out += "\"}";
+}
+
+// Integers and floats with hundreds of digits: they overflow 64-bit integers and need long decimal
+// conversion, but stay within double range (the parser rejects numbers that overflow a double).
+static void GenerateHugeNumbers(size_t units, std::string& out) {
+    out = "{\"n\":[";
+    for (size_t i = 0; i < units; ++i) {
+        if (i) out += ',';
+        out += (i % 2) ? "-" : "";
+        out.append(1, static_cast<char>('1' + i % 9));
+        out.append(300, static_cast<char>('0' + i % 10));
+        out += (i % 3 == 0) ? ".5e-300" : "";
+    }
+    out += "]}";
+}
+
+// One object repeating the same key; only the last value is kept.
+static void GenerateDuplicateKeys(size_t units, std::string& out) {
+    out = "{\"PlayerInfo\":{";
+    for (size_t i = 0; i < units; ++i) {
+        if (i) out += ',';
+        out += "\"m_Gold\":" + std::to_string(i);
+    }
+    out += "}}";
+}
+
+// A realistic Ingredients section with a very large number of entries.
+static void GenerateGiantIngredients(size_t units, std::string& out) {
+    out = "{\"PlayerInfo\":{\"m_Gold\":1,\"m_Bei\":1,\"m_ChefFlame\":1},\"Ingredients\":{";
+    for (size_t i = 0; i < units; ++i) {
+        if (i) out += ',';
+        std::string id = std::to_string(1000000 + i);
+        out += "\"" + id + "\":{\"ingredientsID\":" + id + ",\"level\":1,\"parentID\":0,\"count\":" + std::to_string(i % 999) +
+               ",\"branchCount\":0,\"lastGainTime\":\"04/01/2025 12:34:56\",\"lastGainGameTime\":\"10/03/2022 08:30:52\","
+               "\"isNew\":false,\"placeTagMask\":1}";
+    }
+    out += "}}";
+}
+
+static const StressCase STRESS_CASES[] = {
+    { "nesting at depth limit",     64,     true,  GenerateNestedAtLimit },
+    { "nesting beyond depth limit", 100000, false, GenerateNestedBeyondLimit },
+    { "escaped string",             20000,  true,  GenerateEscapedString },
+    { "huge numbers",               1000,   true,  GenerateHugeNumbers },
+    { "duplicate keys",             50000,  true,  GenerateDuplicateKeys },
+    { "giant Ingredients map",      5000,   true,  GenerateGiantIngredients },
+};
+
+static double NowMilliseconds() {
+    static LARGE_INTEGER frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f;
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * 1000.0 / static_cast<double>(frequency.QuadPart);
+}
+
+// Returns the process's private committed memory, or 0 if it cannot be read.
+static size_t CurrentPrivateBytes() {
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<size_t>(counters.PrivateUsage);
+}
+
+// Result of loading one case at one size.
+struct StressMeasurement {
+    size_t units;
+    size_t inputBytes;
+    double milliseconds;    // Fastest of STRESS_REPETITIONS loads.
+    size_t memoryBytes;     // Private memory held by the loaded save (0 if unavailable).
+    bool loaded;
+};
+
+static StressMeasurement MeasureLoad(const StressCase& stress_case, size_t units) {
+    StressMeasurement m = { units, 0, 0.0, 0, false };
+    std::string input;
+    stress_case.generate(units, input);
+    m.inputBytes = input.size();
+
+    // The loader logs every step of every load; keep only its warnings and errors.
+    bool info_enabled = Logger::IsInfoEnabled();
+    Logger::SetInfoEnabled(false);
+    for (int rep = 0; rep < STRESS_REPETITIONS; ++rep) {
+        std::string bytes = input; // Loading decodes in place; keep the generated input intact.
+        SaveGameManager manager;
+        size_t memory_before = CurrentPrivateBytes();
+        double start = NowMilliseconds();
+        bool loaded = manager.LoadSaveFromMemory(bytes, "stress.sav");
+        double elapsed = NowMilliseconds() - start;
+        size_t memory_after = CurrentPrivateBytes();
+
+        if (rep == 0 || elapsed < m.milliseconds) {
+            m.milliseconds = elapsed;
+        }
+        if (rep == 0) {
+            m.loaded = loaded;
+            m.memoryBytes = memory_after > memory_before ? memory_after - memory_before : 0;
+        }
+    }
+    Logger::SetInfoEnabled(info_enabled);
+    return m;
+}
+
+// Runs one case at every size and reports whether it behaved.
+static bool RunStressCase(const StressCase& stress_case) {
+    StressMeasurement measurements[STRESS_SIZE_STEPS];
+    bool ok = true;
+    char line[256];
+    for (int step = 0; step < STRESS_SIZE_STEPS; ++step) {
+        StressMeasurement& m = measurements[step];
+        m = MeasureLoad(stress_case, stress_case.baseUnits << step);
+        snprintf(line, sizeof(line), "  %-28s %9zu units %11zu bytes %10.2f ms %12zu bytes held  %s",
+                 stress_case.name, m.units, m.inputBytes, m.milliseconds, m.memoryBytes, m.loaded ? "loaded" : "rejected");
+        LogMessage(LOG_INFO_LEVEL, line);
+        if (m.loaded != stress_case.expectLoad) {
+            LogMessage(LOG_ERROR_LEVEL, ("  " + std::string(stress_case.name) + ": expected the input to be " +
+                       (stress_case.expectLoad ? "loaded" : "rejected") + ".").c_str());
+            ok = false;
+        }
+        if (m.milliseconds > STRESS_MAX_LOAD_MS) {
+            LogMessage(LOG_ERROR_LEVEL, ("  " + std::string(stress_case.name) + ": a single load exceeded the time limit.").c_str());
+            ok = false;
+        }
+    }
+
+    // Compare cost per unit at the largest size against the smallest.
+    const StressMeasurement& first = measurements[0];
+    const StressMeasurement& last = measurements[STRESS_SIZE_STEPS - 1];
+    const double scale = static_cast<double>(last.units) / static_cast<double>(first.units);
+    double time_growth = (last.milliseconds / scale) / std::max(first.milliseconds, 0.001);
+    snprintf(line, sizeof(line), "  %-28s time per unit grew %.2fx from %zu to %zu units", stress_case.name, time_growth, first.units, last.units);
+    LogMessage(time_growth > STRESS_LINEARITY_TOLERANCE ? LOG_ERROR_LEVEL : LOG_INFO_LEVEL, line);
+    if (time_growth > STRESS_LINEARITY_TOLERANCE) {
+        ok = false;
+    }
+    if (first.memoryBytes >= STRESS_MIN_MEASURABLE_BYTES && last.memoryBytes >= STRESS_MIN_MEASURABLE_BYTES) {
+        double memory_growth = (static_cast<double>(last.memoryBytes) / scale) / static_cast<double>(first.memoryBytes);
+        snprintf(line, sizeof(line), "  %-28s memory per unit grew %.2fx", stress_case.name, memory_growth);
+        LogMessage(memory_growth > STRESS_LINEARITY_TOLERANCE ? LOG_ERROR_LEVEL : LOG_INFO_LEVEL, line);
+        if (memory_growth > STRESS_LINEARITY_TOLERANCE) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int RunLoadStressCheck() {
+    LogMessage(LOG_INFO_LEVEL, "Running load stress check.");
+    size_t failed = 0;
+    for (const StressCase& stress_case : STRESS_CASES) {
+        if (!RunStressCase(stress_case)) {
+            failed++;
+        }
+    }
+
+    if (failed) {
+        LogMessage(LOG_ERROR_LEVEL, ("Load stress check FAILED: " + std::to_string(failed) + " case(s) misbehaved.").c_str());
+        return 1;
+    }
+    LogMessage(LOG_INFO_LEVEL, "Load stress check passed.");
+    return 0;
+}
@@ -0,0 +1,278 @@
+// LocalizationTable.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "LocalizationTable.h"
+#include <algorithm>        // For std::sort
+#include <unordered_map>    // For interning strings and matching text IDs during an import
+#include "json.hpp"         // For nlohmann::json (JSON localization tables)
+#include "CsvReader.h"      // For CsvReader, ReadTextFile
+
+// Lowercases ASCII letters only; localized names are UTF-8 and other bytes compare as-is.
+static char ToLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ToLowerAscii(a[i]) != ToLowerAscii(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if needle (already lowercased) occurs in haystack, ignoring ASCII case.
+static bool ContainsIgnoreCase(const char* haystack, const std::string& needle) {
+    if (needle.empty()) {
+        return true;
+    }
+    for (; *haystack; ++haystack) {
+        size_t i = 0;
+        while (i < needle.size() && haystack[i] && ToLowerAscii(haystack[i]) == needle[i]) {
+            i++;
+        }
+        if (i == needle.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Collects strings into a pool, storing each distinct string once.
+class StringPoolBuilder {
+public:
+    explicit StringPoolBuilder(std::string& pool) : m_pool(pool) {
+        m_pool.assign(1, '\0');
+        m_offsets[""] = 0;
+    }
+    uint32_t Intern(const std::string& text) {
+        auto found = m_offsets.find(text);
+        if (found != m_offsets.end()) {
+            return found->second;
+        }
+        uint32_t offset = static_cast<uint32_t>(m_pool.size());
+        m_pool.append(text.c_str(), text.size() + 1);
+        m_offsets.emplace(text, offset);
+        return offset;
+    }
+private:
+    std::string& m_pool;
+    std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+LocalizationTable::LocalizationTable() : m_pool(1, '\0'), m_activeLanguage(0), m_minTid(0), m_nameCount(0) {
+}
+
+bool LocalizationTable::Import(const std::string& filepath, const ItemCatalog* catalog, sqlite3* db, std::string& out_error) {
+    std::string text;
+    if (!ReadTextFile(filepath, MAX_LOCALIZATION_FILE_BYTES, text, out_error)) {
+        return false;
+    }
+
+    // 1. Read the reference items (TID and ItemTextID), in TID order.
+    std::vector<std::pair<int32_t, std::string>> items;
+    if (catalog && catalog->IsOpen()) {
+        items.reserve(catalog->GetItemCount());
+        for (uint32_t row = 0; row < catalog->GetItemCount(); ++row) {
+            items.emplace_back(catalog->GetInt(CATALOG_ITEM_TID, row), catalog->GetString(CATALOG_ITEM_TEXT_ID, row));
+        }
+    } else if (db) {
+        sqlite3_stmt* stmt = NULL;
+        if (sqlite3_prepare_v2(db, "SELECT TID, ItemTextID FROM Items ORDER BY TID;", -1, &stmt, NULL) != SQLITE_OK) {
+            out_error = "SQL prepare failed for the localization import: " + std::string(sqlite3_errmsg(db));
+            return false;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            const unsigned char* text_id = sqlite3_column_text(stmt, 1);
+            items.emplace_back(sqlite3_column_int(stmt, 0), text_id ? reinterpret_cast<const char*>(text_id) : "");
+        }
+        sqlite3_finalize(stmt);
+    } else {
+        out_error = "No item catalog or reference database to bind the localization table to.";
+        return false;
+    }
+    if (items.empty()) {
+        out_error = "The reference data has no items to localize.";
+        return false;
+    }
+    std::sort(items.begin(), items.end());
+    if (static_cast<int64_t>(items.back().first) - items.front().first >= MAX_LOCALIZED_TID_SPAN) {
+        out_error = "Item TIDs are spread too widely to index directly.";
+        return false;
+    }
+
+    // 2. Parse the table into languages and (language, text ID, name) entries.
+    std::vector<std::string> languages;
+    std::vector<std::pair<size_t, std::pair<std::string, std::string>>> entries;
+    bool is_json = filepath.size() >= 5 && EqualsIgnoreCase(filepath.substr(filepath.size() - 5), ".json");
+    if (is_json) {
+        try {
+            nlohmann::json document = nlohmann::json::parse(text);
+            if (!document.is_object()) {
+                out_error = "Localization table is not a JSON object of languages: " + filepath;
+                return false;
+            }
+            for (auto language = document.begin(); language != document.end(); ++language) {
+                if (!language.value().is_object()) {
+                    continue;
+                }
+                languages.push_back(language.key());
+                for (auto name = language.value().begin(); name != language.value().end(); ++name) {
+                    if (name.value().is_string()) {
+                        entries.push_back({ languages.size() - 1, { name.key(), name.value().get<std::string>() } });
+                    }
+                }
+            }
+        } catch (const std::exception& e) {
+            out_error = "Could not parse localization table " + filepath + ": " + e.what();
+            return false;
+        }
+    } else {
+        CsvReader reader(text);
+        std::vector<std::string> fields;
+        if (!reader.ReadRecord(fields) || fields.size() < 2) {
+            out_error = "Localization table has no header row with at least one language: " + filepath;
+            return false;
+        }
+        languages.assign(fields.begin() + 1, fields.end());
+        while (reader.ReadRecord(fields)) {
+            for (size_t column = 1; column < fields.size() && column <= languages.size(); ++column) {
+                if (!fields[column].empty()) {
+                    entries.push_back({ column - 1, { fields[0], fields[column] } });
+                }
+            }
+        }
+    }
+    if (languages.empty()) {
+        out_error = "Localization table has no languages: " + filepath;
+        return false;
+    }
+
+    // 3. Build the pool, the TID index and the per-language offset arrays.
+    std::string pool;
+    StringPoolBuilder builder(pool);
+    size_t item_count = items.size();
+    std::vector<int32_t> tids(item_count);
+    std::vector<uint32_t> name_offsets((languages.size() + 1) * item_count, 0);
+    std::unordered_multimap<std::string, size_t> rows_by_text_id; // Some items share a text ID, and so a name.
+    for (size_t row = 0; row < item_count; ++row) {
+        tids[row] = items[row].first;
+        name_offsets[row] = builder.Intern(items[row].second);
+        rows_by_text_id.emplace(items[row].second, row);
+    }
+    size_t matched = 0;
+    for (const auto& entry : entries) {
+        auto rows = rows_by_text_id.equal_range(entry.second.first);
+        if (rows.first == rows.second) {
+            continue;
+        }
+        uint32_t offset = builder.Intern(entry.second.second);
+        for (auto row = rows.first; row != rows.second; ++row) {
+            name_offsets[(entry.first + 1) * item_count + row->second] = offset;
+        }
+        matched++;
+    }
+    if (pool.size() > UINT32_MAX) {
+        out_error = "Localization table is too large: " + filepath;
+        return false;
+    }
+
+    int32_t min_tid = tids.front();
+    std::vector<uint32_t> row_by_tid(static_cast<size_t>(tids.back() - min_tid) + 1, 0);
+    for (size_t row = 0; row < item_count; ++row) {
+        row_by_tid[tids[row] - min_tid] = static_cast<uint32_t>(row + 1);
+    }
+
+    m_pool.swap(pool);
+    m_languages.swap(languages);
+    m_activeLanguage = 0;
+    m_tids.swap(tids);
+    m_minTid = min_tid;
+    m_rowByTid.swap(row_by_tid);
+    m_nameOffsets.swap(name_offsets);
+    m_nameCount = matched;
+    return true;
+}
+
+const std::string& LocalizationTable::GetLanguage() const {
+    static const std::string none;
+    return m_languages.empty() ? none : m_languages[m_activeLanguage];
+}
+
+bool LocalizationTable::SetLanguage(const std::string& language) {
+    for (size_t i = 0; i < m_languages.size(); ++i) {
+        if (EqualsIgnoreCase(m_languages[i], language)) {
+            m_activeLanguage = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t LocalizationTable::FindRow(int32_t tid) const {
+    int64_t index = static_cast<int64_t>(tid) - m_minTid;
+    if (index < 0 || index >= static_cast<int64_t>(m_rowByTid.size()) || m_rowByTid[static_cast<size_t>(index)] == 0) {
+        return -1;
+    }
+    return m_rowByTid[static_cast<size_t>(index)] - 1;
+}
+
+const char* LocalizationTable::GetItemName(int32_t tid) const {
+    int64_t row = FindRow(tid);
+    if (row < 0) {
+        return NULL;
+    }
+    const char* name = NameAt(m_activeLanguage + 1, static_cast<size_t>(row));
+    return *name ? name : NameAt(0, static_cast<size_t>(row));
+}
+
+const char* LocalizationTable::GetItemTextId(int32_t tid) const {
+    int64_t row = FindRow(tid);
+    return row < 0 ? NULL : NameAt(0, static_cast<size_t>(row));
+}
+
+void LocalizationTable::FindItems(const std::string& text, std::vector<int32_t>& out_tids) const {
+    if (!IsLoaded()) {
+        return;
+    }
+    std::string needle(text);
+    for (char& c : needle) {
+        c = ToLowerAscii(c);
+    }
+    for (size_t row = 0; row < m_tids.size(); ++row) {
+        if (ContainsIgnoreCase(NameAt(m_activeLanguage + 1, row), needle) || ContainsIgnoreCase(NameAt(0, row), needle)) {
+            out_tids.push_back(m_tids[row]);
+        }
+    }
+}
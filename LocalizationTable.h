@@ -0,0 +1,100 @@
+// LocalizationTable.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "sqlite3.h"        // For reading item text IDs from the reference database
+#include "ItemCatalog.h"    // For reading item text IDs from an item catalog
+
+// Largest localization table accepted by the importer.
+const size_t MAX_LOCALIZATION_FILE_BYTES = 64 * 1024 * 1024;
+// Largest spread of item TIDs the table indexes directly. The reference data spans about 10,000 TIDs.
+const uint32_t MAX_LOCALIZED_TID_SPAN = 1 << 20;
+
+// Display names of the reference items in one or more languages, imported from the game's localization
+// tables. Names are keyed by the item's ItemTextID (e.g. "Bacon_Relic").
+// All names live in one string pool. A TID is turned into an item row through an array indexed by
+// (TID - smallest TID), and a row into a pool offset through one offset array per language, so a lookup
+// is two array reads and allocates nothing. Switching the active language only changes which offset
+// array is read.
+class LocalizationTable {
+public:
+    LocalizationTable();
+
+    // Imports a localization table and binds it to the reference items, replacing any previous import.
+    // Accepted formats:
+    //   CSV:  a header row "Key,<language>,<language>,..." followed by one row per text ID.
+    //   JSON: { "<language>": { "<text ID>": "<name>", ... }, ... }
+    // Files ending in ".json" are read as JSON, anything else as CSV. Text IDs that match no item are
+    // ignored. Items are read from catalog if it is open, otherwise from db.
+    // Parameters:
+    //   filepath: Localization table to import.
+    //   catalog: Item catalog to read items from, or NULL.
+    //   db: Reference database to read items from when there is no catalog.
+    //   out_error: Receives a description of the failure, if any.
+    bool Import(const std::string& filepath, const ItemCatalog* catalog, sqlite3* db, std::string& out_error);
+    bool IsLoaded() const { return !m_languages.empty(); }
+    // Number of table entries the last import matched to items, over all languages.
+    size_t GetNameCount() const { return m_nameCount; }
+
+    const std::vector<std::string>& GetLanguages() const { return m_languages; }
+    const std::string& GetLanguage() const;
+    // Makes language (matched case-insensitively) the active one. Returns false, keeping the current
+    // language, if the table has no such language.
+    bool SetLanguage(const std::string& language);
+
+    // Returns the item's name in the active language, or its ItemTextID if the language has no name for
+    // it. Returns NULL if tid is not a reference item. The pointer stays valid until the next Import.
+    const char* GetItemName(int32_t tid) const;
+    // Returns the item's ItemTextID, or NULL if tid is not a reference item.
+    const char* GetItemTextId(int32_t tid) const;
+    // Appends to out_tids, in TID order, every item whose active-language name or ItemTextID contains text
+    // (ASCII case-insensitive).
+    void FindItems(const std::string& text, std::vector<int32_t>& out_tids) const;
+
+private:
+    std::string m_pool;                     // NUL-terminated strings; offset 0 is the empty string.
+    std::vector<std::string> m_languages;
+    size_t m_activeLanguage;
+    std::vector<int32_t> m_tids;            // Item TIDs by row, ascending.
+    int32_t m_minTid;
+    std::vector<uint32_t> m_rowByTid;       // Row + 1 for TID m_minTid + i; 0 if no such item.
+    // Pool offsets by [language + 1][row]; the first array holds the ItemTextIDs. 0 means no name.
+    std::vector<uint32_t> m_nameOffsets;
+    size_t m_nameCount;
+
+    // Returns the item row for tid, or -1.
+    int64_t FindRow(int32_t tid) const;
+    const char* NameAt(size_t language_slot, size_t row) const { return m_pool.data() + m_nameOffsets[language_slot * m_tids.size() + row]; }
+};
@@ -32,15 +32,15 @@
 #include "Logger.h"
 #include <iostream>     // For std::cout, std::cerr
 #include <filesystem>   // For std::filesystem::path, exists, create_directories
-#include <chrono>       // For std::chrono::system_clock
-#include <iomanip>      // For std::put_time
-#include <sstream>      // For std::stringstream
+#include "SaveTimestamp.h" // For the log file name timestamp
 
 // Static member definitions for the Logger class.
 std::ofstream Logger::s_logFile;
 bool Logger::s_isFileLoggingEnabled = false;
 std::string Logger::s_logFilePath;
 std::string Logger::s_binDirectory;
+std::mutex Logger::s_mutex;
+std::atomic<bool> Logger::s_isInfoEnabled(true);
 
 // Initializes the Logger by setting up the log file path and opening the file if logging is enabled.
 void Logger::Initialize(const std::string& appName, bool enableFileLogging, const std::string& binDir) {
@@ -54,11 +54,9 @@ void Logger::Initialize(const std::string& appName, bool enableFileLogging, cons
         }
 
         // Generate a timestamp for the log file name.
-        auto now = std::chrono::system_clock::now();
-        std::time_t time_now = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_now), "%Y%m%d_%H%M%S");
-        std::string timestamp = ss.str();
+        char timestamp_buf[COMPACT_TIMESTAMP_LENGTH];
+        FormatCompactTimestamp(CurrentLocalTimestamp(), timestamp_buf);
+        std::string timestamp(timestamp_buf, COMPACT_TIMESTAMP_LENGTH);
 
         // Construct the full log file path.
         s_logFilePath = logDirPath.string() + "/" + appName + "_log_" + timestamp + ".txt";
@@ -75,6 +73,9 @@ void Logger::Initialize(const std::string& appName, bool enableFileLogging, cons
 // Logs a message to the console and the log file (if enabled).
 // Messages are prefixed with their log level and optionally include an SQLite error code.
 void Logger::Log(LogLevel level, const char* message, int sqlite_err_code) {
+    if (level == LOG_INFO_LEVEL && !s_isInfoEnabled) {
+        return;
+    }
     std::string prefix;
     std::ostream* os_console; // Pointer to either std::cout or std::cerr.
 
@@ -92,6 +93,7 @@ void Logger::Log(LogLevel level, const char* message, int sqlite_err_code) {
         full_message += " (Error Code: " + std::to_string(sqlite_err_code) + ")";
     }
 
+    std::lock_guard<std::mutex> lock(s_mutex);
     // Output to console.
     *os_console << full_message << std::endl;
     // Output to file if enabled and open.
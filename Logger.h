@@ -33,6 +33,8 @@
 
 #include <string>
 #include <fstream>
+#include <mutex>
+#include <atomic>
 #include "DaveSaveEd.h" // For LogLevel enum and BIN_DIRECTORY
 
 // The Logger class provides static methods for application-wide logging.
@@ -53,6 +55,11 @@ public:
     //   sqlite_err_code: Optional SQLite error code to include in the log message.
     static void Log(LogLevel level, const char* message, int sqlite_err_code = -1);
 
+    // Enables or disables informational messages; errors and warnings are always logged.
+    // Used by headless checks that run the loader many times and report their own results.
+    static void SetInfoEnabled(bool enabled) { s_isInfoEnabled = enabled; }
+    static bool IsInfoEnabled() { return s_isInfoEnabled; }
+
     // Shuts down the logging system, ensuring the log file is properly closed.
     static void Shutdown();
 
@@ -62,6 +69,8 @@ private:
     static bool s_isFileLoggingEnabled;
     static std::string s_logFilePath;
     static std::string s_binDirectory;
+    static std::mutex s_mutex; // Serializes output from the UI thread and background workers.
+    static std::atomic<bool> s_isInfoEnabled;
 };
 
 // Global function alias for convenience to call the static Logger::Log method.
@@ -0,0 +1,132 @@
+// ParallelDeflate.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "ParallelDeflate.h"
+#include <algorithm>        // For std::min
+#include <atomic>           // For std::atomic
+#include <stdexcept>        // For std::runtime_error
+#include <thread>           // For std::thread::hardware_concurrency
+#include "ZlibUtil.h"       // For pooled deflate streams
+#include "WorkerThreads.h"  // For RunWorkerThreads
+
+// One block's share of the stream: raw deflate output and the Adler-32 of its input.
+struct DeflateBlock {
+    std::vector<unsigned char> output;
+    uLong adler = 1;
+    std::string error;
+};
+
+// Deflates block index of data as raw deflate data, primed with the preceding dictionary. The stream
+// comes from the worker thread's pool, so a worker sets one up once, not once per block.
+static void DeflateBlockAt(const std::string& data, size_t index, int level, DeflateBlock& block) {
+    const size_t start = index * PARALLEL_DEFLATE_BLOCK_SIZE;
+    const size_t length = std::min(PARALLEL_DEFLATE_BLOCK_SIZE, data.size() - start);
+    const bool last = start + length == data.size();
+    const Bytef* input = reinterpret_cast<const Bytef*>(data.data()) + start;
+
+    ZlibDeflateContext context(level, RAW_DEFLATE_WINDOW_BITS); // Raw deflate: no header or trailer per block.
+    z_stream* strm = context.Get();
+    if (!strm) {
+        block.error = "zlib deflateInit2 failed.";
+        return;
+    }
+    if (start > 0) {
+        const size_t dictionary_length = std::min(PARALLEL_DEFLATE_DICTIONARY_SIZE, start);
+        deflateSetDictionary(strm, input - dictionary_length, static_cast<uInt>(dictionary_length));
+    }
+    // deflateBound covers the block; the sync flush adds at most an empty stored block and a few bits.
+    block.output.resize(deflateBound(strm, static_cast<uLong>(length)) + 16);
+    strm->avail_in = static_cast<uInt>(length);
+    strm->next_in = const_cast<Bytef*>(input);
+    strm->avail_out = static_cast<uInt>(block.output.size());
+    strm->next_out = block.output.data();
+    // Every block but the last ends with an empty stored block, which byte-aligns it for concatenation.
+    int ret = deflate(strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if (ret != (last ? Z_STREAM_END : Z_OK) || strm->avail_in != 0) {
+        block.error = "zlib deflate failed: " + std::string(strm->msg ? strm->msg : "Unknown error");
+        return;
+    }
+    block.output.resize(strm->total_out);
+    block.adler = adler32(1L, input, static_cast<uInt>(length));
+}
+
+std::vector<unsigned char> ParallelCompressZlib(const std::string& data, int level, unsigned threads) {
+    const size_t block_count = (data.size() + PARALLEL_DEFLATE_BLOCK_SIZE - 1) / PARALLEL_DEFLATE_BLOCK_SIZE;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (block_count <= 1 || threads == 1) {
+        // Serial path: one stream.
+        std::vector<unsigned char> compressed_bytes;
+        std::string error;
+        if (!ZlibCompress(data.data(), data.size(), compressed_bytes, error, level)) {
+            throw std::runtime_error(error);
+        }
+        return compressed_bytes;
+    }
+
+    // Workers take blocks in order from a shared counter, so a slow block does not hold up a fixed share.
+    std::vector<DeflateBlock> blocks(block_count);
+    RunWorkerThreads(block_count, threads, "deflate worker", [&](std::atomic<size_t>& next) {
+        for (size_t index = next++; index < block_count; index = next++) {
+            DeflateBlockAt(data, index, level, blocks[index]);
+        }
+    });
+
+    // zlib header: deflate with a 32 KB window, FLEVEL from the compression level, and FCHECK so the
+    // header is a multiple of 31.
+    const int effective_level = level == Z_DEFAULT_COMPRESSION ? 6 : level;
+    const unsigned flevel = effective_level < 2 ? 0 : effective_level < 6 ? 1 : effective_level == 6 ? 2 : 3;
+    unsigned header = (0x78u << 8) | (flevel << 6);
+    header += 31 - header % 31;
+
+    size_t total = 6;
+    for (const DeflateBlock& block : blocks) {
+        if (!block.error.empty()) {
+            throw std::runtime_error(block.error);
+        }
+        total += block.output.size();
+    }
+    std::vector<unsigned char> compressed_bytes;
+    compressed_bytes.reserve(total);
+    compressed_bytes.push_back(static_cast<unsigned char>(header >> 8));
+    compressed_bytes.push_back(static_cast<unsigned char>(header & 0xFF));
+    uLong adler = 1;
+    for (size_t index = 0; index < block_count; ++index) {
+        const size_t length = std::min(PARALLEL_DEFLATE_BLOCK_SIZE, data.size() - index * PARALLEL_DEFLATE_BLOCK_SIZE);
+        compressed_bytes.insert(compressed_bytes.end(), blocks[index].output.begin(), blocks[index].output.end());
+        adler = adler32_combine(adler, blocks[index].adler, static_cast<z_off_t>(length));
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        compressed_bytes.push_back(static_cast<unsigned char>((adler >> shift) & 0xFF)); // Trailer is big-endian.
+    }
+    return compressed_bytes;
+}
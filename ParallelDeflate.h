@@ -0,0 +1,50 @@
+// ParallelDeflate.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+#include "zlib.h"   // For Z_DEFAULT_COMPRESSION
+
+// Input bytes deflated per block by each worker.
+const size_t PARALLEL_DEFLATE_BLOCK_SIZE = 128 * 1024;
+// Tail of the previous block each block is primed with, so matches can reach back across blocks.
+const size_t PARALLEL_DEFLATE_DICTIONARY_SIZE = 32 * 1024;
+
+// Compresses data into a single zlib stream (RFC 1950), like a serial deflate, but splits it into
+// PARALLEL_DEFLATE_BLOCK_SIZE blocks deflated concurrently. Each block is primed with the previous
+// block's last 32 KB as a dictionary and ends on a byte boundary (Z_SYNC_FLUSH), so the blocks
+// concatenate into one deflate stream; the Adler-32 trailer is combined from per-block checksums.
+// The result inflates with stock zlib. threads is the number of workers, 0 meaning one per core; they
+// run on RunWorkerThreads, which starts them for the call. Input of a single block is compressed
+// serially. Throws std::runtime_error on zlib errors.
+std::vector<unsigned char> ParallelCompressZlib(const std::string& data, int level = Z_DEFAULT_COMPRESSION, unsigned threads = 0);
@@ -0,0 +1,170 @@
+// PerfCounters.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "PerfCounters.h"
+
+#if defined(_WIN32)
+#include <windows.h>            // For QueryThreadCycleTime
+#elif defined(__linux__)
+#include <linux/perf_event.h>   // For perf_event_attr and PERF_* constants
+#include <sys/ioctl.h>          // For ioctl
+#include <sys/syscall.h>        // For SYS_perf_event_open
+#include <unistd.h>             // For syscall, read, close
+#include <cstring>              // For memset
+#endif
+
+const char* GetPerfCounterName(PerfCounterEvent event) {
+    switch (event) {
+        case PERF_COUNTER_CYCLES:           return "cycles";
+        case PERF_COUNTER_INSTRUCTIONS:     return "instructions";
+        case PERF_COUNTER_CACHE_MISSES:     return "cache misses";
+        case PERF_COUNTER_BRANCH_MISSES:    return "branch misses";
+        default:                            return "unknown";
+    }
+}
+
+#if defined(__linux__) && !defined(_WIN32)
+// Opens one hardware counter for the calling thread, initially disabled. Returns -1 if unavailable
+// (no PMU in a VM, perf_event_paranoid too strict, or an unsupported event).
+static int OpenPerfEvent(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;    // User-space only; allowed at perf_event_paranoid <= 2.
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any CPU */, -1, 0));
+}
+#endif
+
+PerfCounters::PerfCounters() : m_startCycles(0), m_backend("none (wall-clock time only)") {
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        m_available[i] = false;
+        m_counts[i] = 0;
+        m_fds[i] = -1;
+    }
+#if defined(_WIN32)
+    ULONG64 cycles = 0;
+    if (QueryThreadCycleTime(GetCurrentThread(), &cycles)) {
+        m_available[PERF_COUNTER_CYCLES] = true;
+        m_backend = "QueryThreadCycleTime (cycles only)";
+    }
+#elif defined(__linux__)
+    // Events are opened individually rather than as one group, so a PMU that lacks one event (common
+    // in virtual machines) still provides the others.
+    static const uint64_t CONFIGS[PERF_COUNTER_EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    bool any = false;
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        m_fds[i] = OpenPerfEvent(CONFIGS[i]);
+        m_available[i] = m_fds[i] >= 0;
+        any = any || m_available[i];
+    }
+    if (any) {
+        m_backend = "perf_event_open";
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__) && !defined(_WIN32)
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        if (m_fds[i] >= 0) {
+            close(m_fds[i]);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Start() {
+#if defined(_WIN32)
+    if (m_available[PERF_COUNTER_CYCLES]) {
+        ULONG64 cycles = 0;
+        QueryThreadCycleTime(GetCurrentThread(), &cycles);
+        m_startCycles = cycles;
+    }
+#elif defined(__linux__)
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        if (m_fds[i] >= 0) {
+            ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Stop() {
+#if defined(_WIN32)
+    if (m_available[PERF_COUNTER_CYCLES]) {
+        ULONG64 cycles = 0;
+        QueryThreadCycleTime(GetCurrentThread(), &cycles);
+        m_counts[PERF_COUNTER_CYCLES] += cycles - m_startCycles;
+    }
+#elif defined(__linux__)
+    // Disabled counters keep their value, so later intervals add to it.
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        if (m_fds[i] >= 0) {
+            ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::Reset() {
+    for (int i = 0; i < PERF_COUNTER_EVENT_COUNT; ++i) {
+        m_counts[i] = 0;
+#if defined(__linux__) && !defined(_WIN32)
+        if (m_fds[i] >= 0) {
+            ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+        }
+#endif
+    }
+}
+
+uint64_t PerfCounters::GetCount(PerfCounterEvent event) const {
+    if (!m_available[event]) {
+        return 0;
+    }
+#if defined(__linux__) && !defined(_WIN32)
+    uint64_t value = 0;
+    if (read(m_fds[event], &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+        return 0;
+    }
+    return value;
+#else
+    return m_counts[event];
+#endif
+}
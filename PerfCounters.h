@@ -0,0 +1,79 @@
+// PerfCounters.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+
+// Hardware events collected around benchmarked code.
+enum PerfCounterEvent {
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_CACHE_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_EVENT_COUNT
+};
+
+// Returns a short display name for an event, e.g. "cycles".
+const char* GetPerfCounterName(PerfCounterEvent event);
+
+// Accumulating hardware performance counters for the calling thread.
+// Backends: perf_event_open on Linux (all events, when the kernel and permissions allow), and
+// QueryThreadCycleTime on Windows (cycles only). Events that cannot be collected are reported as
+// unavailable rather than failing, so benchmarks still run with wall-clock time alone.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Starts or resumes counting. Counts from successive Start/Stop intervals are summed.
+    void Start();
+    // Pauses counting.
+    void Stop();
+    // Clears the accumulated counts.
+    void Reset();
+
+    bool IsAvailable(PerfCounterEvent event) const { return m_available[event]; }
+    // Returns the accumulated count for an event (0 if unavailable).
+    uint64_t GetCount(PerfCounterEvent event) const;
+    // Returns a one-line description of the active backend and its events, for reports.
+    const char* GetBackendDescription() const { return m_backend; }
+
+private:
+    bool m_available[PERF_COUNTER_EVENT_COUNT];
+    uint64_t m_counts[PERF_COUNTER_EVENT_COUNT];  // Totals accumulated by backends that sample at Start/Stop.
+    uint64_t m_startCycles;                       // Thread cycle count at the last Start (Windows backend).
+    int m_fds[PERF_COUNTER_EVENT_COUNT];          // perf_event file descriptors, -1 if not open (Linux backend).
+    const char* m_backend;
+};
@@ -0,0 +1,336 @@
+// PooledString.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "PooledString.h"
+
+#include <algorithm>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include "SaveJsonArena.h"  // For AllocateSaveJsonMemory
+
+namespace {
+// The pool installed by the innermost ScopedStringInterning on each thread.
+thread_local StringInternPool* g_currentInternPool = NULL;
+}
+
+// --- Buffers ---
+// Buffers come from the installed SaveJsonArena, if any, like the nodes of the documents that hold them.
+PooledStringBuffer* PooledString::AllocateBuffer(size_type capacity) {
+    void* memory = AllocateSaveJsonMemory(sizeof(PooledStringBuffer) + capacity + 1);
+    PooledStringBuffer* buffer = new (memory) PooledStringBuffer;
+    buffer->refs.store(1, std::memory_order_relaxed);
+    buffer->shareable = true;
+    buffer->size = 0;
+    buffer->capacity = capacity;
+    buffer->Chars()[0] = '\0';
+    return buffer;
+}
+
+void PooledString::ReleaseBuffer(PooledStringBuffer* buffer) noexcept {
+    if (buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        const size_t bytes = sizeof(PooledStringBuffer) + buffer->capacity + 1;
+        buffer->~PooledStringBuffer();
+        FreeSaveJsonMemory(buffer, bytes);
+    }
+}
+
+// --- Construction and Assignment ---
+void PooledString::AssignChars(const char* s, size_type n) {
+    if (n <= INLINE_CAPACITY) {
+        char chars[INLINE_CAPACITY + 1];
+        memcpy(chars, s, n); // s may point into this string's own buffer.
+        Release();
+        memcpy(m_inline, chars, n);
+        m_inlineSize = 0;
+        SetSize(n);
+        return;
+    }
+    if (StringInternPool* pool = StringInternPool::Current()) {
+        AdoptBuffer(pool->Intern(s, n));
+        return;
+    }
+    if (!IsInline() && IsUnique() && m_buffer->capacity >= n) {
+        memmove(m_buffer->Chars(), s, n);
+        SetSize(n);
+        return;
+    }
+    PooledStringBuffer* buffer = AllocateBuffer(n);
+    memcpy(buffer->Chars(), s, n);
+    buffer->size = n;
+    buffer->Chars()[n] = '\0';
+    AdoptBuffer(buffer);
+}
+
+void PooledString::CopyFrom(const PooledString& other) {
+    if (other.IsInline()) {
+        memcpy(m_inline, other.m_inline, sizeof(m_inline));
+        m_inlineSize = other.m_inlineSize;
+        return;
+    }
+    PooledStringBuffer* source = other.m_buffer;
+    if (!source->shareable || source->capacity != source->size) {
+        // A string still being built, such as the parser's token buffer: copy what it holds so far,
+        // inline if it fits.
+        AssignChars(source->Chars(), source->size);
+    } else if (StringInternPool* pool = StringInternPool::Current()) {
+        AdoptBuffer(pool->Share(source));
+    } else {
+        source->refs.fetch_add(1, std::memory_order_relaxed);
+        AdoptBuffer(source);
+    }
+}
+
+// --- Copy-on-Write ---
+char* PooledString::PrepareWrite(size_type n) {
+    const size_type current = size();
+    if (IsInline()) {
+        if (n <= INLINE_CAPACITY) {
+            return m_inline;
+        }
+        PooledStringBuffer* buffer = AllocateBuffer(std::max<size_type>(n, INLINE_CAPACITY * 2 + 1));
+        memcpy(buffer->Chars(), m_inline, current + 1);
+        buffer->size = current;
+        m_buffer = buffer;
+        m_inlineSize = HEAP_MARKER;
+        return buffer->Chars();
+    }
+    const bool unique = IsUnique();
+    if (unique && m_buffer->capacity >= n) {
+        return m_buffer->Chars();
+    }
+    // A unique buffer is growing, so double it; a shared one is being edited, which rarely changes
+    // its length, so copy it at the size asked for.
+    const size_type capacity = unique ? std::max(n, m_buffer->capacity * 2) : std::max(n, current);
+    PooledStringBuffer* buffer = AllocateBuffer(capacity);
+    memcpy(buffer->Chars(), m_buffer->Chars(), current + 1);
+    buffer->size = current;
+    AdoptBuffer(buffer);
+    return buffer->Chars();
+}
+
+char* PooledString::MutableChars() {
+    char* chars = PrepareWrite(size());
+    if (!IsInline()) {
+        m_buffer->shareable = false;
+    }
+    return chars;
+}
+
+// --- Modification ---
+const char& PooledString::at(size_type i) const {
+    if (i >= size()) {
+        throw std::out_of_range("PooledString::at");
+    }
+    return data()[i];
+}
+
+char& PooledString::at(size_type i) {
+    if (i >= size()) {
+        throw std::out_of_range("PooledString::at");
+    }
+    return MutableChars()[i];
+}
+
+void PooledString::reserve(size_type n) {
+    if (n > capacity()) {
+        PrepareWrite(n);
+    }
+}
+
+void PooledString::resize(size_type n, char c) {
+    const size_type current = size();
+    char* chars = PrepareWrite(n);
+    if (n > current) {
+        memset(chars + current, c, n - current);
+    }
+    SetSize(n);
+}
+
+void PooledString::clear() noexcept {
+    if (!IsInline() && !IsUnique()) {
+        // Another string still reads this buffer; let it keep it rather than copy it just to empty it.
+        Release();
+        m_inlineSize = 0;
+    }
+    SetSize(0);
+}
+
+PooledString& PooledString::append(const char* s, size_type n) {
+    const size_type current = size();
+    const char* chars = data();
+    if (s >= chars && s < chars + current) {
+        // Appending part of this string to itself; growing could free s first.
+        const std::string copy(s, n);
+        return append(copy.data(), copy.size());
+    }
+    memcpy(PrepareWrite(current + n) + current, s, n);
+    SetSize(current + n);
+    return *this;
+}
+
+PooledString& PooledString::append(size_type n, char c) {
+    const size_type current = size();
+    memset(PrepareWrite(current + n) + current, c, n);
+    SetSize(current + n);
+    return *this;
+}
+
+PooledString& PooledString::Splice(size_type pos, size_type count, const char* s, size_type n) {
+    const size_type current = size();
+    if (pos > current) {
+        throw std::out_of_range("PooledString: position out of range");
+    }
+    count = std::min(count, current - pos);
+    const char* chars = data();
+    if (n > 0 && s >= chars && s < chars + current) {
+        const std::string copy(s, n);
+        return Splice(pos, count, copy.data(), copy.size());
+    }
+    const size_type new_size = current - count + n;
+    char* target = PrepareWrite(std::max(new_size, current));
+    memmove(target + pos + n, target + pos + count, current - pos - count);
+    memcpy(target + pos, s, n);
+    SetSize(new_size);
+    return *this;
+}
+
+PooledString PooledString::substr(size_type pos, size_type n) const {
+    const std::string_view part = view().substr(pos, n);
+    return PooledString(part.data(), part.size());
+}
+
+std::ostream& operator<<(std::ostream& out, const PooledString& s) {
+    return out << s.view();
+}
+
+// --- Interning ---
+StringInternPool::~StringInternPool() {
+    Clear();
+}
+
+void StringInternPool::Clear() {
+    for (const Slot& slot : m_slots) {
+        if (slot.buffer) {
+            PooledString::ReleaseBuffer(slot.buffer);
+        }
+    }
+    // The table keeps its size, so the next document of the same shape fills it without regrowing.
+    std::fill(m_slots.begin(), m_slots.end(), Slot{ 0, NULL });
+    m_count = 0;
+    m_bytes = 0;
+}
+
+void StringInternPool::Swap(StringInternPool& other) noexcept {
+    m_slots.swap(other.m_slots);
+    std::swap(m_count, other.m_count);
+    std::swap(m_bytes, other.m_bytes);
+}
+
+StringInternPool* StringInternPool::Current() {
+    return g_currentInternPool;
+}
+
+PooledStringBuffer* StringInternPool::Find(size_t hash, const char* chars, size_t size) const {
+    if (m_slots.empty()) {
+        return NULL;
+    }
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask; m_slots[i].buffer; i = (i + 1) & mask) {
+        const Slot& slot = m_slots[i];
+        if (slot.hash == hash && slot.buffer->size == size && memcmp(slot.buffer->Chars(), chars, size) == 0) {
+            return slot.buffer;
+        }
+    }
+    return NULL;
+}
+
+void StringInternPool::Insert(size_t hash, PooledStringBuffer* buffer) {
+    // Kept at most half full, so probes stay short.
+    if ((m_count + 1) * 2 > m_slots.size()) {
+        std::vector<Slot> old_slots;
+        old_slots.swap(m_slots);
+        m_slots.assign(std::max<size_t>(64, old_slots.size() * 2), Slot{ 0, NULL });
+        const size_t mask = m_slots.size() - 1;
+        for (const Slot& slot : old_slots) {
+            if (slot.buffer) {
+                size_t i = slot.hash & mask;
+                while (m_slots[i].buffer) {
+                    i = (i + 1) & mask;
+                }
+                m_slots[i] = slot;
+            }
+        }
+    }
+    const size_t mask = m_slots.size() - 1;
+    size_t i = hash & mask;
+    while (m_slots[i].buffer) {
+        i = (i + 1) & mask;
+    }
+    m_slots[i] = Slot{ hash, buffer };
+    ++m_count;
+    m_bytes += buffer->size;
+}
+
+PooledStringBuffer* StringInternPool::Intern(const char* chars, size_t size) {
+    const size_t hash = std::hash<std::string_view>()(std::string_view(chars, size));
+    PooledStringBuffer* buffer = Find(hash, chars, size);
+    if (!buffer) {
+        buffer = PooledString::AllocateBuffer(size);
+        memcpy(buffer->Chars(), chars, size);
+        buffer->size = size;
+        buffer->Chars()[size] = '\0';
+        Insert(hash, buffer); // The allocation's reference becomes the pool's.
+    }
+    buffer->refs.fetch_add(1, std::memory_order_relaxed);
+    return buffer;
+}
+
+PooledStringBuffer* StringInternPool::Share(PooledStringBuffer* buffer) {
+    const size_t hash = std::hash<std::string_view>()(std::string_view(buffer->Chars(), buffer->size));
+    PooledStringBuffer* found = Find(hash, buffer->Chars(), buffer->size);
+    if (!found) {
+        // Adopt the caller's buffer instead of copying it: one reference for the pool.
+        buffer->refs.fetch_add(1, std::memory_order_relaxed);
+        Insert(hash, buffer);
+        found = buffer;
+    }
+    found->refs.fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+ScopedStringInterning::ScopedStringInterning(StringInternPool& pool) : m_previous(g_currentInternPool) {
+    g_currentInternPool = &pool;
+}
+
+ScopedStringInterning::~ScopedStringInterning() {
+    g_currentInternPool = m_previous;
+}
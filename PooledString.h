@@ -0,0 +1,390 @@
+// PooledString.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>       // For std::hash
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Heap storage for a PooledString longer than its inline buffer. The characters follow the header in
+// the same allocation. Copies of a string share one buffer and count their references in it.
+struct PooledStringBuffer {
+    std::atomic<uint32_t> refs;
+    bool shareable;     // Cleared once a mutable pointer into the characters has been handed out.
+    size_t size;
+    size_t capacity;    // Not counting the terminating NUL.
+
+    char* Chars() { return reinterpret_cast<char*>(this + 1); }
+    const char* Chars() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+// Set of heap buffers with distinct contents. While a pool is installed on a thread with
+// ScopedStringInterning, every long PooledString built or copied on that thread first looks for an
+// equal buffer here and shares it, so a value a save repeats thousands of times (the gain timestamps
+// of every ingredient, keys such as "lastGainGameTime") is held once.
+// The pool keeps a reference to each buffer until it is cleared or destroyed, so interned strings
+// outlive the values that used them. Not thread-safe: a pool belongs to one document and is used by
+// one thread at a time. The buffers themselves may still be shared with copies on other threads.
+class StringInternPool {
+public:
+    StringInternPool() = default;
+    ~StringInternPool();
+    StringInternPool(const StringInternPool&) = delete;
+    StringInternPool& operator=(const StringInternPool&) = delete;
+
+    // Drops the pool's references. Strings still using a buffer keep it alive.
+    void Clear();
+    // Exchanges contents with other, e.g. when a document parsed with one pool moves to another owner.
+    void Swap(StringInternPool& other) noexcept;
+    size_t GetCount() const { return m_count; }
+    // Characters held by the pool's buffers, each counted once however many strings share it.
+    size_t GetBytes() const { return m_bytes; }
+
+    // The pool installed on the calling thread, or NULL when interning is off.
+    static StringInternPool* Current();
+
+private:
+    friend class PooledString;
+    friend class ScopedStringInterning;
+
+    struct Slot {
+        size_t hash;
+        PooledStringBuffer* buffer;
+    };
+
+    // Both return a buffer with a reference added for the caller.
+    PooledStringBuffer* Intern(const char* chars, size_t size);
+    PooledStringBuffer* Share(PooledStringBuffer* buffer);
+
+    PooledStringBuffer* Find(size_t hash, const char* chars, size_t size) const;
+    void Insert(size_t hash, PooledStringBuffer* buffer);
+
+    std::vector<Slot> m_slots;
+    size_t m_count = 0;
+    size_t m_bytes = 0;
+};
+
+// Installs a pool on the calling thread for the lifetime of the scope. Scopes nest; the previous pool
+// is restored on exit.
+class ScopedStringInterning {
+public:
+    explicit ScopedStringInterning(StringInternPool& pool);
+    ~ScopedStringInterning();
+    ScopedStringInterning(const ScopedStringInterning&) = delete;
+    ScopedStringInterning& operator=(const ScopedStringInterning&) = delete;
+
+private:
+    StringInternPool* m_previous;
+};
+
+// String type for SaveJson values and keys. A drop-in for the parts of std::string that nlohmann::json
+// and this codebase use.
+// Strings of up to INLINE_CAPACITY characters live inside the object. Longer strings live in a
+// refcounted PooledStringBuffer that copies share, and any modification copies the buffer first if
+// another string still uses it (copy-on-write), so an edit never shows through to a copy. Handing out
+// a mutable pointer or reference (non-const data(), operator[] or begin()) marks the buffer unshareable,
+// as with the old copy-on-write std::string, so a later copy cannot alias a pointer already in use.
+// Only buffers sized exactly to their contents are shared; a string that is still being built (the
+// parser's token buffer) is copied, as std::string would be.
+class PooledString {
+public:
+    using value_type = char;
+    using traits_type = std::char_traits<char>;
+    using allocator_type = std::allocator<char>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = char&;
+    using const_reference = const char&;
+    using pointer = char*;
+    using const_pointer = const char*;
+    using iterator = char*;
+    using const_iterator = const char*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static const size_type npos = static_cast<size_type>(-1);
+    static const size_type INLINE_CAPACITY = 15;
+
+    PooledString() noexcept : m_inlineSize(0) { m_inline[0] = '\0'; }
+    PooledString(const char* s) : PooledString() { AssignChars(s, traits_type::length(s)); }
+    PooledString(const char* s, size_type n) : PooledString() { AssignChars(s, n); }
+    PooledString(size_type n, char c) : PooledString() { append(n, c); }
+    PooledString(const std::string& s) : PooledString() { AssignChars(s.data(), s.size()); }
+    explicit PooledString(std::string_view s) : PooledString() { AssignChars(s.data(), s.size()); }
+    PooledString(std::initializer_list<char> chars) : PooledString() { AssignChars(chars.begin(), chars.size()); }
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    PooledString(It first, It last) : PooledString() { append(first, last); }
+    PooledString(const PooledString& other) : PooledString() { CopyFrom(other); }
+    PooledString(PooledString&& other) noexcept { Steal(other); }
+    ~PooledString() { Release(); }
+
+    PooledString& operator=(const PooledString& other) {
+        if (this != &other) {
+            PooledString copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    PooledString& operator=(PooledString&& other) noexcept {
+        if (this != &other) {
+            Release();
+            Steal(other);
+        }
+        return *this;
+    }
+    PooledString& operator=(const char* s) { return assign(s); }
+    PooledString& operator=(const std::string& s) { return assign(s.data(), s.size()); }
+    PooledString& operator=(std::string_view s) { return assign(s.data(), s.size()); }
+    PooledString& operator=(char c) { return assign(1, c); }
+
+    PooledString& assign(const char* s, size_type n) { AssignChars(s, n); return *this; }
+    PooledString& assign(const char* s) { return assign(s, traits_type::length(s)); }
+    PooledString& assign(size_type n, char c) { clear(); return append(n, c); }
+    PooledString& assign(const PooledString& s) { return *this = s; }
+    PooledString& assign(const std::string& s) { return assign(s.data(), s.size()); }
+    PooledString& assign(std::string_view s) { return assign(s.data(), s.size()); }
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    PooledString& assign(It first, It last) { clear(); return append(first, last); }
+
+    // --- Access ---
+    const char* data() const noexcept { return IsInline() ? m_inline : m_buffer->Chars(); }
+    char* data() { return MutableChars(); }
+    const char* c_str() const noexcept { return data(); }
+    size_type size() const noexcept { return IsInline() ? m_inlineSize : m_buffer->size; }
+    size_type length() const noexcept { return size(); }
+    bool empty() const noexcept { return size() == 0; }
+    size_type capacity() const noexcept { return IsInline() ? INLINE_CAPACITY : m_buffer->capacity; }
+    size_type max_size() const noexcept { return static_cast<size_type>(PTRDIFF_MAX) - sizeof(PooledStringBuffer) - 1; }
+    allocator_type get_allocator() const noexcept { return allocator_type(); }
+
+    const char& operator[](size_type i) const noexcept { return data()[i]; }
+    char& operator[](size_type i) { return MutableChars()[i]; }
+    const char& at(size_type i) const;
+    char& at(size_type i);
+    const char& front() const noexcept { return data()[0]; }
+    const char& back() const noexcept { return data()[size() - 1]; }
+    char& front() { return MutableChars()[0]; }
+    char& back() { return MutableChars()[size() - 1]; }
+
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    iterator begin() { return MutableChars(); }
+    iterator end() { return MutableChars() + size(); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    operator std::string_view() const noexcept { return std::string_view(data(), size()); }
+    operator std::string() const { return std::string(data(), size()); }
+
+    // --- Modification ---
+    void reserve(size_type n);
+    void resize(size_type n, char c = '\0');
+    void shrink_to_fit() {}
+    void clear() noexcept;
+    void push_back(char c) {
+        const size_type n = size();
+        char* chars = (IsInline() && n < INLINE_CAPACITY) ? m_inline : PrepareWrite(n + 1);
+        chars[n] = c;
+        SetSize(n + 1);
+    }
+    void pop_back() { resize(size() - 1); }
+
+    PooledString& append(const char* s, size_type n);
+    PooledString& append(const char* s) { return append(s, traits_type::length(s)); }
+    PooledString& append(size_type n, char c);
+    PooledString& append(const PooledString& s) { return append(s.data(), s.size()); }
+    PooledString& append(const std::string& s) { return append(s.data(), s.size()); }
+    PooledString& append(std::string_view s) { return append(s.data(), s.size()); }
+    template <class It, class = typename std::iterator_traits<It>::iterator_category>
+    PooledString& append(It first, It last) {
+        for (; first != last; ++first) {
+            push_back(static_cast<char>(*first));
+        }
+        return *this;
+    }
+
+    PooledString& operator+=(char c) { push_back(c); return *this; }
+    PooledString& operator+=(const char* s) { return append(s); }
+    PooledString& operator+=(const PooledString& s) { return append(s); }
+    PooledString& operator+=(const std::string& s) { return append(s); }
+    PooledString& operator+=(std::string_view s) { return append(s); }
+
+    PooledString& insert(size_type pos, const char* s, size_type n) { return Splice(pos, 0, s, n); }
+    PooledString& insert(size_type pos, const char* s) { return insert(pos, s, traits_type::length(s)); }
+    PooledString& insert(size_type pos, const PooledString& s) { return insert(pos, s.data(), s.size()); }
+    PooledString& insert(size_type pos, size_type n, char c) { return Splice(pos, 0, std::string(n, c).data(), n); }
+    PooledString& erase(size_type pos = 0, size_type n = npos) { return Splice(pos, n, "", 0); }
+    PooledString& replace(size_type pos, size_type n, const char* s, size_type len) { return Splice(pos, n, s, len); }
+    PooledString& replace(size_type pos, size_type n, const char* s) { return Splice(pos, n, s, traits_type::length(s)); }
+    PooledString& replace(size_type pos, size_type n, const PooledString& s) { return Splice(pos, n, s.data(), s.size()); }
+    PooledString& replace(size_type pos, size_type n, std::string_view s) { return Splice(pos, n, s.data(), s.size()); }
+
+    void swap(PooledString& other) noexcept {
+        char storage[sizeof(m_inline)];
+        std::memcpy(storage, m_inline, sizeof(m_inline));
+        std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+        std::memcpy(other.m_inline, storage, sizeof(m_inline));
+        std::swap(m_inlineSize, other.m_inlineSize);
+    }
+
+    // --- Search ---
+    std::string_view view() const noexcept { return std::string_view(data(), size()); }
+    PooledString substr(size_type pos = 0, size_type n = npos) const;
+    size_type copy(char* dest, size_type n, size_type pos = 0) const { return view().copy(dest, n, pos); }
+    int compare(std::string_view s) const noexcept { return view().compare(s); }
+    int compare(const PooledString& s) const noexcept { return view().compare(s.view()); }
+    int compare(const char* s) const noexcept { return view().compare(s); }
+    int compare(size_type pos, size_type n, std::string_view s) const { return view().substr(pos, n).compare(s); }
+    size_type find(std::string_view s, size_type pos = 0) const noexcept { return view().find(s, pos); }
+    size_type find(const char* s, size_type pos = 0) const noexcept { return view().find(s, pos); }
+    size_type find(const char* s, size_type pos, size_type n) const noexcept { return view().find(s, pos, n); }
+    size_type find(char c, size_type pos = 0) const noexcept { return view().find(c, pos); }
+    size_type rfind(std::string_view s, size_type pos = npos) const noexcept { return view().rfind(s, pos); }
+    size_type rfind(const char* s, size_type pos = npos) const noexcept { return view().rfind(s, pos); }
+    size_type rfind(char c, size_type pos = npos) const noexcept { return view().rfind(c, pos); }
+    size_type find_first_of(std::string_view s, size_type pos = 0) const noexcept { return view().find_first_of(s, pos); }
+    size_type find_first_of(const char* s, size_type pos = 0) const noexcept { return view().find_first_of(s, pos); }
+    size_type find_first_of(char c, size_type pos = 0) const noexcept { return view().find_first_of(c, pos); }
+    size_type find_last_of(std::string_view s, size_type pos = npos) const noexcept { return view().find_last_of(s, pos); }
+    size_type find_last_of(const char* s, size_type pos = npos) const noexcept { return view().find_last_of(s, pos); }
+    size_type find_last_of(char c, size_type pos = npos) const noexcept { return view().find_last_of(c, pos); }
+    size_type find_first_not_of(std::string_view s, size_type pos = 0) const noexcept { return view().find_first_not_of(s, pos); }
+    size_type find_first_not_of(const char* s, size_type pos = 0) const noexcept { return view().find_first_not_of(s, pos); }
+    size_type find_first_not_of(char c, size_type pos = 0) const noexcept { return view().find_first_not_of(c, pos); }
+
+    // True when the characters live in a heap buffer that another string also uses.
+    bool IsShared() const noexcept { return !IsInline() && m_buffer->refs.load(std::memory_order_acquire) > 1; }
+
+private:
+    static const uint8_t HEAP_MARKER = 0xFF;
+
+    bool IsInline() const noexcept { return m_inlineSize != HEAP_MARKER; }
+    bool IsUnique() const noexcept { return m_buffer->refs.load(std::memory_order_acquire) == 1; }
+    void SetSize(size_type n) noexcept {
+        if (IsInline()) {
+            m_inlineSize = static_cast<uint8_t>(n);
+            m_inline[n] = '\0';
+        } else {
+            m_buffer->size = n;
+            m_buffer->Chars()[n] = '\0';
+        }
+    }
+    void Steal(PooledString& other) noexcept {
+        std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+        m_inlineSize = other.m_inlineSize;
+        other.m_inlineSize = 0;
+        other.m_inline[0] = '\0';
+    }
+    void Release() noexcept {
+        if (!IsInline()) {
+            ReleaseBuffer(m_buffer);
+        }
+    }
+    void AdoptBuffer(PooledStringBuffer* buffer) noexcept {
+        Release();
+        m_buffer = buffer;
+        m_inlineSize = HEAP_MARKER;
+    }
+
+    void AssignChars(const char* s, size_type n);
+    void CopyFrom(const PooledString& other);
+    // Makes the storage this string's alone with room for n characters, keeping the current contents.
+    char* PrepareWrite(size_type n);
+    char* MutableChars();
+    PooledString& Splice(size_type pos, size_type count, const char* s, size_type n);
+
+    static PooledStringBuffer* AllocateBuffer(size_type capacity);
+    static void ReleaseBuffer(PooledStringBuffer* buffer) noexcept;
+
+    union {
+        char m_inline[INLINE_CAPACITY + 1];
+        PooledStringBuffer* m_buffer;
+    };
+    uint8_t m_inlineSize;   // Length of an inline string, or HEAP_MARKER when m_buffer is in use.
+
+    friend class StringInternPool;
+};
+
+// --- Comparison ---
+// Every pairing with the other string types compares views, so none of them builds a temporary string.
+#define POOLED_STRING_COMPARISONS(op) \
+    inline bool operator op(const PooledString& a, const PooledString& b) noexcept { return a.view() op b.view(); } \
+    inline bool operator op(const PooledString& a, const char* b) noexcept { return a.view() op std::string_view(b); } \
+    inline bool operator op(const char* a, const PooledString& b) noexcept { return std::string_view(a) op b.view(); } \
+    inline bool operator op(const PooledString& a, const std::string& b) noexcept { return a.view() op std::string_view(b); } \
+    inline bool operator op(const std::string& a, const PooledString& b) noexcept { return std::string_view(a) op b.view(); } \
+    inline bool operator op(const PooledString& a, std::string_view b) noexcept { return a.view() op b; } \
+    inline bool operator op(std::string_view a, const PooledString& b) noexcept { return a op b.view(); }
+POOLED_STRING_COMPARISONS(==)
+POOLED_STRING_COMPARISONS(!=)
+POOLED_STRING_COMPARISONS(<)
+POOLED_STRING_COMPARISONS(<=)
+POOLED_STRING_COMPARISONS(>)
+POOLED_STRING_COMPARISONS(>=)
+#undef POOLED_STRING_COMPARISONS
+
+// --- Concatenation ---
+// Results are std::string: concatenation builds log messages and paths, not save values.
+inline std::string operator+(const PooledString& a, const PooledString& b) { return std::string(a.view()).append(b.view()); }
+inline std::string operator+(const PooledString& a, const std::string& b) { return std::string(a.view()).append(b); }
+inline std::string operator+(const std::string& a, const PooledString& b) { return std::string(a).append(b.view()); }
+inline std::string operator+(const PooledString& a, const char* b) { return std::string(a.view()).append(b); }
+inline std::string operator+(const char* a, const PooledString& b) { return std::string(a).append(b.view()); }
+inline std::string operator+(const PooledString& a, char b) { return std::string(a.view()).append(1, b); }
+inline std::string operator+(char a, const PooledString& b) { return std::string(1, a).append(b.view()); }
+
+std::ostream& operator<<(std::ostream& out, const PooledString& s);
+
+inline void swap(PooledString& a, PooledString& b) noexcept {
+    a.swap(b);
+}
+
+namespace std {
+template <>
+struct hash<PooledString> {
+    size_t operator()(const PooledString& s) const noexcept { return hash<string_view>()(s.view()); }
+};
+}
@@ -0,0 +1,405 @@
+// ReferenceDatabase.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "ReferenceDatabase.h"
+#include <algorithm>            // For std::binary_search, std::set_difference
+#include <cctype>               // For isalnum, toupper
+#include <cstdio>               // For snprintf
+#include <fstream>              // For writing generated catalog versions
+#include <iterator>             // For std::inserter
+#include <map>                  // For diffing catalog tables by TID
+#include <set>                  // For collecting the IDs a catalog version adds
+#include <vector>               // For std::vector
+#include "zlib.h"               // For crc32
+#include "ZlibUtil.h"           // For decompressing the embedded SQL dump
+#include "embedded_sql.h"       // Contains compressed binary SQL data for the reference database.
+#include "embedded_catalog_versions.h" // Compressed deltas for other game builds.
+#include "Logger.h"             // For LogMessage
+#include "StartupProfiler.h"    // For ScopedStartupPhase
+
+// Estimated maximum size of the decompressed embedded SQL dump; at least the actual size, so the
+// dump inflates in one call into a buffer allocated once.
+const size_t MAX_UNCOMPRESSED_SQL_SIZE = 150000;
+
+// Inflates a zlib stream embedded in the executable into out_text. expectedSize sizes the output
+// buffer; larger outputs grow it. Failures are logged.
+static bool InflateEmbedded(const unsigned char* data, size_t size, size_t expectedSize, std::string& out_text) {
+    std::string error;
+    if (!ZlibDecompress(data, size, expectedSize, out_text, error)) {
+        LogMessage(LOG_ERROR_LEVEL, error.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Opens an in-memory SQLite database and populates it from compressed SQL data.
+sqlite3* ReferenceDatabase::Open(std::string& out_error) {
+    out_error.clear();
+    sqlite3* db = NULL;
+
+    int rc;
+    {
+        ScopedStartupPhase phase("Open in-memory database");
+        rc = sqlite3_open(":memory:", &db);
+    }
+    if (rc != SQLITE_OK) {
+        LogMessage(LOG_ERROR_LEVEL, (std::string("Cannot open in-memory reference database: ") + sqlite3_errmsg(db)).c_str());
+        out_error = "Failed to open reference database! Application might not function correctly.";
+        Close(db);
+        return NULL;
+    }
+    LogMessage(LOG_INFO_LEVEL, "In-memory reference database opened successfully.");
+
+    // Decompress the embedded SQL data using zlib.
+    std::string decompressed_sql_str;
+    {
+        ScopedStartupPhase phase("Inflate embedded SQL");
+        if (!InflateEmbedded(embedded_sql_compressed, embedded_sql_compressed_size, MAX_UNCOMPRESSED_SQL_SIZE, decompressed_sql_str)) {
+            out_error = "Failed to decompress SQL data!";
+            Close(db);
+            return NULL;
+        }
+    }
+    const size_t decompressed_size = decompressed_sql_str.size();
+    LogMessage(LOG_INFO_LEVEL, (std::string("SQL data decompressed successfully. Original size: ") + std::to_string(decompressed_size) + " bytes.").c_str());
+
+    // Execute the decompressed SQL statements to populate the in-memory database.
+    {
+        ScopedStartupPhase phase("Execute embedded SQL");
+        rc = sqlite3_exec(db, decompressed_sql_str.c_str(), 0, 0, 0);
+    }
+    if (rc != SQLITE_OK) {
+        LogMessage(LOG_ERROR_LEVEL, (std::string("Failed to execute embedded SQL dump for reference DB: ") + sqlite3_errmsg(db)).c_str());
+        out_error = "Failed to populate reference database from embedded SQL!";
+        Close(db);
+        return NULL;
+    }
+    LogMessage(LOG_INFO_LEVEL, "Reference database populated from embedded SQL successfully.");
+    return db;
+}
+
+uint32_t ReferenceDatabase::EmbeddedSourceChecksum() {
+    static const uint32_t checksum = static_cast<uint32_t>(crc32(0L, embedded_sql_compressed, static_cast<uInt>(embedded_sql_compressed_size)));
+    return checksum;
+}
+
+uint32_t ReferenceDatabase::EmbeddedSourceSize() {
+    return static_cast<uint32_t>(embedded_sql_compressed_size);
+}
+
+// --- Catalog Versions ---
+size_t ReferenceDatabase::GetCatalogVersionCount() {
+    return embedded_catalog_version_count;
+}
+
+const char* ReferenceDatabase::GetCatalogVersionName(size_t version) {
+    return version < embedded_catalog_version_count ? embedded_catalog_versions[version].name : NULL;
+}
+
+// The applied version is kept in the database's user_version, which a fresh database has at 0.
+size_t ReferenceDatabase::GetCatalogVersion(sqlite3* db) {
+    size_t version = 0;
+    sqlite3_stmt* stmt = NULL;
+    if (db && sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            version = static_cast<size_t>(sqlite3_column_int(stmt, 0));
+        }
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+// How many of ids a version's sorted ID list knows.
+static size_t CountKnownItems(const EmbeddedCatalogVersion& entry, const std::vector<int32_t>& ids) {
+    size_t known = 0;
+    for (int32_t id : ids) {
+        if (std::binary_search(entry.addedIds, entry.addedIds + entry.addedIdCount, id)) {
+            known++;
+        }
+    }
+    return known;
+}
+
+// Inflates a version's delta and runs it, with version recorded in user_version, on db holding the base.
+static bool ApplyCatalogDelta(sqlite3* db, const EmbeddedCatalogVersion& entry, size_t version, std::string& out_error) {
+    std::string delta_sql;
+    if (!InflateEmbedded(entry.delta, entry.deltaSize, entry.sqlSize, delta_sql)) {
+        out_error = std::string("Failed to decompress reference catalog version ") + entry.name + ".";
+        return false;
+    }
+    const size_t sql_size = delta_sql.size();
+    delta_sql = "BEGIN;\n" + delta_sql + "\nPRAGMA user_version = " + std::to_string(version) + ";\nCOMMIT;";
+    if (sqlite3_exec(db, delta_sql.c_str(), 0, 0, 0) != SQLITE_OK) {
+        out_error = std::string("Failed to apply reference catalog version ") + entry.name + ": " + sqlite3_errmsg(db);
+        sqlite3_exec(db, "ROLLBACK;", 0, 0, 0);
+        return false;
+    }
+    LogMessage(LOG_INFO_LEVEL, (std::string("Reference catalog version ") + entry.name + " applied (" +
+               std::to_string(entry.deltaSize) + " compressed bytes, " + std::to_string(sql_size) + " bytes of SQL).").c_str());
+    return true;
+}
+
+size_t ReferenceDatabase::FindCatalogVersionForItems(const std::vector<int32_t>& ids, size_t& out_known) {
+    size_t best_version = 0;
+    out_known = 0;
+    for (size_t version = 1; version < embedded_catalog_version_count; ++version) {
+        size_t known = CountKnownItems(embedded_catalog_versions[version], ids);
+        if (known > 0 && known >= out_known) {
+            best_version = version;
+            out_known = known;
+        }
+    }
+    return best_version;
+}
+
+bool ReferenceDatabase::ApplyCatalogVersion(sqlite3*& db, size_t version, std::string& out_error) {
+    out_error.clear();
+    if (version >= embedded_catalog_version_count) {
+        out_error = "Unknown reference catalog version " + std::to_string(version) + ".";
+        return false;
+    }
+    if (db && GetCatalogVersion(db) == version) {
+        return true;
+    }
+    // Deltas apply to the base only; start over from it if another version was applied.
+    if (!db || GetCatalogVersion(db) != 0) {
+        Close(db);
+        db = Open(out_error);
+        if (!db) {
+            return false;
+        }
+    }
+    if (version == 0) {
+        return true;
+    }
+    return ApplyCatalogDelta(db, embedded_catalog_versions[version], version, out_error);
+}
+
+// --- Catalog Version Generation ---
+// Tables a catalog version may change. The migration tables describe the database, not the game data.
+static const char* const CATALOG_TABLES[] = { "Ingredients", "Items" };
+
+// Reads a table's rows keyed by rowid (the TID), each as the value list an INSERT takes.
+static bool ReadCatalogTable(sqlite3* db, const char* table, std::vector<std::string>& out_columns,
+                             std::map<int64_t, std::string>& out_rows, std::string& out_error) {
+    out_columns.clear();
+    out_rows.clear();
+    sqlite3_stmt* stmt = NULL;
+    std::string sql = std::string("PRAGMA table_info(\"") + table + "\");";
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            out_columns.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (out_columns.empty()) {
+        out_error = std::string("The database has no table ") + table + ".";
+        return false;
+    }
+
+    // quote() renders each value as an SQL literal, so equal rows compare equal as text.
+    sql = "SELECT rowid, ";
+    for (size_t i = 0; i < out_columns.size(); ++i) {
+        sql += (i > 0 ? " || ',' || quote(\"" : "quote(\"") + out_columns[i] + "\")";
+    }
+    sql += std::string(" FROM \"") + table + "\";";
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK) {
+        out_error = std::string("Could not read table ") + table + ": " + sqlite3_errmsg(db);
+        return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        out_rows[sqlite3_column_int64(stmt, 0)] = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    }
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+// Reads the TIDs and ItemDataIDs of the Items table.
+static void ReadItemIds(sqlite3* db, std::set<int32_t>& out_tids, std::set<int32_t>& out_data_ids) {
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(db, "SELECT TID, ItemDataID FROM Items;", -1, &stmt, NULL) == SQLITE_OK) {
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            out_tids.insert(sqlite3_column_int(stmt, 0));
+            out_data_ids.insert(sqlite3_column_int(stmt, 1));
+        }
+    }
+    sqlite3_finalize(stmt);
+}
+
+bool ReferenceDatabase::GenerateCatalogVersion(const std::string& dumpSql, const std::string& outPath, std::string& out_error) {
+    out_error.clear();
+    sqlite3* base = Open(out_error);
+    if (!base) {
+        return false;
+    }
+    sqlite3* build = NULL;
+    if (sqlite3_open(":memory:", &build) != SQLITE_OK || sqlite3_exec(build, dumpSql.c_str(), 0, 0, 0) != SQLITE_OK) {
+        out_error = std::string("Could not build the database from the SQL dump: ") + sqlite3_errmsg(build);
+        Close(build);
+        Close(base);
+        return false;
+    }
+
+    // The version is named after the build's newest migration, which the embedded versions must not have yet.
+    std::string name;
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(build, "SELECT MigrationId FROM \"__EFMigrationsHistory\" ORDER BY MigrationId DESC LIMIT 1;", -1, &stmt, NULL) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    bool ok = true;
+    if (name.empty()) {
+        out_error = "The SQL dump has no migration history to name the version after.";
+        ok = false;
+    }
+    for (size_t version = 0; ok && version < embedded_catalog_version_count; ++version) {
+        if (name == embedded_catalog_versions[version].name) {
+            out_error = "Catalog version " + name + " is already embedded.";
+            ok = false;
+        }
+    }
+
+    // Diff each table by TID: rows added or changed are replaced whole, rows removed are deleted.
+    std::string delta_sql;
+    std::vector<std::string> base_columns, build_columns;
+    std::map<int64_t, std::string> base_rows, build_rows;
+    for (size_t t = 0; ok && t < sizeof(CATALOG_TABLES) / sizeof(CATALOG_TABLES[0]); ++t) {
+        const std::string table = CATALOG_TABLES[t];
+        ok = ReadCatalogTable(base, table.c_str(), base_columns, base_rows, out_error) &&
+             ReadCatalogTable(build, table.c_str(), build_columns, build_rows, out_error);
+        if (ok && base_columns != build_columns) {
+            out_error = "The columns of " + table + " differ from the base; a delta cannot change the schema.";
+            ok = false;
+        }
+        for (auto row = build_rows.begin(); ok && row != build_rows.end(); ++row) {
+            auto base_row = base_rows.find(row->first);
+            if (base_row == base_rows.end() || base_row->second != row->second) {
+                delta_sql += "INSERT OR REPLACE INTO \"" + table + "\" VALUES(" + row->second + ");\n";
+            }
+        }
+        for (auto row = base_rows.begin(); ok && row != base_rows.end(); ++row) {
+            if (build_rows.count(row->first) == 0) {
+                delta_sql += "DELETE FROM \"" + table + "\" WHERE rowid = " + std::to_string(row->first) + ";\n";
+            }
+        }
+    }
+
+    // The IDs a save from the build may use that the base lacks.
+    std::set<int32_t> base_tids, base_data_ids, build_tids, build_data_ids;
+    ReadItemIds(base, base_tids, base_data_ids);
+    ReadItemIds(build, build_tids, build_data_ids);
+    std::set<int32_t> added_set;
+    std::set_difference(build_tids.begin(), build_tids.end(), base_tids.begin(), base_tids.end(), std::inserter(added_set, added_set.end()));
+    std::set_difference(build_data_ids.begin(), build_data_ids.end(), base_data_ids.begin(), base_data_ids.end(), std::inserter(added_set, added_set.end()));
+    std::vector<int32_t> added_ids(added_set.begin(), added_set.end());
+
+    std::vector<unsigned char> delta;
+    if (ok && delta_sql.empty()) {
+        out_error = "The SQL dump holds the same items as the base catalog.";
+        ok = false;
+    }
+    ok = ok && ZlibCompress(delta_sql.data(), delta_sql.size(), delta, out_error, Z_BEST_COMPRESSION);
+
+    // Round trip: the entry, as it will be embedded, must turn a fresh base into the build and be found
+    // for the IDs it adds.
+    EmbeddedCatalogVersion entry = { name.c_str(), delta.data(), delta.size(), delta_sql.size(), added_ids.data(), added_ids.size() };
+    if (ok) {
+        Close(base);
+        base = Open(out_error);
+        ok = base && ApplyCatalogDelta(base, entry, embedded_catalog_version_count, out_error);
+    }
+    for (size_t t = 0; ok && t < sizeof(CATALOG_TABLES) / sizeof(CATALOG_TABLES[0]); ++t) {
+        ok = ReadCatalogTable(base, CATALOG_TABLES[t], base_columns, base_rows, out_error) &&
+             ReadCatalogTable(build, CATALOG_TABLES[t], build_columns, build_rows, out_error);
+        if (ok && base_rows != build_rows) {
+            out_error = std::string("Applying the generated delta does not reproduce table ") + CATALOG_TABLES[t] + ".";
+            ok = false;
+        }
+    }
+    if (ok && CountKnownItems(entry, added_ids) != added_ids.size()) {
+        out_error = "The generated ID list does not find the IDs it adds.";
+        ok = false;
+    }
+    Close(build);
+    Close(base);
+    if (!ok) {
+        return false;
+    }
+
+    // Write the definitions to include in embedded_catalog_versions.h.
+    std::string identifier;
+    for (char c : name) {
+        identifier += isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    std::string guard = "EMBEDDED_CATALOG_" + identifier + "_H";
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](char c) { return static_cast<char>(toupper(static_cast<unsigned char>(c))); });
+    std::string text = "// This file was procedurally generated by DaveSaveEd -export-catalog-version -- DO NOT EDIT MANUALLY!!!\n"
+        "// Reference catalog version " + name + ". Include it in embedded_catalog_versions.h and append\n"
+        "// catalog_version_" + identifier + " to embedded_catalog_versions.\n\n"
+        "#ifndef " + guard + "\n#define " + guard + "\n\n"
+        "const unsigned char catalog_delta_" + identifier + "[] = {";
+    char hex[8];
+    for (size_t i = 0; i < delta.size(); ++i) {
+        snprintf(hex, sizeof(hex), "0x%02x,", delta[i]);
+        text += (i % 16 == 0 ? "\n    " : " ") + std::string(hex);
+    }
+    text += "\n};\n";
+    std::string ids_name = "NULL";
+    if (!added_ids.empty()) {
+        ids_name = "catalog_added_ids_" + identifier;
+        text += "const int32_t " + ids_name + "[] = {";
+        for (size_t i = 0; i < added_ids.size(); ++i) {
+            text += (i % 8 == 0 ? "\n    " : " ") + std::to_string(added_ids[i]) + ",";
+        }
+        text += "\n};\n";
+    }
+    text += "constexpr EmbeddedCatalogVersion catalog_version_" + identifier + " = {\n"
+        "    \"" + name + "\", catalog_delta_" + identifier + ", sizeof(catalog_delta_" + identifier + "), " + std::to_string(delta_sql.size()) +
+        ", " + ids_name + ", " + std::to_string(added_ids.size()) + "\n};\n\n#endif // " + guard + "\n";
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+        out_error = "Could not write catalog version: " + outPath;
+        return false;
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Catalog version " + name + ": " + std::to_string(delta_sql.size()) + " bytes of SQL (" +
+               std::to_string(delta.size()) + " compressed), " + std::to_string(added_ids.size()) + " added ID(s); written to " + outPath + ".").c_str());
+    return true;
+}
+
+// Closes the reference database and clears the caller's handle.
+void ReferenceDatabase::Close(sqlite3*& db) {
+    if (db) {
+        sqlite3_close(db);
+        db = NULL;
+    }
+}
@@ -0,0 +1,82 @@
+// ReferenceDatabase.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "sqlite3.h"        // For SQLite database operations
+
+// The ReferenceDatabase class builds the in-memory SQLite reference database (items, ingredients, etc.)
+// from the compressed SQL dump embedded in embedded_sql.h.
+class ReferenceDatabase {
+public:
+    // Opens an in-memory SQLite database and populates it from the embedded compressed SQL data.
+    // Parameters:
+    //   out_error: Receives a user-facing description of the failure, if any.
+    // Returns the open database handle on success, or NULL on failure.
+    static sqlite3* Open(std::string& out_error);
+
+    // Closes the database (if open) and resets the handle to NULL.
+    static void Close(sqlite3*& db);
+
+    // CRC-32 and size of the compressed payload in embedded_sql.h. Data derived from the reference
+    // database (such as item catalog files) records these to detect when it has gone stale.
+    static uint32_t EmbeddedSourceChecksum();
+    static uint32_t EmbeddedSourceSize();
+
+    // Catalog Versions
+    // Besides the base catalog, the executable embeds one compressed delta per other game build
+    // (embedded_catalog_versions.h). Open always builds the base, version 0; a delta is only inflated
+    // when ApplyCatalogVersion is asked for its version, so startup time and memory do not grow with
+    // the number of embedded versions.
+    static size_t GetCatalogVersionCount();
+    // Name of a version (the game build's database migration), or NULL if version is out of range.
+    static const char* GetCatalogVersionName(size_t version);
+    // Version db currently holds.
+    static size_t GetCatalogVersion(sqlite3* db);
+    // Picks the version that knows the most of ids (item TIDs or ItemDataIDs missing from the base),
+    // preferring newer versions on ties, using only the uncompressed ID lists. Returns 0 (the base)
+    // if no version knows any of them. out_known receives how many of ids the chosen version knows.
+    static size_t FindCatalogVersionForItems(const std::vector<int32_t>& ids, size_t& out_known);
+    // Makes db hold version: reopens the base if db holds another delta, then inflates the version's
+    // delta and runs it in one transaction. db may be replaced; on failure it is left holding the base
+    // (or NULL if even that failed) and out_error is set.
+    static bool ApplyCatalogVersion(sqlite3*& db, size_t version, std::string& out_error);
+    // Generates the embedded_catalog_versions.h entry for another game build from a SQL dump of that
+    // build's whole reference database (as embedded_sql.h holds the base's). The dump is diffed against
+    // the base table by table, by TID; the entry holds the compressed delta script and the sorted IDs the
+    // build adds, and is named after the build's newest migration. Before outPath is written, the entry
+    // is applied to a fresh base exactly as ApplyCatalogVersion would, and must reproduce the dump's
+    // tables row for row.
+    static bool GenerateCatalogVersion(const std::string& dumpSql, const std::string& outPath, std::string& out_error);
+};
@@ -0,0 +1,317 @@
+// SamplingProfiler.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SamplingProfiler.h"
+#include <windows.h>            // For SuspendThread, GetThreadContext, RtlVirtualUnwind
+#include <dbghelp.h>            // For SymInitialize, SymFromAddr
+#include <mmsystem.h>           // For timeBeginPeriod, timeEndPeriod
+#include <atomic>               // For std::atomic
+#include <chrono>               // For the sampling interval
+#include <condition_variable>   // For waking the sampler to stop
+#include <cstdint>
+#include <cstdio>               // For snprintf
+#include <cstring>              // For strrchr
+#include <fstream>              // For std::ofstream
+#include <map>                  // For std::map
+#include <mutex>                // For std::mutex
+#include <thread>               // For std::thread
+#include <unordered_map>        // For std::unordered_map
+#include <vector>               // For std::vector
+#include "Logger.h"             // For LogMessage
+
+// A thread being sampled.
+struct ProfiledThread {
+    DWORD id;
+    HANDLE handle;          // Duplicated with suspend and get-context access.
+    size_t nameIndex;       // Into s_threadNames.
+};
+
+// A distinct stack: the sampled thread's name and its return addresses, leaf first.
+struct ProfiledStack {
+    size_t nameIndex;
+    std::vector<uint64_t> frames;
+
+    bool operator<(const ProfiledStack& other) const {
+        return nameIndex != other.nameIndex ? nameIndex < other.nameIndex : frames < other.frames;
+    }
+};
+
+static std::mutex s_mutex;                          // Guards the thread lists and the sample counts.
+static std::vector<ProfiledThread> s_threads;
+static std::vector<std::string> s_threadNames;      // Kept after threads unregister, for the output.
+static std::map<ProfiledStack, uint64_t> s_stacks;  // Samples per distinct stack.
+static uint64_t s_sampleCount = 0;
+static uint64_t s_droppedCount = 0;                 // Samples lost to threads that could not be suspended or walked.
+static std::atomic<bool> s_running(false);
+static bool s_stopRequested = false;                // Guarded by s_mutex.
+static std::condition_variable s_stopSignal;
+static std::thread s_sampler;
+static std::ofstream s_output;
+static std::string s_outputPath;
+static unsigned s_intervalMs = DEFAULT_PROFILE_INTERVAL_MS;
+
+// --- Sampling ---
+
+// Walks a suspended thread's stack into frames, leaf first, and returns the depth. Uses only the
+// context and the unwind tables already mapped with each module, so it never allocates.
+static size_t CaptureStack(HANDLE thread, uint64_t* frames, size_t maxDepth) {
+#if defined(_M_X64)
+    CONTEXT context;
+    ZeroMemory(&context, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+    if (!GetThreadContext(thread, &context)) {
+        return 0;
+    }
+    size_t depth = 0;
+    while (depth < maxDepth && context.Rip != 0) {
+        frames[depth++] = context.Rip;
+        DWORD64 image_base = 0;
+        PRUNTIME_FUNCTION function = RtlLookupFunctionEntry(context.Rip, &image_base, NULL);
+        DWORD64 previous_sp = context.Rsp;
+        if (function) {
+            void* handler_data = NULL;
+            DWORD64 establisher_frame = 0;
+            RtlVirtualUnwind(UNW_FLAG_NHANDLER, image_base, context.Rip, function, &context, &handler_data, &establisher_frame, NULL);
+        } else {
+            // A leaf function has no unwind data; its return address is on top of the stack.
+            context.Rip = *reinterpret_cast<const DWORD64*>(context.Rsp);
+            context.Rsp += sizeof(DWORD64);
+        }
+        if (context.Rsp <= previous_sp) {
+            break; // The stack must unwind upwards; anything else is a damaged frame.
+        }
+    }
+    return depth;
+#elif defined(_M_IX86)
+    // 32-bit builds may omit frame pointers, so only the current instruction is recorded.
+    CONTEXT context;
+    ZeroMemory(&context, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL;
+    if (maxDepth == 0 || !GetThreadContext(thread, &context)) {
+        return 0;
+    }
+    frames[0] = context.Eip;
+    return 1;
+#else
+    (void)thread;
+    (void)frames;
+    (void)maxDepth;
+    return 0;
+#endif
+}
+
+// Takes one sample of every registered thread.
+static void SampleThreads() {
+    uint64_t frames[MAX_PROFILE_STACK_DEPTH];
+    for (const ProfiledThread& thread : s_threads) {
+        if (SuspendThread(thread.handle) == static_cast<DWORD>(-1)) {
+            s_droppedCount++;
+            continue;
+        }
+        size_t depth = CaptureStack(thread.handle, frames, MAX_PROFILE_STACK_DEPTH);
+        ResumeThread(thread.handle);
+        // Only now, with the thread running again, is it safe to allocate.
+        if (depth == 0) {
+            s_droppedCount++;
+            continue;
+        }
+        ProfiledStack stack;
+        stack.nameIndex = thread.nameIndex;
+        stack.frames.assign(frames, frames + depth);
+        s_stacks[stack]++;
+        s_sampleCount++;
+    }
+}
+
+static void SamplerMain() {
+    timeBeginPeriod(1); // Sleep at millisecond rather than scheduler-tick resolution.
+    std::unique_lock<std::mutex> lock(s_mutex);
+    while (!s_stopSignal.wait_for(lock, std::chrono::milliseconds(s_intervalMs), [] { return s_stopRequested; })) {
+        SampleThreads();
+    }
+    timeEndPeriod(1);
+}
+
+// --- Control ---
+
+bool SamplingProfiler::Start(const std::string& outputPath, unsigned intervalMs) {
+    if (s_running) {
+        return false;
+    }
+    s_output.open(outputPath, std::ios::trunc);
+    if (!s_output) {
+        LogMessage(LOG_ERROR_LEVEL, ("Could not open profile output file: " + outputPath).c_str());
+        return false;
+    }
+    s_outputPath = outputPath;
+    s_intervalMs = intervalMs > 0 ? intervalMs : DEFAULT_PROFILE_INTERVAL_MS;
+    s_stacks.clear();
+    s_threadNames.clear();
+    s_sampleCount = 0;
+    s_droppedCount = 0;
+    s_stopRequested = false;
+    s_running = true;
+    RegisterCurrentThread("main");
+    s_sampler = std::thread(SamplerMain);
+    LogMessage(LOG_INFO_LEVEL, ("Sampling profiler started; writing folded stacks to " + outputPath + ".").c_str());
+    return true;
+}
+
+bool SamplingProfiler::IsRunning() {
+    return s_running;
+}
+
+void SamplingProfiler::RegisterCurrentThread(const char* name) {
+    if (!s_running) {
+        return;
+    }
+    HANDLE handle = NULL;
+    if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle,
+                         THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, 0)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    size_t name_index = 0;
+    while (name_index < s_threadNames.size() && s_threadNames[name_index] != name) {
+        name_index++;
+    }
+    if (name_index == s_threadNames.size()) {
+        s_threadNames.push_back(name);
+    }
+    s_threads.push_back({ GetCurrentThreadId(), handle, name_index });
+}
+
+void SamplingProfiler::UnregisterCurrentThread() {
+    DWORD id = GetCurrentThreadId();
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (size_t i = 0; i < s_threads.size(); ++i) {
+        if (s_threads[i].id == id) {
+            CloseHandle(s_threads[i].handle);
+            s_threads.erase(s_threads.begin() + i);
+            return;
+        }
+    }
+}
+
+// Names the function containing address for a folded stack: the symbol if DbgHelp has one, otherwise
+// module+offset. Semicolons separate frames in the output, so they are replaced.
+static std::string DescribeAddress(HANDLE process, bool haveSymbols, uint64_t address) {
+    std::string name;
+    if (haveSymbols) {
+        alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+        SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+        ZeroMemory(buffer, sizeof(buffer));
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = MAX_SYM_NAME;
+        DWORD64 displacement = 0;
+        if (SymFromAddr(process, address, &displacement, symbol)) {
+            name.assign(symbol->Name, symbol->NameLen);
+        }
+    }
+    if (name.empty()) {
+        HMODULE module = NULL;
+        char module_path[MAX_PATH] = "?";
+        if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                               reinterpret_cast<LPCSTR>(static_cast<uintptr_t>(address)), &module)) {
+            GetModuleFileNameA(module, module_path, MAX_PATH);
+        }
+        const char* module_name = strrchr(module_path, '\\');
+        module_name = module_name ? module_name + 1 : module_path;
+        char offset[32];
+        snprintf(offset, sizeof(offset), "+0x%llx", static_cast<unsigned long long>(address - reinterpret_cast<uintptr_t>(module)));
+        name = std::string(module_name) + offset;
+    }
+    for (char& c : name) {
+        if (c == ';') {
+            c = ':';
+        }
+    }
+    return name;
+}
+
+void SamplingProfiler::Stop() {
+    if (!s_running) {
+        return;
+    }
+    s_running = false;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_stopRequested = true;
+    }
+    s_stopSignal.notify_all();
+    s_sampler.join();
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (const ProfiledThread& thread : s_threads) {
+            CloseHandle(thread.handle);
+        }
+        s_threads.clear();
+    }
+
+    // Resolve every distinct address once. Return addresses point after their call, so the address
+    // before is looked up to land in the calling function. Stacks that resolve to the same functions
+    // then merge.
+    HANDLE process = GetCurrentProcess();
+    SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+    bool have_symbols = SymInitialize(process, NULL, TRUE) != FALSE;
+    std::unordered_map<uint64_t, std::string> names;
+    std::map<std::string, uint64_t> folded;
+    for (const auto& entry : s_stacks) {
+        const std::vector<uint64_t>& frames = entry.first.frames;
+        std::string line = s_threadNames[entry.first.nameIndex];
+        for (size_t i = frames.size(); i-- > 0;) {
+            uint64_t address = i == 0 ? frames[i] : frames[i] - 1;
+            auto it = names.find(address);
+            if (it == names.end()) {
+                it = names.emplace(address, DescribeAddress(process, have_symbols, address)).first;
+            }
+            line += ';';
+            line += it->second;
+        }
+        folded[line] += entry.second;
+    }
+    if (have_symbols) {
+        SymCleanup(process);
+    }
+    for (const auto& entry : folded) {
+        s_output << entry.first << ' ' << entry.second << '\n';
+    }
+    s_output.close();
+
+    char summary[256];
+    snprintf(summary, sizeof(summary), "Profile: %llu sample(s) (%llu dropped), %zu distinct stack(s) written to %s.",
+             static_cast<unsigned long long>(s_sampleCount), static_cast<unsigned long long>(s_droppedCount), folded.size(), s_outputPath.c_str());
+    LogMessage(LOG_INFO_LEVEL, summary);
+    if (!have_symbols) {
+        LogMessage(LOG_WARNING_LEVEL, "Profile: symbols could not be loaded; frames are written as module+offset.");
+    }
+    s_stacks.clear();
+}
@@ -0,0 +1,77 @@
+// SamplingProfiler.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+
+// Default time between stack samples when running with -profile.
+const unsigned DEFAULT_PROFILE_INTERVAL_MS = 1;
+// Frames kept per sample; deeper stacks are cut off at the root end.
+const size_t MAX_PROFILE_STACK_DEPTH = 64;
+
+// The SamplingProfiler class provides static methods for a built-in sampling profiler. While running, a
+// background thread wakes every interval, briefly suspends each registered thread, walks its stack from
+// the captured context using the unwind data in the executable, and counts identical stacks. Stopping
+// resolves the addresses to function names with DbgHelp and writes folded stacks ("thread;root;...;leaf
+// count", one per line) for flamegraph.pl and similar tools.
+// Nothing is allocated while a thread is suspended, so a thread stopped inside the heap cannot deadlock
+// the sampler. Function names need a build with debug information (/Zi and /DEBUG); without it frames are
+// written as module+offset.
+class SamplingProfiler {
+public:
+    // Starts sampling and registers the calling thread as "main". Returns false if already running or the
+    // output file cannot be created.
+    // Parameters:
+    //   outputPath: File the folded stacks are written to by Stop.
+    //   intervalMs: Milliseconds between samples.
+    static bool Start(const std::string& outputPath, unsigned intervalMs = DEFAULT_PROFILE_INTERVAL_MS);
+
+    // Stops sampling and writes the folded stacks. Does nothing if not running.
+    static void Stop();
+
+    static bool IsRunning();
+
+    // Adds the calling thread to the set being sampled, under a name that becomes the root frame of its
+    // stacks. Does nothing if the profiler is not running. Threads must unregister before they exit.
+    static void RegisterCurrentThread(const char* name);
+    static void UnregisterCurrentThread();
+};
+
+// Samples the constructing thread for the lifetime of the object, if the profiler is running. For
+// worker threads.
+class ScopedProfiledThread {
+public:
+    explicit ScopedProfiledThread(const char* name) { SamplingProfiler::RegisterCurrentThread(name); }
+    ~ScopedProfiledThread() { SamplingProfiler::UnregisterCurrentThread(); }
+    ScopedProfiledThread(const ScopedProfiledThread&) = delete;
+    ScopedProfiledThread& operator=(const ScopedProfiledThread&) = delete;
+};
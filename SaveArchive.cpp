@@ -0,0 +1,426 @@
+// SaveArchive.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveArchive.h"
+#include <windows.h>        // For CreateFileA, CreateFileMappingA, MapViewOfFile
+#include <cstring>          // For memchr, strlen
+#include <fstream>          // For std::ifstream
+#include "zlib.h"           // For crc32
+#include "ZlibUtil.h"       // For ZlibDecompress
+
+// --- Format constants ---
+
+const uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const uint32_t ZIP_END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+const size_t ZIP_END_OF_DIRECTORY_SIZE = 22;
+const size_t ZIP_MAX_COMMENT_SIZE = 0xFFFF;
+const uint16_t ZIP_FLAG_ENCRYPTED = 0x0001;
+const uint16_t ZIP_METHOD_STORED = 0;
+const uint16_t ZIP_METHOD_DEFLATE = 8;
+
+const unsigned char GZIP_MAGIC[2] = { 0x1f, 0x8b };
+const size_t GZIP_HEADER_SIZE = 10;
+const size_t GZIP_TRAILER_SIZE = 8;
+const unsigned char GZIP_FLAG_HCRC = 0x02;
+const unsigned char GZIP_FLAG_EXTRA = 0x04;
+const unsigned char GZIP_FLAG_NAME = 0x08;
+const unsigned char GZIP_FLAG_COMMENT = 0x10;
+
+// Archive formats store integers little-endian regardless of the host.
+static uint16_t ReadLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Returns true if name ends with suffix, ignoring ASCII case.
+static bool EndsWithNoCase(const std::string& name, const char* suffix) {
+    size_t suffix_len = strlen(suffix);
+    if (name.size() < suffix_len) {
+        return false;
+    }
+    return _strnicmp(name.c_str() + name.size() - suffix_len, suffix, suffix_len) == 0;
+}
+
+static bool HasArchiveExtension(const std::string& name) {
+    return EndsWithNoCase(name, ".zip") || EndsWithNoCase(name, ".gz") || EndsWithNoCase(name, ".gzip");
+}
+
+// --- SaveArchive ---
+
+SaveArchive::SaveArchive() : m_file(NULL), m_mapping(NULL), m_base(NULL), m_size(0), m_format(SAVE_ARCHIVE_NONE) {}
+
+SaveArchive::~SaveArchive() {
+    Close();
+}
+
+void SaveArchive::Close() {
+    if (m_base) {
+        UnmapViewOfFile(m_base);
+        m_base = NULL;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+        m_file = NULL;
+    }
+    m_size = 0;
+    m_format = SAVE_ARCHIVE_NONE;
+    m_path.clear();
+    m_members.clear();
+}
+
+SaveArchiveFormat SaveArchive::DetectFormat(const std::string& filepath) {
+    std::ifstream input(filepath, std::ios::binary);
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    if (!input.read(reinterpret_cast<char*>(magic), sizeof(magic))) {
+        return SAVE_ARCHIVE_NONE;
+    }
+    if (ReadLE32(magic) == ZIP_LOCAL_HEADER_SIGNATURE || ReadLE32(magic) == ZIP_END_OF_DIRECTORY_SIGNATURE) {
+        return SAVE_ARCHIVE_ZIP;
+    }
+    if (magic[0] == GZIP_MAGIC[0] && magic[1] == GZIP_MAGIC[1]) {
+        return SAVE_ARCHIVE_GZIP;
+    }
+    return SAVE_ARCHIVE_NONE;
+}
+
+bool SaveArchive::Open(const std::string& filepath, std::string& out_error) {
+    Close();
+    out_error.clear();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        out_error = "Could not open archive: " + filepath;
+        return false;
+    }
+    m_file = file;
+    LARGE_INTEGER size;
+    // An empty file cannot be mapped, and is not an archive anyway.
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < 4) {
+        out_error = "Archive is too small to be valid: " + filepath;
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m_mapping) {
+        out_error = "Could not map archive: " + filepath;
+        Close();
+        return false;
+    }
+    m_base = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_base) {
+        out_error = "Could not map a view of archive: " + filepath;
+        Close();
+        return false;
+    }
+
+    m_path = filepath;
+    bool parsed;
+    if (m_base[0] == GZIP_MAGIC[0] && m_base[1] == GZIP_MAGIC[1]) {
+        parsed = ParseGzip(out_error);
+    } else if (ReadLE32(m_base) == ZIP_LOCAL_HEADER_SIGNATURE || ReadLE32(m_base) == ZIP_END_OF_DIRECTORY_SIGNATURE) {
+        parsed = ParseZip(out_error);
+    } else {
+        out_error = "Not a zip or gzip file";
+        parsed = false;
+    }
+    if (!parsed) {
+        out_error += ": " + filepath;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+// Reads the zip central directory. Member data offsets are resolved through each local header here, so
+// ReadMember only has to inflate.
+bool SaveArchive::ParseZip(std::string& out_error) {
+    // The end-of-directory record sits at the end of the file, followed only by an optional comment.
+    if (m_size < ZIP_END_OF_DIRECTORY_SIZE) {
+        out_error = "Zip file is truncated";
+        return false;
+    }
+    uint64_t search_start = m_size > ZIP_END_OF_DIRECTORY_SIZE + ZIP_MAX_COMMENT_SIZE ? m_size - ZIP_END_OF_DIRECTORY_SIZE - ZIP_MAX_COMMENT_SIZE : 0;
+    const unsigned char* eocd = NULL;
+    for (uint64_t pos = m_size - ZIP_END_OF_DIRECTORY_SIZE + 1; pos-- > search_start;) {
+        if (ReadLE32(m_base + pos) == ZIP_END_OF_DIRECTORY_SIGNATURE &&
+            pos + ZIP_END_OF_DIRECTORY_SIZE + ReadLE16(m_base + pos + 20) == m_size) {
+            eocd = m_base + pos;
+            break;
+        }
+    }
+    if (!eocd) {
+        out_error = "Zip file has no end-of-directory record";
+        return false;
+    }
+    uint16_t disk = ReadLE16(eocd + 4);
+    uint16_t directory_disk = ReadLE16(eocd + 6);
+    uint16_t entry_count = ReadLE16(eocd + 10);
+    uint32_t directory_size = ReadLE32(eocd + 12);
+    uint32_t directory_offset = ReadLE32(eocd + 16);
+    if (disk != 0 || directory_disk != 0 || entry_count != ReadLE16(eocd + 8)) {
+        out_error = "Spanned zip archives are not supported";
+        return false;
+    }
+    if (entry_count == 0xFFFF || directory_size == 0xFFFFFFFF || directory_offset == 0xFFFFFFFF) {
+        out_error = "Zip64 archives are not supported";
+        return false;
+    }
+    if (static_cast<uint64_t>(directory_offset) + directory_size > static_cast<uint64_t>(eocd - m_base)) {
+        out_error = "Zip central directory lies outside the file";
+        return false;
+    }
+
+    m_members.reserve(entry_count);
+    uint64_t pos = directory_offset;
+    uint64_t directory_end = static_cast<uint64_t>(directory_offset) + directory_size;
+    for (uint16_t i = 0; i < entry_count; ++i) {
+        if (pos + ZIP_CENTRAL_HEADER_SIZE > directory_end || ReadLE32(m_base + pos) != ZIP_CENTRAL_HEADER_SIGNATURE) {
+            out_error = "Zip central directory is damaged";
+            return false;
+        }
+        const unsigned char* header = m_base + pos;
+        uint16_t flags = ReadLE16(header + 8);
+        uint16_t name_length = ReadLE16(header + 28);
+        uint64_t header_length = ZIP_CENTRAL_HEADER_SIZE + static_cast<uint64_t>(name_length) + ReadLE16(header + 30) + ReadLE16(header + 32);
+        if (pos + header_length > directory_end) {
+            out_error = "Zip central directory is damaged";
+            return false;
+        }
+        SaveArchiveMember member;
+        member.name.assign(reinterpret_cast<const char*>(header + ZIP_CENTRAL_HEADER_SIZE), name_length);
+        member.method = ReadLE16(header + 10);
+        member.crc = ReadLE32(header + 16);
+        member.compressedSize = ReadLE32(header + 20);
+        member.uncompressedSize = ReadLE32(header + 24);
+        uint32_t local_offset = ReadLE32(header + 42);
+        pos += header_length;
+
+        if (!member.name.empty() && member.name.back() == '/') {
+            continue; // A directory entry.
+        }
+        if (member.compressedSize == 0xFFFFFFFF || member.uncompressedSize == 0xFFFFFFFF || local_offset == 0xFFFFFFFF) {
+            out_error = "Zip64 archives are not supported";
+            return false;
+        }
+        if (flags & ZIP_FLAG_ENCRYPTED) {
+            out_error = "Encrypted zip member " + member.name + " is not supported";
+            return false;
+        }
+        // The local header repeats the name but may carry a different extra field, so its length is
+        // read from there.
+        if (static_cast<uint64_t>(local_offset) + ZIP_LOCAL_HEADER_SIZE > m_size || ReadLE32(m_base + local_offset) != ZIP_LOCAL_HEADER_SIGNATURE) {
+            out_error = "Zip local header for " + member.name + " is damaged";
+            return false;
+        }
+        const unsigned char* local = m_base + local_offset;
+        member.dataOffset = static_cast<uint64_t>(local_offset) + ZIP_LOCAL_HEADER_SIZE + ReadLE16(local + 26) + ReadLE16(local + 28);
+        if (member.dataOffset + member.compressedSize > m_size) {
+            out_error = "Zip member " + member.name + " lies outside the file";
+            return false;
+        }
+        m_members.push_back(member);
+    }
+    m_format = SAVE_ARCHIVE_ZIP;
+    return true;
+}
+
+// Reads a gzip header (RFC 1952). The file holds one member, named from the header's FNAME field if
+// present, else from the archive file name without its .gz extension.
+bool SaveArchive::ParseGzip(std::string& out_error) {
+    if (m_size < GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE || m_base[2] != Z_DEFLATED) {
+        out_error = "Gzip file is truncated or not deflate-compressed";
+        return false;
+    }
+    unsigned char flags = m_base[3];
+    uint64_t pos = GZIP_HEADER_SIZE;
+    uint64_t data_limit = m_size - GZIP_TRAILER_SIZE;
+    if (flags & GZIP_FLAG_EXTRA) {
+        if (pos + 2 > data_limit) {
+            out_error = "Gzip header is damaged";
+            return false;
+        }
+        pos += 2 + ReadLE16(m_base + pos);
+    }
+    std::string name;
+    for (unsigned char field : { GZIP_FLAG_NAME, GZIP_FLAG_COMMENT }) {
+        if (!(flags & field)) {
+            continue;
+        }
+        const void* end = pos < data_limit ? memchr(m_base + pos, '\0', static_cast<size_t>(data_limit - pos)) : NULL;
+        if (!end) {
+            out_error = "Gzip header is damaged";
+            return false;
+        }
+        uint64_t length = static_cast<const unsigned char*>(end) - (m_base + pos);
+        if (field == GZIP_FLAG_NAME) {
+            name.assign(reinterpret_cast<const char*>(m_base + pos), static_cast<size_t>(length));
+        }
+        pos += length + 1;
+    }
+    if (flags & GZIP_FLAG_HCRC) {
+        pos += 2;
+    }
+    if (pos > data_limit) {
+        out_error = "Gzip header is damaged";
+        return false;
+    }
+
+    if (name.empty()) {
+        std::string filename = m_path.substr(m_path.find_last_of("\\/") + 1);
+        name = filename.substr(0, filename.find_last_of('.'));
+    }
+    SaveArchiveMember member;
+    member.name = name;
+    member.method = ZIP_METHOD_DEFLATE;
+    member.dataOffset = pos;
+    member.compressedSize = data_limit - pos;
+    member.crc = ReadLE32(m_base + data_limit);
+    member.uncompressedSize = ReadLE32(m_base + data_limit + 4);
+    m_members.push_back(member);
+    m_format = SAVE_ARCHIVE_GZIP;
+    return true;
+}
+
+int SaveArchive::FindMember(const std::string& name) const {
+    if (name.empty()) {
+        // No name picks the archive's only save, so a single-save archive can be opened like a file.
+        int found = -1;
+        for (size_t i = 0; i < m_members.size(); ++i) {
+            if (m_members.size() == 1 || EndsWithNoCase(m_members[i].name, ".sav")) {
+                if (found >= 0) {
+                    return -1;
+                }
+                found = static_cast<int>(i);
+            }
+        }
+        return found;
+    }
+    for (size_t i = 0; i < m_members.size(); ++i) {
+        if (m_members[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool SaveArchive::ReadMember(size_t index, size_t maxBytes, std::string& out_bytes, std::string& out_error) const {
+    out_bytes.clear();
+    if (index >= m_members.size()) {
+        out_error = "Archive member index out of range";
+        return false;
+    }
+    const SaveArchiveMember& member = m_members[index];
+    const unsigned char* data = m_base + member.dataOffset;
+    // Zip records the exact size; gzip only records it modulo 2^32, which is still right below 4 GB.
+    if (member.uncompressedSize > maxBytes) {
+        out_error = "Archive member " + member.name + " is larger than the " + std::to_string(maxBytes) + " byte limit";
+        return false;
+    }
+    if (member.method == ZIP_METHOD_STORED) {
+        if (member.compressedSize != member.uncompressedSize) {
+            out_error = "Stored archive member " + member.name + " has inconsistent sizes";
+            return false;
+        }
+        out_bytes.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(member.compressedSize));
+    } else if (member.method == ZIP_METHOD_DEFLATE) {
+        // Presized from the recorded size, so a well-formed member inflates in a single call.
+        std::string inflate_error;
+        if (!ZlibDecompress(data, static_cast<size_t>(member.compressedSize), static_cast<size_t>(member.uncompressedSize),
+                            out_bytes, inflate_error, RAW_DEFLATE_WINDOW_BITS, maxBytes)) {
+            out_error = "Archive member " + member.name + ": " + inflate_error;
+            return false;
+        }
+    } else {
+        out_error = "Archive member " + member.name + " uses unsupported compression method " + std::to_string(member.method);
+        return false;
+    }
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(out_bytes.data()), static_cast<uInt>(out_bytes.size()));
+    if (crc != member.crc || (out_bytes.size() & 0xFFFFFFFFu) != (member.uncompressedSize & 0xFFFFFFFFu)) {
+        out_error = "Archive member " + member.name + " is damaged (checksum mismatch)";
+        out_bytes.clear();
+        return false;
+    }
+    return true;
+}
+
+// --- Archive paths ---
+
+bool SplitSaveArchivePath(const std::string& path, std::string& out_archive, std::string& out_member) {
+    out_archive.clear();
+    out_member.clear();
+    // Scan from the left so a '!' inside a member name stays part of the member.
+    for (size_t pos = path.find(SAVE_ARCHIVE_MEMBER_SEPARATOR); pos != std::string::npos; pos = path.find(SAVE_ARCHIVE_MEMBER_SEPARATOR, pos + 1)) {
+        std::string archive = path.substr(0, pos);
+        if (HasArchiveExtension(archive)) {
+            out_archive = archive;
+            out_member = path.substr(pos + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IsSaveArchivePath(const std::string& path) {
+    std::string archive, member;
+    return SplitSaveArchivePath(path, archive, member) || HasArchiveExtension(path);
+}
+
+bool ReadSaveArchivePath(const std::string& path, size_t maxBytes, std::string& out_bytes, std::string& out_error) {
+    out_bytes.clear();
+    std::string archive_path, member_name;
+    if (!SplitSaveArchivePath(path, archive_path, member_name)) {
+        archive_path = path;
+    }
+    SaveArchive archive;
+    if (!archive.Open(archive_path, out_error)) {
+        return false;
+    }
+    int index = archive.FindMember(member_name);
+    if (index < 0) {
+        out_error = member_name.empty() ? "Archive holds more than one save (or none); name one as archive.zip!member.sav: " + path
+                                        : "Archive has no member named " + member_name + ": " + archive_path;
+        return false;
+    }
+    return archive.ReadMember(static_cast<size_t>(index), maxBytes, out_bytes, out_error);
+}
@@ -0,0 +1,122 @@
+// SaveArchive.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Separates an archive path from the member inside it, as in "saves.zip!GameSave_00_GD.sav".
+const char SAVE_ARCHIVE_MEMBER_SEPARATOR = '!';
+
+// Container formats a save can be read out of.
+enum SaveArchiveFormat {
+    SAVE_ARCHIVE_NONE,  // Not an archive (or not one we can read).
+    SAVE_ARCHIVE_GZIP,  // A single gzip-compressed file, e.g. GameSave_00_GD.sav.gz.
+    SAVE_ARCHIVE_ZIP    // A zip file holding any number of members.
+};
+
+// One file inside an archive.
+struct SaveArchiveMember {
+    std::string name;           // Path of the member inside the archive.
+    uint16_t method;            // 0 = stored, 8 = deflate.
+    uint32_t crc;               // CRC-32 of the uncompressed bytes.
+    uint64_t dataOffset;        // Offset of the compressed bytes in the archive file.
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;  // For gzip, the ISIZE trailer (the size modulo 2^32).
+};
+
+// Read-only view of a zip or gzip archive. Opening maps the file and reads the zip central directory;
+// members are only inflated when read, straight into a buffer of their recorded size, so a save never
+// touches the disk uncompressed. ReadMember is const and keeps no state, so one open archive can be
+// shared by threads reading different members.
+class SaveArchive {
+public:
+    SaveArchive();
+    ~SaveArchive();
+
+    SaveArchive(const SaveArchive&) = delete;
+    SaveArchive& operator=(const SaveArchive&) = delete;
+
+    // Maps an archive and lists its members. Fails if the file is neither a zip nor a gzip file, uses
+    // zip features we do not read (zip64, encryption, spanning), or is damaged.
+    // Parameters:
+    //   filepath: Archive file to map.
+    //   out_error: Receives a description of the failure, if any.
+    bool Open(const std::string& filepath, std::string& out_error);
+    // Unmaps the archive, if open.
+    void Close();
+    bool IsOpen() const { return m_format != SAVE_ARCHIVE_NONE; }
+
+    SaveArchiveFormat GetFormat() const { return m_format; }
+    const std::string& GetPath() const { return m_path; }
+    const std::vector<SaveArchiveMember>& GetMembers() const { return m_members; }
+    // Returns the index of the member with this name, or -1 if there is none. An empty name matches the
+    // only member, or else the only .sav member, if there is exactly one.
+    int FindMember(const std::string& name) const;
+
+    // Inflates a member into out_bytes and checks its CRC. Fails rather than allocating past maxBytes.
+    // Parameters:
+    //   index: Member index, as in GetMembers.
+    //   maxBytes: Largest uncompressed size accepted.
+    //   out_bytes: Receives the uncompressed member.
+    //   out_error: Receives a description of the failure, if any.
+    bool ReadMember(size_t index, size_t maxBytes, std::string& out_bytes, std::string& out_error) const;
+
+    // Returns the format of a file from its first bytes, without opening it as an archive.
+    static SaveArchiveFormat DetectFormat(const std::string& filepath);
+
+private:
+    bool ParseZip(std::string& out_error);
+    bool ParseGzip(std::string& out_error);
+
+    void* m_file;                   // File handle, or NULL.
+    void* m_mapping;                // File mapping handle, or NULL.
+    const unsigned char* m_base;    // Start of the mapped view.
+    uint64_t m_size;                // Size of the mapped file.
+    SaveArchiveFormat m_format;     // SAVE_ARCHIVE_NONE unless open.
+    std::string m_path;
+    std::vector<SaveArchiveMember> m_members;
+};
+
+// Splits "archive!member" into its parts. Returns false (and leaves the outputs empty) if path names
+// no member, i.e. has no separator after a file name ending in .zip, .gz or .gzip.
+bool SplitSaveArchivePath(const std::string& path, std::string& out_archive, std::string& out_member);
+
+// Returns true if path should be read through SaveArchive: either "archive!member" or a file ending in
+// .zip, .gz or .gzip.
+bool IsSaveArchivePath(const std::string& path);
+
+// Reads the save a path names out of its archive: "saves.zip!GameSave_00_GD.sav", "save.sav.gz", or a
+// bare "saves.zip" holding a single save (see FindMember). Opens the archive for this one read; callers
+// reading many members should keep a SaveArchive open instead.
+bool ReadSaveArchivePath(const std::string& path, size_t maxBytes, std::string& out_bytes, std::string& out_error);
@@ -0,0 +1,526 @@
+// SaveBenchmark.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#define NOMINMAX // Prevent Windows.h from defining min/max macros
+
+#include "SaveBenchmark.h"
+#include <windows.h>            // For QueryPerformanceCounter
+#include <algorithm>            // For std::max
+#include <cstdio>               // For snprintf
+#include <filesystem>           // For std::filesystem::temp_directory_path
+#include <fstream>              // For std::ifstream
+#include <functional>           // For std::function
+#include <iterator>             // For std::istreambuf_iterator
+#include <numeric>              // For std::iota
+#include <vector>               // For std::vector
+#include "SaveJson.h"           // For SaveJson
+#include "Logger.h"             // For LogMessage
+#include "PerfCounters.h"       // For hardware performance counters
+#include "ReferenceDatabase.h"  // For the database used by the Max* passes
+#include "SaveCodec.h"          // For DetectSaveCodec, DecodeSaveBytes
+#include "SaveGameManager.h"    // For LoadSaveFromMemory and the Max* passes
+#include "InventoryImport.h"    // For JoinItemCounts
+#include "ParallelDeflate.h"    // For ParallelCompressZlib
+#include "ZlibUtil.h"           // For ZlibCompress, ZlibDecompress
+#include "SaveConsistencyCheck.h" // For SaveConsistencyChecker
+#include "SaveJsonWriter.h"     // For EncodeSaveJson
+#include "SaveSessionCache.h"   // For SaveSessionCache
+#include <thread>               // For std::thread::hardware_concurrency
+
+static double NowMilliseconds() {
+    static LARGE_INTEGER frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f;
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * 1000.0 / static_cast<double>(frequency.QuadPart);
+}
+
+// Counts every value in a document (objects, arrays and scalars), the "items" of whole-document benchmarks.
+static size_t CountJsonValues(const SaveJson& value) {
+    size_t count = 1;
+    if (value.is_structured()) {
+        for (const auto& child : value) {
+            count += CountJsonValues(child);
+        }
+    }
+    return count;
+}
+
+// Returns the number of entries in a top-level section of the loaded save, or 0 if it is missing.
+static size_t SectionSize(const SaveGameManager& manager, const char* section) {
+    const SaveJson& data = manager.GetSaveData();
+    auto it = data.find(section);
+    return (it != data.end() && it->is_structured()) ? it->size() : 0;
+}
+
+// Formats count / divisor for a report column, or "n/a" if there is nothing to divide by.
+static void FormatRatio(char* out, size_t out_size, double count, size_t divisor) {
+    if (divisor == 0) {
+        snprintf(out, out_size, "%10s", "n/a");
+    } else {
+        snprintf(out, out_size, "%10.2f", count / static_cast<double>(divisor));
+    }
+}
+
+// Runs one benchmark: prepare (untimed) then run (timed), iterations times, and reports the averages.
+// bytes and items are the input size per iteration; items may depend on the work done, so it is
+// evaluated after the last iteration.
+static void RunBenchmark(const char* name, int iterations, PerfCounters* counters, size_t bytes,
+                         const std::function<size_t()>& items_fn,
+                         const std::function<void()>& prepare, const std::function<void()>& run) {
+    double total_ms = 0.0;
+    if (counters) {
+        counters->Reset();
+    }
+    // The loader and the Max* passes log every step; keep only warnings and errors while timing.
+    bool info_enabled = Logger::IsInfoEnabled();
+    Logger::SetInfoEnabled(false);
+    for (int i = 0; i < iterations; ++i) {
+        prepare();
+        if (counters) {
+            counters->Start();
+        }
+        double start = NowMilliseconds();
+        run();
+        total_ms += NowMilliseconds() - start;
+        if (counters) {
+            counters->Stop();
+        }
+    }
+    Logger::SetInfoEnabled(info_enabled);
+    const size_t items = items_fn();
+
+    char line[256];
+    char per_byte[32];
+    char per_item[32];
+    const double ns_per_iteration = total_ms * 1.0e6 / iterations;
+    FormatRatio(per_byte, sizeof(per_byte), ns_per_iteration, bytes);
+    FormatRatio(per_item, sizeof(per_item), ns_per_iteration, items);
+    snprintf(line, sizeof(line), "  %-22s %10.3f ms/iter %10zu bytes %9zu items  ns/byte %s  ns/item %s",
+             name, total_ms / iterations, bytes, items, per_byte, per_item);
+    LogMessage(LOG_INFO_LEVEL, line);
+    if (!counters) {
+        return;
+    }
+    for (int e = 0; e < PERF_COUNTER_EVENT_COUNT; ++e) {
+        PerfCounterEvent event = static_cast<PerfCounterEvent>(e);
+        if (!counters->IsAvailable(event)) {
+            continue;
+        }
+        const double per_iteration = static_cast<double>(counters->GetCount(event)) / iterations;
+        FormatRatio(per_byte, sizeof(per_byte), per_iteration, bytes);
+        FormatRatio(per_item, sizeof(per_item), per_iteration, items);
+        snprintf(line, sizeof(line), "  %-22s %-14s %16.0f /iter  per byte %s  per item %s",
+                 "", GetPerfCounterName(event), per_iteration, per_byte, per_item);
+        LogMessage(LOG_INFO_LEVEL, line);
+    }
+}
+
+// Object sizes for the container benchmarks: a full Ingredients section after MaxAllIngredients (the
+// reference data has about 300 ingredients), then 10x and 100x that.
+static const size_t OBJECT_BENCHMARK_SIZES[] = { 300, 3000, 30000 };
+
+// Size of the generated input for the compression benchmarks, about that of a large backup or export.
+static const size_t DEFLATE_BENCHMARK_BYTES = 8 * 1024 * 1024;
+
+// Entries per section in the generated save for the consistency check benchmark.
+static const size_t CONSISTENCY_BENCHMARK_ENTRIES = 100000;
+
+// Rows in the generated count import file; far more than there are items, so most rows overwrite earlier ones.
+static const size_t IMPORT_BENCHMARK_ROWS = 100000;
+
+// Builds a count import file of IMPORT_BENCHMARK_ROWS rows over the stackable reference items,
+// alternating between naming items by TID and by ItemTextID. Returns an empty string if the items cannot be read.
+static std::string MakeImportBenchmarkCsv(sqlite3* db) {
+    std::vector<std::pair<int, std::string>> items;
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(db, "SELECT TID, ItemTextID FROM Items WHERE MaxCount > 1 ORDER BY TID;", -1, &stmt, NULL) != SQLITE_OK) {
+        return std::string();
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* text_id = sqlite3_column_text(stmt, 1);
+        items.emplace_back(sqlite3_column_int(stmt, 0), text_id ? reinterpret_cast<const char*>(text_id) : "");
+    }
+    sqlite3_finalize(stmt);
+    if (items.empty()) {
+        return std::string();
+    }
+
+    std::string csv = "Item,Count\n";
+    csv.reserve(IMPORT_BENCHMARK_ROWS * 32);
+    for (size_t row = 0; row < IMPORT_BENCHMARK_ROWS; ++row) {
+        const std::pair<int, std::string>& item = items[(row * 7) % items.size()];
+        if (row % 2 == 0 || item.second.empty()) {
+            csv += std::to_string(item.first);
+        } else {
+            csv += item.second;
+        }
+        csv += ',';
+        csv += std::to_string(row % 10 + 1);
+        csv += '\n';
+    }
+    return csv;
+}
+
+// Benchmarks bulk insert, lookup by key and iteration on an Ingredients-like object of the given size,
+// stored in Json's object container.
+template <typename Json>
+static void RunObjectBenchmarks(const char* container, size_t size, int iterations, PerfCounters* counters) {
+    // Keys are stringified ingredient IDs, as in the save; lookups visit them in a scrambled order.
+    std::vector<std::string> keys(size);
+    for (size_t i = 0; i < size; ++i) {
+        keys[i] = std::to_string(1020201 + i * 7);
+    }
+    std::vector<size_t> order(size);
+    std::iota(order.begin(), order.end(), static_cast<size_t>(0));
+    uint32_t state = 12345;
+    for (size_t i = size - 1; i > 0; --i) {
+        state = state * 1664525u + 1013904223u;
+        std::swap(order[i], order[state % (i + 1)]);
+    }
+    const Json entry = Json::parse(R"({"ingredientsID":1020201,"level":1,"parentID":0,"count":1,"branchCount":0,)"
+                                   R"("lastGainTime":"04/01/2025 12:34:56","lastGainGameTime":"10/03/2022 08:30:52","isNew":false,"placeTagMask":1})");
+    Json object = Json::object();
+    size_t found = 0;
+    long long total = 0;
+    auto items = [size] { return size; };
+    auto none = [] {};
+    char name[48];
+
+    snprintf(name, sizeof(name), "%s insert %zu", container, size);
+    RunBenchmark(name, iterations, counters, 0, items, [&] { object = Json::object(); }, [&] {
+        for (const std::string& key : keys) {
+            object[key] = entry;
+        }
+    });
+    snprintf(name, sizeof(name), "%s lookup %zu", container, size);
+    RunBenchmark(name, iterations, counters, 0, items, none, [&] {
+        for (size_t i : order) {
+            found += object.contains(keys[i]) ? 1 : 0;
+        }
+    });
+    snprintf(name, sizeof(name), "%s iterate %zu", container, size);
+    RunBenchmark(name, iterations, counters, 0, items, none, [&] {
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            total += it.value()["count"].template get<long long>();
+        }
+    });
+    if (found != size * iterations || total != static_cast<long long>(size) * iterations) {
+        LogMessage(LOG_ERROR_LEVEL, (std::string(container) + " object benchmark produced wrong results.").c_str());
+    }
+}
+
+int RunSaveBenchmark(const std::string& savePath, int iterations, bool hardwareCounters, const ItemCatalog* catalog) {
+    LogMessage(LOG_INFO_LEVEL, ("Benchmarking save file: " + savePath).c_str());
+
+    std::ifstream file(savePath, std::ios::binary);
+    if (!file) {
+        LogMessage(LOG_ERROR_LEVEL, ("Benchmark: could not open " + savePath).c_str());
+        return 1;
+    }
+    const std::string raw((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    SaveCodec codec;
+    if (!DetectSaveCodec(raw.data(), raw.size(), codec)) {
+        LogMessage(LOG_ERROR_LEVEL, "Benchmark: the save file's encoding was not recognized.");
+        return 1;
+    }
+    std::string text = raw;
+    DecodeSaveBytes(codec, text);
+    SaveJson document;
+    try {
+        document = SaveJson::parse(text);
+    } catch (const SaveJson::exception& e) {
+        LogMessage(LOG_ERROR_LEVEL, ("Benchmark: the save file does not parse: " + std::string(e.what())).c_str());
+        return 1;
+    }
+    const size_t value_count = CountJsonValues(document);
+
+    std::string db_error;
+    sqlite3* db = ReferenceDatabase::Open(db_error);
+    if (!db) {
+        LogMessage(LOG_ERROR_LEVEL, ("Benchmark: reference database failed to initialize: " + db_error).c_str());
+        return 1;
+    }
+
+    PerfCounters perf;
+    PerfCounters* counters = NULL;
+    if (hardwareCounters) {
+        // Missing counters are not an error (no PMU in a VM, restricted perf_event_paranoid, or a
+        // platform that only exposes cycles); the benchmarks still report wall-clock time.
+        std::string unavailable;
+        for (int e = 0; e < PERF_COUNTER_EVENT_COUNT; ++e) {
+            if (!perf.IsAvailable(static_cast<PerfCounterEvent>(e))) {
+                unavailable += unavailable.empty() ? "" : ", ";
+                unavailable += GetPerfCounterName(static_cast<PerfCounterEvent>(e));
+            }
+        }
+        LogMessage(LOG_INFO_LEVEL, (std::string("Hardware counters: ") + perf.GetBackendDescription() +
+                   (unavailable.empty() ? "" : "; unavailable: " + unavailable)).c_str());
+        counters = &perf;
+    }
+
+    char summary[160];
+    snprintf(summary, sizeof(summary), "%zu encoded bytes, %zu decoded bytes, %zu JSON values, encoding %s, %d iteration(s).",
+             raw.size(), text.size(), value_count, codec.Describe().c_str(), iterations);
+    LogMessage(LOG_INFO_LEVEL, summary);
+    LogMessage(LOG_INFO_LEVEL, catalog ? "Max passes use the item catalog." : "Max passes use the reference database.");
+
+    std::string buffer;
+    std::string output;
+    SaveJson parsed;
+    SaveGameManager manager;
+    manager.SetItemCatalog(catalog);
+    auto values = [&] { return value_count; };
+    auto none = [] {};
+    auto copy_raw = [&] { buffer = raw; };
+    auto fresh_save = [&] { buffer = raw; manager.LoadSaveFromMemory(buffer, savePath); };
+    bool ok = true;
+    auto report = [&](const char* name, size_t bytes, const std::function<size_t()>& items_fn,
+                      const std::function<void()>& prepare, const std::function<void()>& run) {
+        RunBenchmark(name, iterations, counters, bytes, items_fn, prepare, run);
+    };
+
+    report("Encoding detection", raw.size(), values, none, [&] {
+        SaveCodec detected;
+        DetectSaveCodec(raw.data(), raw.size(), detected);
+    });
+    if (codec.type == SAVE_CODEC_XOR) {
+        report("XOR decode", raw.size(), values, copy_raw, [&] { XorWithKey(&buffer[0], buffer.size(), codec.key); });
+    }
+    report("JSON parse", text.size(), values, none, [&] { parsed = SaveJson::parse(text); });
+    report("JSON serialize", text.size(), values, none, [&] { output = document.dump(); });
+    SaveCodec plain_json;
+    plain_json.type = SAVE_CODEC_PLAIN_JSON;
+    report("JSON serialize (SaveJsonWriter)", text.size(), values, none, [&] {
+        output.clear();
+        EncodeSaveJson(document, plain_json, output);
+    });
+    if (output != document.dump()) {
+        LogMessage(LOG_ERROR_LEVEL, "Benchmark: SaveJsonWriter output differs from SaveJson::dump().");
+        ok = false;
+    }
+    report("Serialize and encode", text.size(), values, none, [&] {
+        output.clear();
+        EncodeSaveJson(document, codec, output);
+    });
+    report("Full load", raw.size(), values, copy_raw, [&] {
+        if (!manager.LoadSaveFromMemory(buffer, savePath)) {
+            ok = false;
+        }
+    });
+
+    // Session snapshots: what evicting a session from a SaveSessionCache and bringing it back cost,
+    // next to the full load above.
+    std::vector<unsigned char> snapshot;
+    std::string snapshot_error;
+    report("Session snapshot", raw.size(), values, fresh_save, [&] {
+        if (!manager.WriteSessionSnapshot(snapshot, snapshot_error)) {
+            ok = false;
+        }
+    });
+    report("Session restore", snapshot.size(), values, none, [&] {
+        if (!manager.RestoreSessionSnapshot(snapshot, snapshot_error)) {
+            ok = false;
+        }
+    });
+    if (!snapshot_error.empty()) {
+        LogMessage(LOG_ERROR_LEVEL, ("Benchmark: session snapshot failed: " + snapshot_error).c_str());
+    }
+    snprintf(summary, sizeof(summary), "Session snapshot: %zu bytes for %zu encoded bytes.", snapshot.size(), raw.size());
+    LogMessage(LOG_INFO_LEVEL, summary);
+
+    // A session cache with room for two of four sessions, so cycling through them evicts and restores
+    // one on every request. Each session's gold is set apart to check the right one comes back.
+    {
+        std::error_code ec;
+        const std::filesystem::path cache_dir = std::filesystem::temp_directory_path(ec) / "DaveSaveEd_Benchmark";
+        SaveSessionCache cache(manager.EstimateMemoryUsage() * 2, cache_dir.string());
+        cache.SetSessionSetup([&](SaveGameManager& session) { session.SetItemCatalog(catalog); });
+        const size_t session_count = 4;
+        for (size_t i = 0; i < session_count; ++i) {
+            SaveGameManager* session = cache.Acquire("session" + std::to_string(i), savePath);
+            if (session == NULL) {
+                ok = false;
+                break;
+            }
+            session->SetGold(static_cast<long long>(i) + 1);
+        }
+        size_t next_session = 0;
+        if (ok) {
+            report("Session cache acquire", 0, [] { return static_cast<size_t>(1); }, none, [&] {
+                SaveGameManager* session = cache.Acquire("session" + std::to_string(next_session), savePath);
+                if (session == NULL || session->GetGold() != static_cast<long long>(next_session) + 1) {
+                    ok = false;
+                }
+                next_session = (next_session + 1) % session_count;
+            });
+        }
+        const SaveSessionCacheStats& stats = cache.GetStats();
+        snprintf(summary, sizeof(summary), "Session cache: %zu loads, %zu restores, %zu evictions; %zu of %zu sessions in memory.",
+                 stats.loads, stats.restores, stats.evictions, cache.GetResidentCount(), cache.GetSessionCount());
+        LogMessage(LOG_INFO_LEVEL, summary);
+        if (!ok) {
+            LogMessage(LOG_ERROR_LEVEL, "Benchmark: a session cache session failed to load or came back with the wrong data.");
+        }
+    }
+
+    report("MaxOwnIngredients", 0, [&] { return SectionSize(manager, "Ingredients"); }, fresh_save, [&] { manager.MaxOwnIngredients(db); });
+    report("MaxAllIngredients", 0, [&] { return SectionSize(manager, "Ingredients"); }, fresh_save, [&] { manager.MaxAllIngredients(db); });
+    report("MaxOwnMaterials", 0, [&] { return SectionSize(manager, "InventoryItemSlot"); }, fresh_save, [&] { manager.MaxOwnMaterials(db); });
+    report("MaxOwnStaffLevel", 0, [&] { return SectionSize(manager, "Staff"); }, fresh_save, [&] { manager.MaxOwnStaffLevel(); });
+    const SaveTimestamp gain_time = CurrentLocalTimestamp();
+    report("SetIngredientGainTimes", 0, [&] { return SectionSize(manager, "Ingredients"); }, fresh_save, [&] { manager.SetIngredientGainTimes(gain_time); });
+    SaveTimestamp latest;
+    latest.year = 9999;
+    latest.month = 12;
+    latest.day = 31;
+    size_t selected = 0;
+    report("SelectIngredientsByGainTime", 0, [&] { return SectionSize(manager, "Ingredients"); }, none, [&] {
+        selected = manager.SelectIngredientsByGainTime(SaveTimestamp(), latest).size();
+    });
+    if (selected != SectionSize(manager, "Ingredients")) {
+        LogMessage(LOG_ERROR_LEVEL, "Benchmark: SelectIngredientsByGainTime missed ingredients whose gain time was just set.");
+        ok = false;
+    }
+
+    // Count import: the hash join of a large CSV against the reference items, then applying the result.
+    const std::string import_csv = MakeImportBenchmarkCsv(db);
+    if (import_csv.empty()) {
+        LogMessage(LOG_WARNING_LEVEL, "Benchmark: no reference items to build the count import file from; skipping it.");
+    } else {
+        std::vector<ItemCountChange> changes;
+        ItemCountImportReport import_report;
+        std::string import_error;
+        ItemCountApplyResult apply_result;
+        report("Count import join", import_csv.size(), [] { return IMPORT_BENCHMARK_ROWS; }, none, [&] {
+            changes.clear();
+            import_report = ItemCountImportReport();
+            if (!JoinItemCounts(import_csv, catalog, db, NULL, changes, import_report, import_error)) {
+                ok = false;
+            }
+        });
+        report("Count import apply", 0, [&] { return changes.size(); }, fresh_save, [&] {
+            apply_result = ItemCountApplyResult();
+            manager.ApplyItemCounts(changes, apply_result);
+        });
+    }
+
+    // Consistency check of a save far larger than a real one, cycling through the reference items.
+    SaveConsistencyChecker checker;
+    std::string checker_error;
+    report("Consistency prepare", 0, [] { return static_cast<size_t>(1); }, none, [&] {
+        if (!checker.Prepare(catalog, db, checker_error)) {
+            ok = false;
+        }
+    });
+    if (checker.IsPrepared()) {
+        std::vector<std::pair<int, int>> items; // TID, ItemDataID
+        sqlite3_stmt* stmt = NULL;
+        if (sqlite3_prepare_v2(db, "SELECT TID, ItemDataID FROM Items ORDER BY TID;", -1, &stmt, NULL) == SQLITE_OK) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                items.emplace_back(sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1));
+            }
+        }
+        sqlite3_finalize(stmt);
+        SaveJson large_save = SaveJson::object();
+        SaveJson& ingredients = large_save["Ingredients"];
+        SaveJson& slots = large_save["InventoryItemSlot"];
+        for (size_t i = 0; i < CONSISTENCY_BENCHMARK_ENTRIES && !items.empty(); ++i) {
+            const std::pair<int, int>& item = items[i % items.size()];
+            const std::string key = std::to_string(i);
+            ingredients[key] = { {"ingredientsID", item.second}, {"parentID", item.first}, {"count", static_cast<int>(i % 100)} };
+            slots[key] = { {"itemID", item.first}, {"totalCount", static_cast<int>(i % 100)} };
+        }
+        SaveConsistencyReport consistency;
+        report("Consistency check", 0, [] { return CONSISTENCY_BENCHMARK_ENTRIES * 2; }, none, [&] { checker.Check(large_save, consistency); });
+    }
+
+    // Compression of a save-sized buffer, where per-call stream setup would dominate; streams come from the pool.
+    std::vector<unsigned char> save_compressed;
+    std::string save_inflated;
+    std::string zlib_error;
+    report("zlib compress save", text.size(), values, none, [&] {
+        if (!ZlibCompress(text.data(), text.size(), save_compressed, zlib_error)) {
+            ok = false;
+        }
+    });
+    report("zlib inflate save", text.size(), values, none, [&] {
+        if (!ZlibDecompress(save_compressed.data(), save_compressed.size(), text.size(), save_inflated, zlib_error) || save_inflated.size() != text.size()) {
+            ok = false;
+        }
+    });
+
+    // Compression: serial against block-parallel deflate, on copies of the reference database image.
+    sqlite3_int64 image_size = 0;
+    unsigned char* image = sqlite3_serialize(db, "main", &image_size, 0);
+    if (image && image_size > 0) {
+        std::string deflate_input;
+        deflate_input.reserve(DEFLATE_BENCHMARK_BYTES + static_cast<size_t>(image_size));
+        while (deflate_input.size() < DEFLATE_BENCHMARK_BYTES) {
+            deflate_input.append(reinterpret_cast<const char*>(image), static_cast<size_t>(image_size));
+        }
+        const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<unsigned char> compressed;
+        auto blocks = [&] { return (deflate_input.size() + PARALLEL_DEFLATE_BLOCK_SIZE - 1) / PARALLEL_DEFLATE_BLOCK_SIZE; };
+        report("Deflate 1 thread", deflate_input.size(), blocks, none, [&] { compressed = ParallelCompressZlib(deflate_input, Z_DEFAULT_COMPRESSION, 1); });
+        char deflate_name[48];
+        snprintf(deflate_name, sizeof(deflate_name), "Deflate %u threads", cores);
+        report(deflate_name, deflate_input.size(), blocks, none, [&] { compressed = ParallelCompressZlib(deflate_input, Z_DEFAULT_COMPRESSION, cores); });
+        // The parallel stream must inflate, with stock zlib, back to the input.
+        std::string inflated(deflate_input.size(), '\0');
+        uLongf inflated_size = static_cast<uLongf>(inflated.size());
+        if (uncompress(reinterpret_cast<Bytef*>(&inflated[0]), &inflated_size, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK ||
+            inflated_size != deflate_input.size() || inflated != deflate_input) {
+            LogMessage(LOG_ERROR_LEVEL, "Benchmark: the parallel deflate stream did not inflate back to its input.");
+            ok = false;
+        }
+    }
+    sqlite3_free(image);
+
+    // Save objects (SaveJson) against nlohmann::json's default std::map object storage.
+    for (size_t size : OBJECT_BENCHMARK_SIZES) {
+        RunObjectBenchmarks<nlohmann::json>("std::map", size, iterations, counters);
+        RunObjectBenchmarks<SaveJson>("indexed", size, iterations, counters);
+    }
+
+    ReferenceDatabase::Close(db);
+    if (!ok) {
+        LogMessage(LOG_ERROR_LEVEL, "Benchmark FAILED: a benchmarked operation failed during the run (see the errors above).");
+        return 1;
+    }
+    LogMessage(LOG_INFO_LEVEL, "Benchmark complete.");
+    return 0;
+}
@@ -0,0 +1,49 @@
+// SaveBenchmark.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include "ItemCatalog.h"    // For ItemCatalog
+
+// Benchmarks the hot paths of loading and editing one save file: encoding detection, XOR decoding,
+// JSON parsing and serialization, the full load, writing and restoring a session snapshot, each Max*
+// pass, and a count import of a generated
+// 100,000-row CSV (the join and applying its result), the consistency check on a save with 100,000
+// ingredients and inventory slots, zlib compression and inflation of the save text,
+// and serial and block-parallel deflate of an 8 MB input; then bulk insert, lookup and iteration on
+// save objects of realistic and scaled sizes.
+// Reports wall-clock time and,
+// if hardwareCounters is set and the platform allows it, cycles, instructions, cache misses and
+// branch misses, each per byte of input and per item processed. Used by the -benchmark headless mode.
+// If catalog is not NULL, the Max* passes look item data up in it instead of the reference database.
+// Returns the process exit code: 0 if every benchmark ran, 1 otherwise.
+int RunSaveBenchmark(const std::string& savePath, int iterations, bool hardwareCounters, const ItemCatalog* catalog);
@@ -0,0 +1,84 @@
+// SaveChangeEvents.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveChangeEvents.h"
+
+std::string MakeSaveChangePath(const char* section, std::string_view key, const char* field) {
+    std::string path = "/";
+    path += section;
+    path += '/';
+    for (char c : key) {
+        if (c == '~') {
+            path += "~0";
+        } else if (c == '/') {
+            path += "~1";
+        } else {
+            path += c;
+        }
+    }
+    if (field) {
+        path += '/';
+        path += field;
+    }
+    return path;
+}
+
+std::string GetSaveChangeSection(const std::string& path) {
+    if (path.empty() || path[0] != '/') {
+        return std::string();
+    }
+    size_t end = path.find('/', 1);
+    return path.substr(1, end == std::string::npos ? std::string::npos : end - 1);
+}
+
+SaveChangePublisher::SaveChangePublisher() : m_nextId(1) {
+}
+
+int SaveChangePublisher::Subscribe(SaveChangeCallback callback) {
+    int id = m_nextId++;
+    m_subscribers.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void SaveChangePublisher::Unsubscribe(int id) {
+    for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+        if (it->first == id) {
+            m_subscribers.erase(it);
+            return;
+        }
+    }
+}
+
+void SaveChangePublisher::Publish(const SaveChangeEvent& event) const {
+    for (const auto& subscriber : m_subscribers) {
+        subscriber.second(event);
+    }
+}
@@ -0,0 +1,81 @@
+// SaveChangeEvents.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <functional>       // For std::function
+#include <string>
+#include <string_view>
+#include <utility>          // For std::pair
+#include <vector>
+#include "SaveJson.h"       // For SaveJson, the values carried by an event
+
+// What a change event describes.
+enum SaveChangeKind {
+    SAVE_CHANGE_VALUE,      // One value was set, added or replaced; path, oldValue and newValue are filled in.
+    SAVE_CHANGE_LOADED,     // A save file was loaded; every value may be different.
+    SAVE_CHANGE_UNLOADED,   // The loaded save file was cleared.
+};
+
+// One change to the loaded save data.
+struct SaveChangeEvent {
+    SaveChangeKind kind;
+    std::string path;       // JSON pointer to the changed value, e.g. "/PlayerInfo/m_Gold"; empty unless kind is SAVE_CHANGE_VALUE.
+    SaveJson oldValue;      // Value before the change; null if the value was added.
+    SaveJson newValue;      // Value after the change.
+};
+
+typedef std::function<void(const SaveChangeEvent&)> SaveChangeCallback;
+
+// Builds the JSON pointer "/section/key[/field]" for a change event, escaping '~' and '/' in the key.
+std::string MakeSaveChangePath(const char* section, std::string_view key, const char* field);
+
+// Returns the top-level section an event path belongs to ("Ingredients" for "/Ingredients/1021045/count").
+std::string GetSaveChangeSection(const std::string& path);
+
+// Delivers change events to subscribers, synchronously and in subscription order.
+// Publishers should check HasSubscribers() before building an event, so that unobserved edits (headless
+// runs, journal replay without a UI) pay nothing for it. Callbacks must not subscribe or unsubscribe.
+class SaveChangePublisher {
+public:
+    SaveChangePublisher();
+
+    // Adds a subscriber; returns an id for Unsubscribe.
+    int Subscribe(SaveChangeCallback callback);
+    void Unsubscribe(int id);
+    bool HasSubscribers() const { return !m_subscribers.empty(); }
+
+    void Publish(const SaveChangeEvent& event) const;
+
+private:
+    std::vector<std::pair<int, SaveChangeCallback>> m_subscribers;
+    int m_nextId;
+};
@@ -0,0 +1,410 @@
+// SaveCodec.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveCodec.h"
+#include <algorithm>    // For std::min, std::sort
+#include <cmath>        // For std::log
+#include <cstring>      // For memcpy
+#include "json.hpp"     // For nlohmann::json::sax_parse
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>  // SSE2 intrinsics
+#define SAVE_CODEC_SSE2 1
+#endif
+
+// Bytes of ciphertext sampled for key recovery.
+static const size_t KEY_RECOVERY_SAMPLE_BYTES = 64 * 1024;
+// Minimum bytes per key column for a period to be considered; shorter columns give meaningless statistics.
+static const size_t MIN_COLUMN_SAMPLES = 16;
+
+std::string SaveCodec::Describe() const {
+    if (type == SAVE_CODEC_PLAIN_JSON) {
+        return "plain JSON";
+    }
+    bool printable = true;
+    for (char c : key) {
+        printable = printable && c >= 0x20 && c < 0x7F;
+    }
+    std::string shown;
+    if (printable) {
+        shown = "\"" + key + "\"";
+    } else {
+        // Recovered keys are usually binary; show them as hex.
+        static const char HEX_DIGITS[] = "0123456789abcdef";
+        shown = "0x";
+        for (char c : key) {
+            shown += HEX_DIGITS[(static_cast<unsigned char>(c) >> 4) & 0xF];
+            shown += HEX_DIGITS[static_cast<unsigned char>(c) & 0xF];
+        }
+    }
+    return std::string(recovered ? "XOR (recovered key " : "XOR (key ") + shown + ")";
+}
+
+const std::vector<SaveCodec>& GetKnownSaveCodecs() {
+    static const std::vector<SaveCodec> codecs = [] {
+        std::vector<SaveCodec> list;
+        SaveCodec plain;
+        plain.type = SAVE_CODEC_PLAIN_JSON;
+        plain.key.clear();
+        list.push_back(plain);
+        SaveCodec game_data; // XOR with "GameData", used by the PC release.
+        list.push_back(game_data);
+        return list;
+    }();
+    return codecs;
+}
+
+void XorWithKey(char* data, size_t length, const std::string& key, size_t keyOffset) {
+    const size_t key_length = key.size();
+    if (key_length == 0 || length == 0) {
+        return;
+    }
+    size_t i = 0;
+#ifdef SAVE_CODEC_SSE2
+    if (length >= 64) {
+        // Expand the key to key_length * 16 bytes: a multiple of both the key period and the vector width,
+        // so every 16-byte block of data lines up with one of key_length fixed 16-byte key blocks.
+        const size_t expanded_length = key_length * 16;
+        unsigned char expanded[MAX_RECOVERED_KEY_LENGTH * 16];
+        std::string long_key_buffer;
+        unsigned char* pattern = expanded;
+        if (expanded_length > sizeof(expanded)) {
+            long_key_buffer.resize(expanded_length);
+            pattern = reinterpret_cast<unsigned char*>(&long_key_buffer[0]);
+        }
+        for (size_t j = 0; j < expanded_length; ++j) {
+            pattern[j] = static_cast<unsigned char>(key[(keyOffset + j) % key_length]);
+        }
+        size_t pattern_pos = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i key_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + pattern_pos));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(block, key_block));
+            pattern_pos += 16;
+            if (pattern_pos == expanded_length) {
+                pattern_pos = 0;
+            }
+        }
+    }
+#endif
+    size_t key_pos = (keyOffset + i) % key_length;
+    for (; i < length; ++i) {
+        data[i] ^= key[key_pos];
+        if (++key_pos == key_length) {
+            key_pos = 0;
+        }
+    }
+}
+
+void DecodeSaveBytes(const SaveCodec& codec, std::string& bytes) {
+    if (codec.type == SAVE_CODEC_XOR && !bytes.empty()) {
+        XorWithKey(&bytes[0], bytes.size(), codec.key);
+    }
+}
+
+void EncodeSaveBytes(const SaveCodec& codec, std::string& text) {
+    DecodeSaveBytes(codec, text); // XOR is its own inverse; plain JSON is stored as is.
+}
+
+// SAX handler that accepts every event; only the position of a parse error matters.
+class PrefixCheckSax {
+public:
+    PrefixCheckSax() : m_errorPosition(0), m_keys(0), m_failed(false) {}
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(nlohmann::json::number_integer_t) { return true; }
+    bool number_unsigned(nlohmann::json::number_unsigned_t) { return true; }
+    bool number_float(nlohmann::json::number_float_t, const std::string&) { return true; }
+    bool string(std::string&) { return true; }
+    bool binary(nlohmann::json::binary_t&) { return true; }
+    bool start_object(std::size_t) { return true; }
+    bool key(std::string&) { m_keys++; return true; }
+    bool end_object() { return true; }
+    bool start_array(std::size_t) { return true; }
+    bool end_array() { return true; }
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception&) {
+        m_errorPosition = position;
+        m_failed = true;
+        return false;
+    }
+
+    bool Failed() const { return m_failed; }
+    size_t ErrorPosition() const { return m_errorPosition; }
+    size_t KeyCount() const { return m_keys; }
+
+private:
+    size_t m_errorPosition;
+    size_t m_keys;
+    bool m_failed;
+};
+
+// Returns how far the text reads as the start of a JSON object: length if it is valid JSON or a valid
+// document cut off at the end of the text, otherwise the number of bytes read up to the first error.
+// If complete is given, it is set to true only if the text is a whole document or its truncated part
+// holds at least one complete key. Without that, garbage that happens to open a string that runs to the
+// end of the text would pass as a prefix.
+static size_t JsonPrefixLength(const char* text, size_t length, bool* complete = NULL) {
+    if (complete) {
+        *complete = false;
+    }
+    size_t start = 0;
+    while (start < length && (text[start] == ' ' || text[start] == '\t' || text[start] == '\r' || text[start] == '\n')) {
+        start++;
+    }
+    if (start == length || text[start] != '{') {
+        return 0;
+    }
+    PrefixCheckSax sax;
+    nlohmann::json::sax_parse(text, text + length, &sax);
+    // An error caused by running out of input means the text is a truncated document, which is fine.
+    if (!sax.Failed() || sax.ErrorPosition() >= length) {
+        if (complete) {
+            *complete = !sax.Failed() || sax.KeyCount() > 0;
+        }
+        return length;
+    }
+    return sax.ErrorPosition();
+}
+
+bool LooksLikeJsonPrefix(const char* text, size_t length) {
+    bool complete = false;
+    return length > 0 && JsonPrefixLength(text, length, &complete) == length && complete;
+}
+
+// Returns the log of a byte's approximate relative frequency in save JSON text. Key bytes are chosen to
+// maximize the likelihood of their decoded column under this model; control characters and bytes above
+// 0x7E are so unlikely that they rule a key byte out quickly.
+static double PlaintextLogFrequency(unsigned char c) {
+    static const double* table = [] {
+        static double log_frequency[256];
+        double frequency[256];
+        for (int i = 0; i < 256; ++i) {
+            frequency[i] = (i >= 0x20 && i < 0x7F) ? 0.05 : 0.0001;
+        }
+        frequency['\r'] = frequency['\t'] = 0.05;
+        frequency['\n'] = 1.0;
+        frequency['"'] = 12.0;
+        frequency[' '] = 8.0;
+        frequency[':'] = frequency[','] = 4.0;
+        frequency['{'] = frequency['}'] = 1.5;
+        frequency['['] = frequency[']'] = 0.3;
+        frequency['_'] = 1.0;
+        frequency['.'] = frequency['/'] = frequency['-'] = 0.5;
+        const char* digits = "0123456789";
+        const double digit_frequency[] = { 6, 6, 5, 3, 3, 3, 3, 3, 3, 3 };
+        for (int i = 0; i < 10; ++i) {
+            frequency[static_cast<unsigned char>(digits[i])] = digit_frequency[i];
+        }
+        // English letter order, most frequent first.
+        const char* letters = "etaoinsrlcdumhgpfywbvkxqjz";
+        const double letter_frequency[] = { 6, 5, 5, 4.5, 5, 5, 4, 4, 3, 3, 3, 2.5, 3, 2, 2, 2, 1.5, 1, 1, 1, 1, 0.7, 0.3, 0.2, 0.2, 0.2 };
+        for (int i = 0; i < 26; ++i) {
+            unsigned char lower = static_cast<unsigned char>(letters[i]);
+            frequency[lower] = letter_frequency[i];
+            frequency[lower - 'a' + 'A'] = letter_frequency[i] / 6.0;
+        }
+        for (int i = 0; i < 256; ++i) {
+            log_frequency[i] = std::log(frequency[i]);
+        }
+        return log_frequency;
+    }();
+    return table[c];
+}
+
+// Number of candidate key bytes kept per column, best first.
+static const size_t RANKED_KEY_BYTES = 8;
+
+// Ranks the key bytes for one column of the sample by how much the decoded column reads like JSON text.
+static void RankColumnKeys(const unsigned char* bytes, size_t sample, size_t period, size_t column,
+                           unsigned char ranked[RANKED_KEY_BYTES]) {
+    unsigned int histogram[256] = { 0 };
+    for (size_t i = column; i < sample; i += period) {
+        histogram[bytes[i]]++;
+    }
+    // Only the distinct bytes present in the column contribute to a candidate's score.
+    unsigned char present[256];
+    int present_count = 0;
+    for (int b = 0; b < 256; ++b) {
+        if (histogram[b]) {
+            present[present_count++] = static_cast<unsigned char>(b);
+        }
+    }
+    double scores[256];
+    for (int k = 0; k < 256; ++k) {
+        double score = 0.0;
+        for (int i = 0; i < present_count; ++i) {
+            score += histogram[present[i]] * PlaintextLogFrequency(static_cast<unsigned char>(present[i] ^ k));
+        }
+        scores[k] = score;
+    }
+    unsigned char order[256];
+    for (int k = 0; k < 256; ++k) {
+        order[k] = static_cast<unsigned char>(k);
+    }
+    std::partial_sort(order, order + RANKED_KEY_BYTES, order + 256, [&scores](unsigned char a, unsigned char b) {
+        return scores[a] > scores[b];
+    });
+    memcpy(ranked, order, RANKED_KEY_BYTES);
+}
+
+// Decodes the confirmation prefix with key and returns how far it reads as JSON.
+static size_t TrialDecode(const char* data, size_t length, const std::string& key, std::string& trial) {
+    trial.assign(data, length);
+    XorWithKey(&trial[0], trial.size(), key);
+    return JsonPrefixLength(trial.data(), trial.size());
+}
+
+bool RecoverXorKey(const char* data, size_t length, std::string& out_key) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    const size_t sample = std::min(length, KEY_RECOVERY_SAMPLE_BYTES);
+    if (sample < 2) {
+        return false;
+    }
+
+    // Rank periods by the index of coincidence of their columns. XOR with a constant keeps a column's byte
+    // histogram shape, so at the true period (and its multiples) columns look like plaintext: skewed
+    // histograms with a high coincidence rate. Wrong periods mix key bytes and flatten the histograms.
+    struct PeriodScore { size_t period; double coincidence; };
+    std::vector<PeriodScore> scores;
+    unsigned int histogram[256];
+    for (size_t period = 1; period <= MAX_RECOVERED_KEY_LENGTH; ++period) {
+        if (sample / period < MIN_COLUMN_SAMPLES) {
+            break;
+        }
+        double coincidence = 0.0;
+        for (size_t column = 0; column < period; ++column) {
+            memset(histogram, 0, sizeof(histogram));
+            size_t count = 0;
+            for (size_t i = column; i < sample; i += period, ++count) {
+                histogram[bytes[i]]++;
+            }
+            double pairs = 0.0;
+            for (int b = 0; b < 256; ++b) {
+                pairs += static_cast<double>(histogram[b]) * (histogram[b] - 1);
+            }
+            coincidence += count > 1 ? pairs / (static_cast<double>(count) * (count - 1)) : 0.0;
+        }
+        scores.push_back({ period, coincidence / period });
+    }
+    if (scores.empty()) {
+        return false;
+    }
+    // Prefer the best scores; among near-equal scores prefer the shorter period, since multiples of the
+    // true period score just as well.
+    double best = 0.0;
+    for (const auto& s : scores) {
+        best = std::max(best, s.coincidence);
+    }
+    std::stable_sort(scores.begin(), scores.end(), [best](const PeriodScore& a, const PeriodScore& b) {
+        bool a_near = a.coincidence >= best * 0.9;
+        bool b_near = b.coincidence >= best * 0.9;
+        if (a_near != b_near) return a_near;
+        if (a_near) return a.period < b.period;
+        return a.coincidence > b.coincidence;
+    });
+
+    const size_t confirm_length = std::min(length, CODEC_CONFIRM_BYTES);
+    std::string trial;
+    for (size_t candidate = 0; candidate < scores.size(); ++candidate) {
+        const size_t period = scores[candidate].period;
+        std::vector<unsigned char> ranked(period * RANKED_KEY_BYTES);
+        std::string key(period, '\0');
+        for (size_t column = 0; column < period; ++column) {
+            RankColumnKeys(bytes, sample, period, column, &ranked[column * RANKED_KEY_BYTES]);
+            key[column] = static_cast<char>(ranked[column * RANKED_KEY_BYTES]);
+        }
+        // The first byte is known plaintext: a save is a JSON object.
+        key[0] = static_cast<char>(bytes[0] ^ '{');
+
+        // Columns whose statistics are ambiguous (e.g. spaces versus quotes, which differ in one bit) show
+        // up as parse errors, at or some way after the wrongly decoded byte. Walk back from each error
+        // through one key period and take the first alternative key byte that lets the parser read further,
+        // until the prefix parses or no alternative helps.
+        size_t reached = TrialDecode(data, confirm_length, key, trial);
+        for (size_t round = 0; round < period * 4 && reached < confirm_length; ++round) {
+            size_t improved = reached;
+            for (size_t back = 1; back <= period && back <= reached && improved == reached; ++back) {
+                const size_t column = (reached - back) % period;
+                if (column == 0) {
+                    continue; // Anchored by known plaintext.
+                }
+                const char original = key[column];
+                for (size_t alt = 0; alt < RANKED_KEY_BYTES && improved == reached; ++alt) {
+                    key[column] = static_cast<char>(ranked[column * RANKED_KEY_BYTES + alt]);
+                    if (key[column] == original) {
+                        continue;
+                    }
+                    improved = TrialDecode(data, confirm_length, key, trial);
+                    if (improved <= reached) {
+                        improved = reached;
+                        key[column] = original;
+                    }
+                }
+            }
+            if (improved == reached) {
+                break;
+            }
+            reached = improved;
+        }
+        TrialDecode(data, confirm_length, key, trial);
+        if (reached == confirm_length && LooksLikeJsonPrefix(trial.data(), trial.size())) {
+            out_key = key;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DetectSaveCodec(const char* data, size_t length, SaveCodec& out) {
+    if (length == 0) {
+        return false;
+    }
+    const size_t confirm_length = std::min(length, CODEC_CONFIRM_BYTES);
+    std::string trial;
+    for (const SaveCodec& codec : GetKnownSaveCodecs()) {
+        trial.assign(data, confirm_length);
+        DecodeSaveBytes(codec, trial);
+        if (LooksLikeJsonPrefix(trial.data(), trial.size())) {
+            out = codec;
+            return true;
+        }
+    }
+
+    std::string key;
+    if (RecoverXorKey(data, length, key)) {
+        out.type = SAVE_CODEC_XOR;
+        out.key = key;
+        out.recovered = true;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+// SaveCodec.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// How the bytes of a save file encode its JSON text.
+enum SaveCodecType {
+    SAVE_CODEC_PLAIN_JSON,  // The file is the JSON text itself.
+    SAVE_CODEC_XOR          // The JSON text XORed with a repeating key.
+};
+
+// A save file encoding. Loading detects the codec and writing reuses it, so a save is written back in
+// the format it was read in.
+struct SaveCodec {
+    SaveCodecType type = SAVE_CODEC_XOR;
+    std::string key = "GameData";   // XOR key; unused for plain JSON.
+    bool recovered = false;         // True if the key was recovered from the file rather than known.
+
+    // Returns a short description for logs, e.g. "XOR (key \"GameData\")". Binary keys are shown in hex.
+    std::string Describe() const;
+};
+
+// Longest XOR key period the detector tries to recover.
+const size_t MAX_RECOVERED_KEY_LENGTH = 32;
+// Number of leading bytes trial-decoded to confirm a codec.
+const size_t CODEC_CONFIRM_BYTES = 4096;
+
+// Returns the built-in codecs tried first by DetectSaveCodec: plain JSON and XOR with each known key.
+const std::vector<SaveCodec>& GetKnownSaveCodecs();
+
+// Detects the codec of raw save file bytes. Known codecs are confirmed by trial-decoding the first
+// CODEC_CONFIRM_BYTES; if none fits, a periodic XOR key is recovered from the data and confirmed the same way.
+// Returns false if no codec produces the start of a JSON object.
+bool DetectSaveCodec(const char* data, size_t length, SaveCodec& out);
+
+// Recovers a repeating XOR key of up to MAX_RECOVERED_KEY_LENGTH bytes, assuming the plaintext is JSON
+// starting with '{'. The key is not confirmed; use LooksLikeJsonPrefix on the decoded data for that.
+bool RecoverXorKey(const char* data, size_t length, std::string& out_key);
+
+// Returns true if the text is valid JSON, or a valid JSON document cut off at the end of the text.
+bool LooksLikeJsonPrefix(const char* text, size_t length);
+
+// XORs data in place with a repeating key, starting at key position keyOffset. Uses SSE2 when available.
+void XorWithKey(char* data, size_t length, const std::string& key, size_t keyOffset = 0);
+
+// Decodes save file bytes to JSON text in place.
+void DecodeSaveBytes(const SaveCodec& codec, std::string& bytes);
+// Encodes JSON text to save file bytes in place.
+void EncodeSaveBytes(const SaveCodec& codec, std::string& text);
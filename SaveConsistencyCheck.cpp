@@ -0,0 +1,239 @@
+// SaveConsistencyCheck.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveConsistencyCheck.h"
+#include <algorithm>        // For std::min_element, std::max_element
+#include <climits>          // For INT32_MAX
+
+// Widest ID range laid out densely (4 bytes per ID per array); the reference IDs span about 10,000.
+const int64_t MAX_DENSE_ID_RANGE = 1 << 22;
+
+bool SaveConsistencyChecker::Prepare(const ItemCatalog* catalog, sqlite3* db, std::string& out_error) {
+    std::vector<int32_t> tids;
+    std::vector<int32_t> data_ids;
+    std::vector<int32_t> max_counts;
+    if (catalog && catalog->IsOpen()) {
+        // Catalog columns are already flat arrays in TID order.
+        const uint32_t count = catalog->GetItemCount();
+        const int32_t* tid_column = catalog->GetIntColumn(CATALOG_ITEM_TID);
+        const int32_t* data_id_column = catalog->GetIntColumn(CATALOG_ITEM_DATA_ID);
+        const int32_t* max_count_column = catalog->GetIntColumn(CATALOG_ITEM_MAX_COUNT);
+        tids.assign(tid_column, tid_column + count);
+        data_ids.assign(data_id_column, data_id_column + count);
+        max_counts.assign(max_count_column, max_count_column + count);
+    } else if (db) {
+        sqlite3_stmt* stmt = NULL;
+        if (sqlite3_prepare_v2(db, "SELECT TID, ItemDataID, MaxCount FROM Items ORDER BY TID;", -1, &stmt, NULL) != SQLITE_OK) {
+            out_error = "SQL prepare failed for the consistency check: " + std::string(sqlite3_errmsg(db));
+            return false;
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            tids.push_back(sqlite3_column_int(stmt, 0));
+            data_ids.push_back(sqlite3_column_int(stmt, 1));
+            max_counts.push_back(sqlite3_column_int(stmt, 2));
+        }
+        sqlite3_finalize(stmt);
+    } else {
+        out_error = "No item catalog or reference database to check the save against.";
+        return false;
+    }
+    return Build(tids, data_ids, max_counts, out_error);
+}
+
+bool SaveConsistencyChecker::Build(const std::vector<int32_t>& tids, const std::vector<int32_t>& dataIds, const std::vector<int32_t>& maxCounts, std::string& out_error) {
+    m_maxCountByTid.clear();
+    m_dataIdByTid.clear();
+    m_maxCountByDataId.clear();
+    if (tids.empty()) {
+        out_error = "The reference data has no items to check the save against.";
+        return false;
+    }
+    const int32_t min_tid = *std::min_element(tids.begin(), tids.end());
+    const int32_t max_tid = *std::max_element(tids.begin(), tids.end());
+    const int32_t min_data_id = *std::min_element(dataIds.begin(), dataIds.end());
+    const int32_t max_data_id = *std::max_element(dataIds.begin(), dataIds.end());
+    if (static_cast<int64_t>(max_tid) - min_tid >= MAX_DENSE_ID_RANGE || static_cast<int64_t>(max_data_id) - min_data_id >= MAX_DENSE_ID_RANGE) {
+        out_error = "The reference item IDs span too wide a range for the consistency check.";
+        return false;
+    }
+
+    m_tidBase = min_tid;
+    m_maxCountByTid.assign(static_cast<size_t>(max_tid - min_tid) + 1, -1);
+    m_dataIdByTid.assign(m_maxCountByTid.size(), -1);
+    m_dataIdBase = min_data_id;
+    m_maxCountByDataId.assign(static_cast<size_t>(max_data_id - min_data_id) + 1, -1);
+    for (size_t i = 0; i < tids.size(); ++i) {
+        m_maxCountByTid[tids[i] - min_tid] = std::max(maxCounts[i], 0);
+        m_dataIdByTid[tids[i] - min_tid] = dataIds[i];
+    }
+    // Rows arrive in TID order; walk them backwards so the first item per ItemDataID is written last.
+    for (size_t i = tids.size(); i-- > 0;) {
+        m_maxCountByDataId[dataIds[i] - min_data_id] = std::max(maxCounts[i], 0);
+    }
+    return true;
+}
+
+// Looks up each id in a dense array; -1 for IDs outside it. The unsigned compare covers both ends of the range.
+static void GatherDense(const std::vector<int32_t>& ids, const std::vector<int32_t>& dense, int32_t base, std::vector<int32_t>& out_values) {
+    out_values.resize(ids.size());
+    const uint32_t size = static_cast<uint32_t>(dense.size());
+    const int32_t* table = dense.data();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const uint32_t offset = static_cast<uint32_t>(ids[i]) - static_cast<uint32_t>(base);
+        out_values[i] = offset < size ? table[offset] : -1;
+    }
+}
+
+// Reads an integer field as int32, saturating out-of-range values; missing or non-integer fields read as 0
+// (the schema check reports those).
+static int32_t ReadInt32Field(const SaveJson& entry, const char* field) {
+    auto value = entry.find(field);
+    if (value == entry.end() || !value->is_number_integer()) {
+        return 0;
+    }
+    const long long number = value->get<long long>();
+    return number > INT32_MAX ? INT32_MAX : number < INT32_MIN ? INT32_MIN : static_cast<int32_t>(number);
+}
+
+// Flat copies of one section's entries.
+struct ConsistencyColumns {
+    std::vector<const SaveJson::string_t*> keys;
+    std::vector<int32_t> ids;
+    std::vector<int32_t> counts;
+    std::vector<int32_t> parents;
+};
+
+static void CollectColumns(const SaveJson& save, const char* section, const char* idField, const char* countField,
+                           const char* parentField, ConsistencyColumns& out_columns) {
+    auto entries = save.find(section);
+    if (entries == save.end() || !entries->is_object()) {
+        return;
+    }
+    out_columns.keys.reserve(entries->size());
+    out_columns.ids.reserve(entries->size());
+    out_columns.counts.reserve(entries->size());
+    for (auto it = entries->begin(); it != entries->end(); ++it) {
+        auto id = it.value().find(idField);
+        if (id == it.value().end() || !id->is_number_integer()) {
+            continue;
+        }
+        out_columns.keys.push_back(&it.key());
+        out_columns.ids.push_back(ReadInt32Field(it.value(), idField));
+        out_columns.counts.push_back(ReadInt32Field(it.value(), countField));
+        if (parentField) {
+            out_columns.parents.push_back(ReadInt32Field(it.value(), parentField));
+        }
+    }
+}
+
+// Counts the entries that fail each rule, then describes the first failures.
+static void CheckColumns(const char* section, const ConsistencyColumns& columns, const std::vector<int32_t>& maxCounts,
+                         const std::vector<int32_t>& parentDataIds, SaveConsistencyReport& out_report) {
+    const size_t n = columns.ids.size();
+    const int32_t* ids = columns.ids.data();
+    const int32_t* counts = columns.counts.data();
+    const int32_t* max = maxCounts.data();
+    size_t unknown = 0;
+    size_t above = 0;
+    size_t negative = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unknown += max[i] < 0;
+        negative += counts[i] < 0;
+        above += (max[i] >= 0) & (counts[i] > max[i]);
+    }
+    size_t mismatched = 0;
+    const bool check_parents = !columns.parents.empty();
+    if (check_parents) {
+        const int32_t* parents = columns.parents.data();
+        const int32_t* parent_data_ids = parentDataIds.data();
+        for (size_t i = 0; i < n; ++i) {
+            mismatched += (parents[i] != 0) & (parent_data_ids[i] != ids[i]);
+        }
+    }
+    out_report.unknownIds += unknown;
+    out_report.countsAboveMax += above;
+    out_report.negativeCounts += negative;
+    out_report.parentMismatches += mismatched;
+    if (unknown + above + negative + mismatched == 0) {
+        return;
+    }
+
+    auto describe = [&](size_t i, const std::string& problem) {
+        if (out_report.problems.size() < MAX_REPORTED_CONSISTENCY_PROBLEMS) {
+            out_report.problems.push_back(std::string(section) + "[\"" + *columns.keys[i] + "\"]: " + problem);
+        }
+    };
+    for (size_t i = 0; i < n && out_report.problems.size() < MAX_REPORTED_CONSISTENCY_PROBLEMS; ++i) {
+        if (max[i] < 0) {
+            describe(i, "ID " + std::to_string(ids[i]) + " matches no reference item.");
+        } else if (counts[i] > max[i]) {
+            describe(i, "count " + std::to_string(counts[i]) + " is above MaxCount " + std::to_string(max[i]) + ".");
+        }
+        if (counts[i] < 0) {
+            describe(i, "count " + std::to_string(counts[i]) + " is negative.");
+        }
+        if (check_parents && columns.parents[i] != 0 && parentDataIds[i] != ids[i]) {
+            describe(i, "parentID " + std::to_string(columns.parents[i]) + " is not an item with ItemDataID " + std::to_string(ids[i]) + ".");
+        }
+    }
+}
+
+void SaveConsistencyChecker::Check(const SaveJson& save, SaveConsistencyReport& out_report) const {
+    out_report = SaveConsistencyReport();
+    if (!IsPrepared()) {
+        return;
+    }
+    std::vector<int32_t> max_counts;
+    std::vector<int32_t> parent_data_ids;
+    std::vector<int32_t> parent_max_counts;
+
+    // Ingredients are keyed by ItemDataID; their parent is an item TID. Items sharing an ItemDataID can
+    // differ in MaxCount, so an ingredient is held to its parent's MaxCount, and to that of the first item
+    // with its ItemDataID only when it has no parent or the parent is a mismatch (reported as such).
+    ConsistencyColumns ingredients;
+    CollectColumns(save, "Ingredients", "ingredientsID", "count", "parentID", ingredients);
+    GatherDense(ingredients.ids, m_maxCountByDataId, m_dataIdBase, max_counts);
+    GatherDense(ingredients.parents, m_dataIdByTid, m_tidBase, parent_data_ids);
+    GatherDense(ingredients.parents, m_maxCountByTid, m_tidBase, parent_max_counts);
+    for (size_t i = 0; i < max_counts.size(); ++i) {
+        const bool by_parent = (ingredients.parents[i] != 0) & (parent_data_ids[i] == ingredients.ids[i]);
+        max_counts[i] = by_parent ? parent_max_counts[i] : max_counts[i];
+    }
+    out_report.ingredientsChecked = ingredients.ids.size();
+    CheckColumns("Ingredients", ingredients, max_counts, parent_data_ids, out_report);
+
+    // Inventory slots hold item TIDs.
+    ConsistencyColumns inventory;
+    CollectColumns(save, "InventoryItemSlot", "itemID", "totalCount", NULL, inventory);
+    GatherDense(inventory.ids, m_maxCountByTid, m_tidBase, max_counts);
+    out_report.inventoryChecked = inventory.ids.size();
+    CheckColumns("InventoryItemSlot", inventory, max_counts, parent_data_ids, out_report);
+}
@@ -0,0 +1,81 @@
+// SaveConsistencyCheck.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "sqlite3.h"        // For reading the reference items from the database
+#include "ItemCatalog.h"    // For reading the reference items from an item catalog
+#include "SaveJson.h"       // For SaveJson
+
+// Problems described individually in a consistency report; the rest are only counted.
+const size_t MAX_REPORTED_CONSISTENCY_PROBLEMS = 20;
+
+// Result of checking a save's items against the reference items.
+struct SaveConsistencyReport {
+    size_t ingredientsChecked = 0;      // Ingredients entries with an ingredientsID.
+    size_t inventoryChecked = 0;        // InventoryItemSlot entries with an itemID.
+    size_t unknownIds = 0;              // Entries whose ID matches no reference item.
+    size_t countsAboveMax = 0;          // Counts above the item's MaxCount.
+    size_t negativeCounts = 0;          // Counts below zero.
+    size_t parentMismatches = 0;        // Ingredients whose non-zero parentID is not an item with that ItemDataID.
+    std::vector<std::string> problems;  // The first MAX_REPORTED_CONSISTENCY_PROBLEMS problems.
+
+    size_t ProblemCount() const { return unknownIds + countsAboveMax + negativeCounts + parentMismatches; }
+};
+
+// Checks every owned ingredient and inventory entry of a save against the reference items in one pass.
+// Prepare lays the reference items out as dense arrays indexed by TID and by ItemDataID. Check first
+// copies the save's IDs, counts and parent IDs into flat arrays, then validates them with branch-free
+// loops over those arrays, which the compiler can vectorize; only entries found to be bad are revisited
+// to describe them. Cheap enough to run before every write.
+class SaveConsistencyChecker {
+public:
+    // Reads the reference items from catalog if it is open, else from db. Fails if neither can be read
+    // or the IDs span too wide a range for dense arrays.
+    bool Prepare(const ItemCatalog* catalog, sqlite3* db, std::string& out_error);
+    bool IsPrepared() const { return !m_maxCountByTid.empty(); }
+
+    // Checks save; out_report is replaced. Does nothing but clear out_report if not prepared.
+    void Check(const SaveJson& save, SaveConsistencyReport& out_report) const;
+
+private:
+    // Dense lookups; the value for ID x is at x - base, and -1 means no item.
+    int32_t m_tidBase = 0;
+    std::vector<int32_t> m_maxCountByTid;
+    std::vector<int32_t> m_dataIdByTid;
+    int32_t m_dataIdBase = 0;
+    std::vector<int32_t> m_maxCountByDataId;   // MaxCount of the first item, in TID order, with the ItemDataID; for ingredients without a parent.
+
+    bool Build(const std::vector<int32_t>& tids, const std::vector<int32_t>& dataIds, const std::vector<int32_t>& maxCounts, std::string& out_error);
+};
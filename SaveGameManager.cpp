@@ -34,26 +34,33 @@
 #include "SaveGameManager.h"
 #include <fstream>       // For file input/output streams
 #include <shlobj.h>      // For SHGetKnownFolderPath (includes windows.h)
-#include <chrono>        // For timestamping (std::chrono)
-#include <iomanip>       // For std::put_time
-#include <sstream>       // For std::stringstream
-#include <algorithm>     // For std::all_of, and std::min/max
+#include <algorithm>     // For std::all_of, std::sort, and std::min/max
+#include <chrono>        // For timing session recovery (std::chrono::steady_clock)
 #include "sqlite3.h"     // Required for sqlite3* parameter in MaxAllIngredients
 #include "Logger.h"      // For LogMessage
-#include "json.hpp"      // Corrected include for nlohmann/json
+#include "SaveTimestamp.h" // For backup name and lastGainTime timestamps
+#include "SaveJson.h"     // For SaveJson
+#include "ParallelDeflate.h" // For ParallelCompressZlib
+#include "ZlibUtil.h"     // For ZlibDecompress
+#include "SaveArchive.h"  // For reading saves out of zip and gzip archives
+#include "SaveJsonWriter.h" // For EncodeSaveJson
+#include "SaveJsonCbor.h"   // For ReadSaveJsonCbor (session snapshots)
 #include <vector>        // Required for std::vector
 #include <map>           // Required for std::map
+#include <unordered_map> // Required for std::unordered_map (inventory slots by item ID)
+#include <unordered_set> // Required for std::unordered_set (known item IDs)
 #include <string>        // Required for std::string
+#include <cstring>       // Required for memcmp (session snapshot magic)
 #include <stdexcept>     // Required for std::runtime_error
 #include <filesystem>    // Required for std::filesystem::path, create_directories, copy, last_write_time
-#include <iostream>
 
 // --- Global Constants for SaveGameManager ---
 // Use long long for currency to avoid overflow
 const long long SAVE_MAX_CURRENCY = 999999999LL;
 
 // Constructor: Initializes the SaveGameManager instance.
-SaveGameManager::SaveGameManager() : m_isSaveFileLoaded(false) {
+SaveGameManager::SaveGameManager() : m_isSaveFileLoaded(false), m_sourceSize(0), m_sourceWriteTime(0),
+                                     m_schema(CompiledSaveSchema::DefaultSchemaDocument()), m_catalog(NULL) {
     LogMessage(LOG_INFO_LEVEL, "SaveGameManager initialized.");
 }
 
@@ -62,118 +69,139 @@ SaveGameManager::~SaveGameManager() {
     LogMessage(LOG_INFO_LEVEL, "SaveGameManager shutting down.");
 }
 
-// Applies XOR encryption/decryption to a string using a specified key.
-// The same function is used for both encryption and decryption.
-std::string SaveGameManager::XORDecryptEncrypt(const std::string& data, const std::string& key) {
-    std::string result = data;
-    size_t key_len = key.length();
-    for (size_t i = 0; i < data.length(); ++i) {
-        result[i] = data[i] ^ key[i % key_len];
-    }
-    return result;
-}
-
-// --- Zlib Decompression Implementation ---
-// This function is for decompressing the embedded SQLite database, not the save file itself.
-std::string SaveGameManager::decompressZlib(const std::vector<unsigned char>& compressed_bytes) {
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.avail_in = static_cast<uInt>(compressed_bytes.size());
-    strm.next_in = const_cast<Bytef*>(compressed_bytes.data());
-
-    if (inflateInit(&strm) != Z_OK) {
-        throw std::runtime_error("zlib inflateInit failed.");
-    }
-
-    std::string decompressed_str;
-    const size_t CHUNK = 16384;
-    std::vector<unsigned char> buffer(CHUNK);
-
-    int ret;
-    do {
-        strm.avail_out = CHUNK;
-        strm.next_out = buffer.data();
-        ret = inflate(&strm, Z_NO_FLUSH);
-        if (ret < 0 && ret != Z_BUF_ERROR) {
-             inflateEnd(&strm);
-             throw std::runtime_error("zlib inflate error: " + std::string(strm.msg ? strm.msg : "Unknown error"));
+// Returns the deepest object/array nesting in JSON text, scanning linearly and skipping string contents.
+// Stops early and returns max_depth + 1 as soon as the limit is exceeded.
+static size_t MeasureJsonNestingDepth(const std::string& text, size_t max_depth) {
+    size_t depth = 0;
+    size_t deepest = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i; // Skip the escaped character.
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            if (++depth > deepest) {
+                deepest = depth;
+                if (deepest > max_depth) {
+                    return deepest;
+                }
+            }
+        } else if ((c == '}' || c == ']') && depth > 0) {
+            --depth;
         }
-        decompressed_str.append(reinterpret_cast<char*>(buffer.data()), CHUNK - strm.avail_out);
-    } while (strm.avail_out == 0);
-
-    inflateEnd(&strm);
-    if (ret != Z_STREAM_END) {
-        throw std::runtime_error("zlib inflate did not reach end of stream correctly.");
     }
-    return decompressed_str;
+    return deepest;
 }
 
-// --- Zlib Compression Implementation ---
-// This function is for compressing the embedded SQLite database, not the save file itself.
-std::vector<unsigned char> SaveGameManager::compressZlib(const std::string& uncompressed_data) {
-    z_stream strm;
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.avail_in = static_cast<uInt>(uncompressed_data.size());
-    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(uncompressed_data.data()));
-
-    if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("zlib deflateInit failed.");
-    }
-
-    std::vector<unsigned char> compressed_bytes;
-    const size_t CHUNK = 16384;
-    std::vector<unsigned char> buffer(CHUNK);
-
-    int ret;
-    do {
-        strm.avail_out = CHUNK;
-        strm.next_out = buffer.data();
-        ret = deflate(&strm, Z_FINISH);
-        compressed_bytes.insert(compressed_bytes.end(), buffer.begin(), buffer.begin() + (CHUNK - strm.avail_out));
-    } while (ret == Z_OK);
-
-    deflateEnd(&strm);
-    if (ret != Z_STREAM_END) {
-        throw std::runtime_error("zlib deflate did not finish stream correctly: " + std::string(strm.msg ? strm.msg : "Unknown error"));
+// Clears the loaded save (and abandons its unsaved edits) before another one is loaded.
+void SaveGameManager::UnloadSave() {
+    bool was_loaded = m_isSaveFileLoaded;
+    m_journal.Discard();
+    m_isSaveFileLoaded = false;
+    m_currentSaveFilePath = "";
+    m_saveData = SaveJson(); // Clear any previously loaded data
+    m_stringPool.Clear();
+    if (was_loaded) {
+        PublishLoadState(SAVE_CHANGE_UNLOADED);
     }
-    return compressed_bytes;
 }
 
-
 // --- LoadSaveFile Implementation ---
 bool SaveGameManager::LoadSaveFile(const std::string& filepath) {
     LogMessage(LOG_INFO_LEVEL, ("Attempting to load save file: " + filepath).c_str());
-    m_isSaveFileLoaded = false;
-    m_currentSaveFilePath = "";
-    m_saveData = nlohmann::json(); // Clear any previously loaded data
-
+    UnloadSave();
+
+    std::string file_bytes;
+    if (IsSaveArchivePath(filepath)) {
+        // 1. Inflate the member straight into memory; the decoder and parser then work on it in place.
+        std::string archive_error;
+        if (!ReadSaveArchivePath(filepath, MAX_SAVE_FILE_BYTES, file_bytes, archive_error)) {
+            LogMessage(LOG_ERROR_LEVEL, ("Could not read save from archive: " + archive_error).c_str());
+            return false;
+        }
+        LogMessage(LOG_INFO_LEVEL, ("Inflated " + std::to_string(file_bytes.size()) + " bytes from archive.").c_str());
+        return LoadSaveFromMemory(file_bytes, filepath);
+    }
     try {
-        // 1. Read the raw XOR-encrypted bytes from the file
-        std::ifstream input_file(filepath, std::ios::binary);
+        // 1. Read the raw encoded bytes from the file, refusing oversized files before allocating.
+        std::ifstream input_file(filepath, std::ios::binary | std::ios::ate);
         if (!input_file) {
             LogMessage(LOG_ERROR_LEVEL, ("Could not open save file for reading: " + filepath).c_str());
             return false;
         }
-        std::vector<unsigned char> xor_encrypted_bytes((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
+        std::streamoff file_size = input_file.tellg();
+        if (file_size < 0 || static_cast<unsigned long long>(file_size) > MAX_SAVE_FILE_BYTES) {
+            LogMessage(LOG_ERROR_LEVEL, ("Save file is larger than the " + std::to_string(MAX_SAVE_FILE_BYTES) + " byte limit: " + filepath).c_str());
+            return false;
+        }
+        file_bytes.resize(static_cast<size_t>(file_size));
+        input_file.seekg(0);
+        if (file_size > 0 && !input_file.read(&file_bytes[0], file_size)) {
+            LogMessage(LOG_ERROR_LEVEL, ("Could not read save file: " + filepath).c_str());
+            return false;
+        }
         input_file.close();
-        LogMessage(LOG_INFO_LEVEL, ("Read " + std::to_string(xor_encrypted_bytes.size()) + " bytes from file.").c_str());
+        LogMessage(LOG_INFO_LEVEL, ("Read " + std::to_string(file_bytes.size()) + " bytes from file.").c_str());
+    } catch (const std::exception& e) {
+        LogMessage(LOG_ERROR_LEVEL, ("Error reading save file: " + std::string(e.what())).c_str());
+        return false;
+    }
+    return LoadSaveFromMemory(file_bytes, filepath);
+}
+
+// --- LoadSaveFromMemory Implementation ---
+bool SaveGameManager::LoadSaveFromMemory(std::string& json_str, const std::string& sourcePath) {
+    UnloadSave();
+    if (json_str.size() > MAX_SAVE_FILE_BYTES) {
+        LogMessage(LOG_ERROR_LEVEL, ("Save data is larger than the " + std::to_string(MAX_SAVE_FILE_BYTES) + " byte limit.").c_str());
+        return false;
+    }
 
-        // 2. XOR decrypt the bytes to get the raw JSON string
-        std::string json_str = XORDecryptEncrypt(std::string(xor_encrypted_bytes.begin(), xor_encrypted_bytes.end()), XOR_KEY);
-        LogMessage(LOG_INFO_LEVEL, "XOR decrypted save file. Data is now raw JSON.");
+    try {
+        // 2. Detect the encoding and decode the bytes in place to get the raw JSON string
+        SaveCodec codec;
+        if (!DetectSaveCodec(json_str.data(), json_str.size(), codec)) {
+            LogMessage(LOG_ERROR_LEVEL, "Could not recognize the save file encoding (not JSON, XOR-encoded JSON, or a recoverable XOR key).");
+            return false;
+        }
+        DecodeSaveBytes(codec, json_str);
+        LogMessage(LOG_INFO_LEVEL, ("Decoded save file as " + codec.Describe() + ". Data is now raw JSON.").c_str());
+
+        // 3. Reject pathological nesting up front. The parser copes, but serializing and validating recurse
+        // once per level, so a hostile file could otherwise overflow the stack long after loading.
+        size_t depth = MeasureJsonNestingDepth(json_str, MAX_SAVE_NESTING_DEPTH);
+        if (depth > MAX_SAVE_NESTING_DEPTH) {
+            LogMessage(LOG_ERROR_LEVEL, ("Save data nests deeper than the limit of " + std::to_string(MAX_SAVE_NESTING_DEPTH) + " levels.").c_str());
+            return false;
+        }
 
-        // 3. Parse the JSON string
-        m_saveData = nlohmann::json::parse(json_str);
-        m_currentSaveFilePath = filepath;
+        // 4. Parse the JSON string, sharing one buffer among equal strings (keys and timestamps repeat
+        // in every entry of a section)
+        {
+            ScopedStringInterning interning(m_stringPool);
+            m_saveData = SaveJson::parse(json_str);
+        }
+        if (!m_saveData.is_object()) {
+            LogMessage(LOG_ERROR_LEVEL, "Save data is not a JSON object.");
+            m_saveData = SaveJson();
+            return false;
+        }
+        m_codec = codec;
+        m_currentSaveFilePath = sourcePath;
         m_isSaveFileLoaded = true;
         LogMessage(LOG_INFO_LEVEL, "Save file JSON parsed successfully.");
+        RecordSourceFingerprint();
+        BeginJournal();
+        PublishLoadState(SAVE_CHANGE_LOADED);
         return true;
 
-    } catch (const nlohmann::json::parse_error& e) {
+    } catch (const SaveJson::parse_error& e) {
         LogMessage(LOG_ERROR_LEVEL, ("JSON parse error during load: " + std::string(e.what())).c_str());
     } catch (const std::runtime_error& e) {
         LogMessage(LOG_ERROR_LEVEL, ("Runtime error during load: " + std::string(e.what())).c_str());
@@ -183,6 +211,44 @@ bool SaveGameManager::LoadSaveFile(const std::string& filepath) {
     return false;
 }
 
+// --- AdoptSave Implementation ---
+bool SaveGameManager::AdoptSave(SaveGameManager& source) {
+    UnloadSave();
+    if (!source.m_isSaveFileLoaded) {
+        LogMessage(LOG_WARNING_LEVEL, "Attempted to adopt a save, but the source has no save loaded.");
+        return false;
+    }
+    source.m_journal.Discard();
+    // The data and the pool its strings were interned in move together; this manager's emptied ones go back.
+    m_saveData.swap(source.m_saveData);
+    m_stringPool.Swap(source.m_stringPool);
+    m_codec = source.m_codec;
+    m_currentSaveFilePath.swap(source.m_currentSaveFilePath);
+    m_sourceSize = source.m_sourceSize;
+    m_sourceWriteTime = source.m_sourceWriteTime;
+    source.m_isSaveFileLoaded = false;
+    m_isSaveFileLoaded = true;
+    LogMessage(LOG_INFO_LEVEL, ("Adopted loaded save file: " + m_currentSaveFilePath).c_str());
+    BeginJournal();
+    PublishLoadState(SAVE_CHANGE_LOADED);
+    return true;
+}
+
+// Reads the size and write time of the file just loaded or written, which journals and snapshots keep.
+void SaveGameManager::RecordSourceFingerprint() {
+    if (!EditJournal::GetSourceFingerprint(m_currentSaveFilePath, m_sourceSize, m_sourceWriteTime)) {
+        m_sourceSize = 0;
+        m_sourceWriteTime = 0;
+        if (!m_journalPath.empty()) {
+            LogMessage(LOG_WARNING_LEVEL, ("Could not read the source save file's size and time for the edit journal: " + m_currentSaveFilePath).c_str());
+        }
+    }
+}
+
+bool SaveGameManager::BeginJournal() {
+    return !m_journalPath.empty() && m_journal.Begin(m_journalPath, m_currentSaveFilePath, m_sourceSize, m_sourceWriteTime);
+}
+
 // --- WriteSaveFile Implementation ---
 // Modified to return the backup file path on success via an output parameter.
 bool SaveGameManager::WriteSaveFile(std::string& out_backup_filepath) {
@@ -193,6 +259,21 @@ bool SaveGameManager::WriteSaveFile(std::string& out_backup_filepath) {
         LogMessage(LOG_WARNING_LEVEL, "Attempted to write save file, but no file is loaded or path is empty.");
         return false;
     }
+    if (IsSaveArchivePath(m_currentSaveFilePath)) {
+        LogMessage(LOG_ERROR_LEVEL, ("Saves loaded from an archive are read-only; extract it to edit: " + m_currentSaveFilePath).c_str());
+        return false;
+    }
+
+    // Validate the edited data before anything on disk is touched, so a malformed entry is caught here
+    // rather than when the game fails to load the save.
+    SchemaValidationResult validation = m_schema.Validate(m_saveData);
+    if (!validation.IsValid()) {
+        for (const auto& message : validation.messages) {
+            LogMessage(LOG_ERROR_LEVEL, ("Schema violation: " + message).c_str());
+        }
+        LogMessage(LOG_ERROR_LEVEL, ("Refusing to write save file: " + std::to_string(validation.errorCount) + " schema violation(s) found.").c_str());
+        return false;
+    }
 
     LogMessage(LOG_INFO_LEVEL, ("Attempting to write save file: " + m_currentSaveFilePath).c_str());
     try {
@@ -211,30 +292,22 @@ bool SaveGameManager::WriteSaveFile(std::string& out_backup_filepath) {
         }
         std::filesystem::create_directories(backup_dir); // Ensure the chosen backup directory exists
 
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        std::tm tm_buf;
-        localtime_s(&tm_buf, &now_c); // Use localtime_s for thread safety on Windows
+        char timestamp[COMPACT_TIMESTAMP_LENGTH];
+        FormatCompactTimestamp(CurrentLocalTimestamp(), timestamp);
 
-        std::stringstream ss;
-        ss << std::put_time(&tm_buf, "%Y%m%d_%H%M%S");
-        std::string timestamp = ss.str();
-
-        std::string backup_filename = original_path.stem().string() + "_" + timestamp + original_path.extension().string();
+        std::string backup_filename = original_path.stem().string() + "_" +
+            std::string(timestamp, COMPACT_TIMESTAMP_LENGTH) + original_path.extension().string();
         std::filesystem::path backup_path = backup_dir / backup_filename;
 
         // Copy original file to backup location
         std::filesystem::copy(original_path, backup_path, std::filesystem::copy_options::overwrite_existing);
         LogMessage(LOG_INFO_LEVEL, ("Original save file backed up to: " + backup_path.string()).c_str());
 
-        // 2. Serialize the modified JSON data to a string
-        std::string json_to_write_str = m_saveData.dump(); // No pretty printing for smaller size
-        LogMessage(LOG_INFO_LEVEL, "Serialized JSON data.");
-
-        // 3. XOR encrypt the JSON string
-        std::string xor_encrypted_str = XORDecryptEncrypt(json_to_write_str, XOR_KEY);
-        std::vector<unsigned char> final_bytes(xor_encrypted_str.begin(), xor_encrypted_str.end());
-        LogMessage(LOG_INFO_LEVEL, "XOR encrypted JSON data.");
+        // 2-3. Serialize the modified JSON data (no pretty printing, for smaller size) and encode it with
+        // the codec the file was loaded with, in one pass over the text
+        std::string json_to_write_str;
+        EncodeSaveJson(m_saveData, m_codec, json_to_write_str);
+        LogMessage(LOG_INFO_LEVEL, ("Serialized JSON data and encoded it as " + m_codec.Describe() + ".").c_str());
 
         // 4. Write the final bytes to the original save file path
         std::ofstream output_file(m_currentSaveFilePath, std::ios::binary | std::ios::trunc); // trunc to overwrite
@@ -242,12 +315,15 @@ bool SaveGameManager::WriteSaveFile(std::string& out_backup_filepath) {
             LogMessage(LOG_ERROR_LEVEL, ("Could not open save file for writing: " + m_currentSaveFilePath).c_str());
             return false;
         }
-        output_file.write(reinterpret_cast<const char*>(final_bytes.data()), final_bytes.size());
+        output_file.write(json_to_write_str.data(), json_to_write_str.size());
         output_file.close();
         
         // On success, populate the output parameter with the backup file path
         out_backup_filepath = backup_path.string();
         LogMessage(LOG_INFO_LEVEL, ("Modified save file written successfully to: " + m_currentSaveFilePath).c_str());
+        // The edits are on disk now; further edits are journaled against the written file.
+        RecordSourceFingerprint();
+        BeginJournal();
         return true;
 
     } catch (const std::exception& e) {
@@ -257,6 +333,256 @@ bool SaveGameManager::WriteSaveFile(std::string& out_backup_filepath) {
     }
 }
 
+// --- LoadSchemaFile Implementation ---
+bool SaveGameManager::LoadSchemaFile(const std::string& filepath) {
+    try {
+        std::ifstream schema_file(filepath);
+        if (!schema_file) {
+            LogMessage(LOG_ERROR_LEVEL, ("Could not open schema file: " + filepath).c_str());
+            return false;
+        }
+        m_schema = CompiledSaveSchema(SaveJson::parse(schema_file));
+        LogMessage(LOG_INFO_LEVEL, ("Loaded save schema from: " + filepath).c_str());
+        return true;
+    } catch (const std::exception& e) {
+        LogMessage(LOG_ERROR_LEVEL, ("Failed to load save schema " + filepath + ": " + e.what()).c_str());
+    }
+    return false;
+}
+
+// --- Edit Journal ---
+void SaveGameManager::EnableEditJournal(const std::string& journalPath) {
+    m_journalPath = journalPath;
+}
+
+void SaveGameManager::DiscardEditJournal() {
+    m_journal.Discard();
+}
+
+void SaveGameManager::ApplyJournalEntry(const JournalEntry& entry, sqlite3* db) {
+    switch (entry.op) {
+        case JOURNAL_OP_SET_GOLD:               SetGold(entry.value); break;
+        case JOURNAL_OP_SET_BEI:                SetBei(entry.value); break;
+        case JOURNAL_OP_SET_ARTISANS_FLAME:     SetArtisansFlame(entry.value); break;
+        case JOURNAL_OP_SET_FOLLOWER_COUNT:     SetFollowerCount(entry.value); break;
+        case JOURNAL_OP_MAX_OWN_INGREDIENTS:    MaxOwnIngredients(db); break;
+        case JOURNAL_OP_MAX_ALL_INGREDIENTS:    MaxAllIngredients(db); break;
+        case JOURNAL_OP_MAX_OWN_MATERIALS:      MaxOwnMaterials(db); break;
+        case JOURNAL_OP_MAX_OWN_STAFF_LEVEL:    MaxOwnStaffLevel(); break;
+        case JOURNAL_OP_SET_INGREDIENT_COUNT:
+        case JOURNAL_OP_SET_MATERIAL_COUNT:
+        case JOURNAL_OP_SET_INGREDIENT_PARENT:  ReplayItemCounts(&entry, 1); break;
+        case JOURNAL_OP_SET_INGREDIENT_GAIN_TIME: SetIngredientGainTimes(SaveTimestamp::FromSortKey(static_cast<uint64_t>(entry.value))); break;
+        default:
+            LogMessage(LOG_WARNING_LEVEL, ("Skipping unknown journal operation " + std::to_string(entry.op) + ".").c_str());
+            break;
+    }
+}
+
+bool SaveGameManager::LoadRecoverySource(const JournalContents& journal) {
+    LogMessage(LOG_INFO_LEVEL, ("Recovering " + std::to_string(journal.entries.size()) + " journaled edits to " + journal.sourcePath).c_str());
+
+    // Load with journaling off, so the journal being recovered stays intact until replay is done.
+    std::string journal_path;
+    journal_path.swap(m_journalPath);
+    bool loaded = LoadSaveFile(journal.sourcePath);
+    m_journalPath.swap(journal_path);
+    if (!loaded) {
+        LogMessage(LOG_ERROR_LEVEL, "Session recovery failed: the source save file could not be loaded.");
+    }
+    return loaded;
+}
+
+void SaveGameManager::ReplayJournal(const JournalContents& journal, const std::function<sqlite3*(uint32_t)>& databaseFor) {
+    auto start = std::chrono::steady_clock::now();
+    // No journal is active yet, so the replayed edits are not recorded twice. A run of count records (one
+    // count import) is applied in one batch, as the import was; counts need no reference data.
+    const std::vector<JournalEntry>& entries = journal.entries;
+    for (size_t i = 0; i < entries.size();) {
+        size_t run = i;
+        while (run < entries.size() && IsJournalItemCountOp(entries[run].op)) {
+            ++run;
+        }
+        if (run > i) {
+            ReplayItemCounts(&entries[i], run - i);
+            i = run;
+        } else {
+            ApplyJournalEntry(entries[i], databaseFor(entries[i].catalogVersion));
+            ++i;
+        }
+    }
+
+    // Continue the recovered session in a fresh journal holding the replayed edits.
+    if (BeginJournal()) {
+        for (const JournalEntry& entry : journal.entries) {
+            m_journal.Append(entry);
+        }
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LogMessage(LOG_INFO_LEVEL, ("Session recovered in " + std::to_string(elapsed_ms) + " ms.").c_str());
+}
+
+// --- Session Snapshots ---
+// A snapshot is SESSION_SNAPSHOT_MAGIC, the size of the CBOR that follows once inflated (64-bit,
+// little-endian), then that CBOR deflated. The CBOR is an array of three: a header, the journal's
+// records flattened into operation, value and catalog version triples, and the save data.
+static const char SESSION_SNAPSHOT_MAGIC[4] = { 'D', 'S', 'S', 'N' };
+static const int SESSION_SNAPSHOT_VERSION = 2;
+static const size_t SESSION_SNAPSHOT_PREFIX_BYTES = sizeof(SESSION_SNAPSHOT_MAGIC) + sizeof(uint64_t);
+
+bool SaveGameManager::WriteSessionSnapshot(std::vector<unsigned char>& out_snapshot, std::string& out_error) const {
+    out_snapshot.clear();
+    if (!m_isSaveFileLoaded) {
+        out_error = "No save file is loaded.";
+        return false;
+    }
+    SaveJson header = SaveJson::object();
+    header["version"] = SESSION_SNAPSHOT_VERSION;
+    header["source"] = m_currentSaveFilePath;
+    header["codec"] = static_cast<int>(m_codec.type);
+    header["key"] = SaveJson::binary(SaveJson::binary_t::container_type(m_codec.key.begin(), m_codec.key.end()));
+    header["recovered"] = m_codec.recovered;
+    header["sourceSize"] = m_sourceSize;
+    header["sourceWriteTime"] = m_sourceWriteTime;
+    SaveJson journal = SaveJson::array();
+    JournalContents contents;
+    if (m_journal.IsActive() && EditJournal::Read(m_journalPath, contents)) {
+        for (const JournalEntry& entry : contents.entries) {
+            journal.push_back(static_cast<uint32_t>(entry.op));
+            journal.push_back(entry.value);
+            journal.push_back(entry.catalogVersion);
+        }
+    }
+
+    // The array's initial byte, then its elements each written on their own, so the save data is
+    // serialized in place rather than copied into a wrapper document.
+    std::string cbor;
+    cbor.push_back(static_cast<char>(0x83));
+    SaveJson::to_cbor(header, cbor);
+    SaveJson::to_cbor(journal, cbor);
+    SaveJson::to_cbor(m_saveData, cbor);
+    // Large saves are deflated in parallel blocks, which still inflate as one zlib stream.
+    std::vector<unsigned char> deflated;
+    try {
+        deflated = ParallelCompressZlib(cbor, Z_BEST_SPEED);
+    } catch (const std::runtime_error& e) {
+        out_error = e.what();
+        return false;
+    }
+    const uint64_t cbor_size = cbor.size();
+    out_snapshot.reserve(SESSION_SNAPSHOT_PREFIX_BYTES + deflated.size());
+    out_snapshot.insert(out_snapshot.end(), SESSION_SNAPSHOT_MAGIC, SESSION_SNAPSHOT_MAGIC + sizeof(SESSION_SNAPSHOT_MAGIC));
+    for (int shift = 0; shift < 64; shift += 8) {
+        out_snapshot.push_back(static_cast<unsigned char>(cbor_size >> shift));
+    }
+    out_snapshot.insert(out_snapshot.end(), deflated.begin(), deflated.end());
+    return true;
+}
+
+bool SaveGameManager::RestoreSessionSnapshot(const std::vector<unsigned char>& snapshot, std::string& out_error) {
+    UnloadSave();
+    if (snapshot.size() < SESSION_SNAPSHOT_PREFIX_BYTES || memcmp(snapshot.data(), SESSION_SNAPSHOT_MAGIC, sizeof(SESSION_SNAPSHOT_MAGIC)) != 0) {
+        out_error = "Not a session snapshot.";
+        return false;
+    }
+    uint64_t cbor_size = 0;
+    for (int i = 7; i >= 0; --i) {
+        cbor_size = (cbor_size << 8) | snapshot[sizeof(SESSION_SNAPSHOT_MAGIC) + i];
+    }
+    if (cbor_size == 0 || cbor_size > MAX_SAVE_FILE_BYTES) {
+        out_error = "Session snapshot is empty or larger than the " + std::to_string(MAX_SAVE_FILE_BYTES) + " byte limit.";
+        return false;
+    }
+    std::string cbor;
+    if (!ZlibDecompress(snapshot.data() + SESSION_SNAPSHOT_PREFIX_BYTES, snapshot.size() - SESSION_SNAPSHOT_PREFIX_BYTES,
+                        static_cast<size_t>(cbor_size), cbor, out_error, ZLIB_WINDOW_BITS, static_cast<size_t>(cbor_size))) {
+        return false;
+    }
+
+    SaveJson session;
+    {
+        ScopedStringInterning interning(m_stringPool);
+        if (!ReadSaveJsonCbor(cbor.data(), cbor.size(), MAX_SAVE_NESTING_DEPTH + 1, session, out_error)) {
+            return false;
+        }
+    }
+    if (!session.is_array() || session.size() != 3 || !session[0].is_object() || !session[1].is_array() || !session[2].is_object() ||
+        session[0].value("version", 0) != SESSION_SNAPSHOT_VERSION || !session[0]["source"].is_string() ||
+        !session[0]["key"].is_binary() || !session[0]["sourceSize"].is_number_integer() ||
+        !session[0]["sourceWriteTime"].is_number_integer() || session[1].size() % 3 != 0 ||
+        !std::all_of(session[1].cbegin(), session[1].cend(), [](const SaveJson& record) { return record.is_number_integer(); })) {
+        out_error = "Session snapshot is malformed or from another version.";
+        return false;
+    }
+    const SaveJson& header = session[0];
+    m_codec.type = header.value("codec", 0) == SAVE_CODEC_PLAIN_JSON ? SAVE_CODEC_PLAIN_JSON : SAVE_CODEC_XOR;
+    m_codec.key.assign(header["key"].get_binary().begin(), header["key"].get_binary().end());
+    m_codec.recovered = header.value("recovered", false);
+    m_currentSaveFilePath = header["source"].get<std::string>();
+    // The journal is matched against the file as it was when the session was loaded, not as it is now.
+    m_sourceSize = header["sourceSize"].get<uint64_t>();
+    m_sourceWriteTime = header["sourceWriteTime"].get<int64_t>();
+    m_saveData = std::move(session[2]);
+    m_isSaveFileLoaded = true;
+
+    const SaveJson& journal = session[1];
+    if (BeginJournal()) {
+        for (size_t i = 0; i < journal.size(); i += 3) {
+            JournalEntry entry;
+            entry.op = static_cast<JournalOp>(journal[i].get<uint32_t>());
+            entry.value = journal[i + 1].get<long long>();
+            entry.catalogVersion = journal[i + 2].get<uint32_t>();
+            m_journal.Append(entry);
+        }
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Session restored from snapshot with " + std::to_string(journal.size() / 3) + " journaled edit(s): " + m_currentSaveFilePath).c_str());
+    PublishLoadState(SAVE_CHANGE_LOADED);
+    return true;
+}
+
+// Heap bytes of a string's buffer, if the string has one to itself.
+static size_t EstimateStringHeapBytes(const SaveJson::string_t& text) {
+    return text.capacity() > SaveJson::string_t::INLINE_CAPACITY && !text.IsShared() ? sizeof(PooledStringBuffer) + text.capacity() + 1 : 0;
+}
+
+// Heap bytes under a value: the nodes and storage of its containers and its unshared string buffers.
+static size_t EstimateJsonHeapBytes(const SaveJson& value) {
+    size_t bytes = 0;
+    switch (value.type()) {
+        case SaveJson::value_t::object: {
+            const SaveJson::object_t& object = value.get_ref<const SaveJson::object_t&>();
+            bytes = sizeof(object) + object.capacity() * sizeof(SaveJson::object_t::value_type);
+            for (const auto& member : object) {
+                bytes += EstimateStringHeapBytes(member.first) + EstimateJsonHeapBytes(member.second);
+            }
+            break;
+        }
+        case SaveJson::value_t::array: {
+            const SaveJson::array_t& array = value.get_ref<const SaveJson::array_t&>();
+            bytes = sizeof(array) + array.capacity() * sizeof(SaveJson);
+            for (const SaveJson& element : array) {
+                bytes += EstimateJsonHeapBytes(element);
+            }
+            break;
+        }
+        case SaveJson::value_t::string:
+            bytes = sizeof(SaveJson::string_t) + EstimateStringHeapBytes(value.get_ref<const SaveJson::string_t&>());
+            break;
+        case SaveJson::value_t::binary:
+            bytes = sizeof(SaveJson::binary_t) + value.get_binary().capacity();
+            break;
+        default:
+            break;
+    }
+    return bytes;
+}
+
+size_t SaveGameManager::EstimateMemoryUsage() const {
+    // Interned buffers are shared, so they are counted once, from the pool.
+    return EstimateJsonHeapBytes(m_saveData) + m_stringPool.GetBytes() + m_stringPool.GetCount() * (sizeof(PooledStringBuffer) + 1);
+}
+
 // --- Player Stats Getters ---
 long long SaveGameManager::GetGold() const {
     if (m_isSaveFileLoaded && m_saveData.contains("PlayerInfo") && m_saveData["PlayerInfo"].is_object() && m_saveData["PlayerInfo"].contains("m_Gold")) {
@@ -287,10 +613,46 @@ long long SaveGameManager::GetFollowerCount() const {
 }
 
 
+// --- Change Notifications ---
+// Unobserved edits assign directly: no comparison, no copies, no path string.
+void SaveGameManager::SetSaveValue(SaveJson& slot, SaveJson value, const char* section, std::string_view key, const char* field) {
+    if (!m_changes.HasSubscribers()) {
+        slot = std::move(value);
+        return;
+    }
+    if (slot == value) {
+        return; // Unchanged values are not news; subscribers refresh only what differs.
+    }
+    SaveChangeEvent event;
+    event.kind = SAVE_CHANGE_VALUE;
+    event.path = MakeSaveChangePath(section, key, field);
+    event.oldValue = std::move(slot);
+    slot = std::move(value);
+    event.newValue = slot;
+    m_changes.Publish(event);
+}
+
+void SaveGameManager::SetSaveValue(SaveJson& slot, SaveJson value, const char* section, size_t index, const char* field) {
+    if (!m_changes.HasSubscribers()) {
+        slot = std::move(value);
+        return;
+    }
+    SetSaveValue(slot, std::move(value), section, std::to_string(index), field);
+}
+
+void SaveGameManager::PublishLoadState(SaveChangeKind kind) {
+    if (m_changes.HasSubscribers()) {
+        SaveChangeEvent event;
+        event.kind = kind;
+        m_changes.Publish(event);
+    }
+}
+
 // --- Player Stats Setters ---
 void SaveGameManager::SetGold(long long value) {
+    m_journal.Append(JOURNAL_OP_SET_GOLD, value);
     if (m_isSaveFileLoaded && m_saveData.contains("PlayerInfo") && m_saveData["PlayerInfo"].is_object()) {
-        m_saveData["PlayerInfo"]["m_Gold"] = std::min(value, SAVE_MAX_CURRENCY);
+        SetSaveValue(m_saveData["PlayerInfo"]["m_Gold"], std::min(value, SAVE_MAX_CURRENCY), "PlayerInfo", "m_Gold", NULL);
         LogMessage(LOG_INFO_LEVEL, ("Gold set to: " + std::to_string(m_saveData["PlayerInfo"]["m_Gold"].get<long long>())).c_str());
     } else {
         LogMessage(LOG_WARNING_LEVEL, "Attempted to set gold, but PlayerInfo section not found or invalid.");
@@ -298,8 +660,9 @@ void SaveGameManager::SetGold(long long value) {
 }
 
 void SaveGameManager::SetBei(long long value) {
+    m_journal.Append(JOURNAL_OP_SET_BEI, value);
     if (m_isSaveFileLoaded && m_saveData.contains("PlayerInfo") && m_saveData["PlayerInfo"].is_object()) {
-        m_saveData["PlayerInfo"]["m_Bei"] = std::min(value, SAVE_MAX_CURRENCY);
+        SetSaveValue(m_saveData["PlayerInfo"]["m_Bei"], std::min(value, SAVE_MAX_CURRENCY), "PlayerInfo", "m_Bei", NULL);
         LogMessage(LOG_INFO_LEVEL, ("Bei set to: " + std::to_string(m_saveData["PlayerInfo"]["m_Bei"].get<long long>())).c_str());
     } else {
         LogMessage(LOG_WARNING_LEVEL, "Attempted to set bei, but PlayerInfo section not found or invalid.");
@@ -307,8 +670,9 @@ void SaveGameManager::SetBei(long long value) {
 }
 
 void SaveGameManager::SetArtisansFlame(long long value) {
+    m_journal.Append(JOURNAL_OP_SET_ARTISANS_FLAME, value);
     if (m_isSaveFileLoaded && m_saveData.contains("PlayerInfo") && m_saveData["PlayerInfo"].is_object()) {
-        m_saveData["PlayerInfo"]["m_ChefFlame"] = std::min(value, SAVE_MAX_CURRENCY);
+        SetSaveValue(m_saveData["PlayerInfo"]["m_ChefFlame"], std::min(value, SAVE_MAX_CURRENCY), "PlayerInfo", "m_ChefFlame", NULL);
         LogMessage(LOG_INFO_LEVEL, ("Artisan's Flame set to: " + std::to_string(m_saveData["PlayerInfo"]["m_ChefFlame"].get<long long>())).c_str());
     } else {
         LogMessage(LOG_WARNING_LEVEL, "Attempted to set artisan's flame, but PlayerInfo section not found or invalid.");
@@ -316,8 +680,9 @@ void SaveGameManager::SetArtisansFlame(long long value) {
 }
 
 void SaveGameManager::SetFollowerCount(long long value) {
+    m_journal.Append(JOURNAL_OP_SET_FOLLOWER_COUNT, value);
     if (m_isSaveFileLoaded && m_saveData.contains("SNSInfo") && m_saveData["SNSInfo"].is_object()) {
-        m_saveData["SNSInfo"]["m_Follow_Count"] = value;
+        SetSaveValue(m_saveData["SNSInfo"]["m_Follow_Count"], value, "SNSInfo", "m_Follow_Count", NULL);
         LogMessage(LOG_INFO_LEVEL, ("Follower count set to: " + std::to_string(m_saveData["SNSInfo"]["m_Follow_Count"].get<long long>())).c_str());
     } else {
         LogMessage(LOG_WARNING_LEVEL, "Attempted to set follower count, but SNSInfo section not found or invalid.");
@@ -344,103 +709,47 @@ static int GetDesiredMaxCountForTier(int item_db_max_count) {
     }
 }
 
-// Save JSON to file named save_dump.txt
-void DumpSaveDataToFile(const nlohmann::json& m_saveData) {
-    // Get the directory where the executable is running
-    std::filesystem::path exePath = std::filesystem::current_path();
-    std::filesystem::path outputPath = exePath / "save_dump.txt";
-
-    try {
-        // Open file in truncate mode (overwrite if it exists)
-        std::ofstream outFile(outputPath, std::ios::out | std::ios::trunc);
-        if (!outFile) {
-            LogMessage(LOG_ERROR_LEVEL, "Failed to open save_dump.txt for writing.");
-            return;
+// Looks up the MaxCount of the first item, in TID order, whose indexed column equals id: from the item
+// catalog if one is set, otherwise with stmt ("SELECT MaxCount FROM Items WHERE <column> = ?").
+bool SaveGameManager::LookupItemMaxCount(sqlite3_stmt* stmt, ItemCatalogIndex index, int id, int& out_max_count) const {
+    if (m_catalog) {
+        ItemCatalogRows rows = m_catalog->Find(index, id);
+        if (rows.count == 0) {
+            return false;
         }
-
-        // Write formatted JSON
-        outFile << m_saveData.dump(4);  // 4 = indent size
-        outFile.close();
-
-        LogMessage(LOG_INFO_LEVEL, "Successfully wrote save data to save_dump.txt");
-    } catch (const std::exception& ex) {
-        LogMessage(LOG_ERROR_LEVEL, ex.what());
-    }
-}
-
-// Dump db
-void DumpSQLiteToText(sqlite3* db, const std::string& outputFilePath) {
-    std::ofstream out(outputFilePath);
-    if (!out.is_open()) {
-        std::cerr << "Could not open file: " << outputFilePath << std::endl;
-        return;
+        out_max_count = m_catalog->GetInt(CATALOG_ITEM_MAX_COUNT, rows.rows[0]);
+        return true;
     }
-
-    sqlite3_stmt* stmt;
-    const char* sql = "SELECT name FROM sqlite_master WHERE type='table';";
-
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string tableName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            out << "== Table: " << tableName << " ==\n";
-
-            std::string dataQuery = "SELECT * FROM " + tableName + ";";
-            sqlite3_stmt* dataStmt;
-
-            if (sqlite3_prepare_v2(db, dataQuery.c_str(), -1, &dataStmt, nullptr) == SQLITE_OK) {
-                int cols = sqlite3_column_count(dataStmt);
-
-                // 🆕 Write column headers before any rows
-                for (int i = 0; i < cols; ++i) {
-                    const char* colName = sqlite3_column_name(dataStmt, i);
-                    out << (colName ? colName : "NULL") << (i < cols - 1 ? " | " : "");
-                }
-                out << "\n";
-
-                // Write each row of data
-                while (sqlite3_step(dataStmt) == SQLITE_ROW) {
-                    for (int i = 0; i < cols; ++i) {
-                        const char* colText = reinterpret_cast<const char*>(sqlite3_column_text(dataStmt, i));
-                        out << (colText ? colText : "NULL") << (i < cols - 1 ? " | " : "");
-                    }
-                    out << "\n";
-                }
-
-                sqlite3_finalize(dataStmt);
-            } else {
-                out << "Failed to query table: " << tableName << "\n";
-            }
-
-            out << "\n";
-        }
-        sqlite3_finalize(stmt);
-    } else {
-        out << "Failed to list tables\n";
+    sqlite3_reset(stmt); // Reset statement for reuse in each lookup
+    sqlite3_bind_int(stmt, 1, id);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
     }
-
-    out.close();
+    out_max_count = sqlite3_column_int(stmt, 0);
+    return true;
 }
 
 // --- MaxOwnIngredients Implementation ---
 void SaveGameManager::MaxOwnIngredients(sqlite3* db) {
+    m_journal.Append(JOURNAL_OP_MAX_OWN_INGREDIENTS, 0);
     if (!m_isSaveFileLoaded || !m_saveData.contains("Ingredients") || !m_saveData["Ingredients"].is_object()) {
         LogMessage(LOG_WARNING_LEVEL, "No save file loaded or 'Ingredients' section not found/invalid for MaxOwnIngredients.");
         return;
     }
-    if (!db) {
+    if (!db && !m_catalog) {
         LogMessage(LOG_ERROR_LEVEL, "Database handle (g_refDb) is null for MaxOwnIngredients.");
         return;
     }
 
-    nlohmann::json& ingredients_json_map = m_saveData["Ingredients"];
+    SaveJson& ingredients_json_map = m_saveData["Ingredients"];
     
     int updated_count = 0;
     int skipped_count = 0; // Counter for items skipped due to rules or issues
 
     // SQL to get MaxCount for an ingredient ID
-    sqlite3_stmt *stmt = nullptr; // Prepare statement once outside the loop
+    sqlite3_stmt *stmt = nullptr; // Prepare statement once outside the loop (not needed with an item catalog)
     std::string sql = "SELECT MaxCount FROM Items WHERE ItemDataID = ?;";
-    int rc_prepare = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
+    int rc_prepare = m_catalog ? SQLITE_OK : sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
     if (rc_prepare != SQLITE_OK) {
         LogMessage(LOG_ERROR_LEVEL, ("SQL prepare failed for MaxOwnIngredients: " + std::string(sqlite3_errmsg(db))).c_str());
         return; // Exit if prepare fails
@@ -451,14 +760,9 @@ void SaveGameManager::MaxOwnIngredients(sqlite3* db) {
         if (it.value().contains("ingredientsID") && it.value()["ingredientsID"].is_number_integer()) {
             int ingredients_id = it.value()["ingredientsID"].get<int>();
 
-            sqlite3_reset(stmt); // Reset statement for reuse in each iteration
-            sqlite3_bind_int(stmt, 1, ingredients_id);
-
             int max_count_from_db = 0; // Initialize to 0; will be retrieved from DB
-            if (sqlite3_step(stmt) == SQLITE_ROW) {
-                max_count_from_db = sqlite3_column_int(stmt, 0);
-            } else {
-                it.value()["count"] = 1;
+            if (!LookupItemMaxCount(stmt, CATALOG_INDEX_ITEM_BY_DATA_ID, ingredients_id, max_count_from_db)) {
+                SetSaveValue(it.value()["count"], 1, "Ingredients", it.key(), "count");
                 LogMessage(LOG_WARNING_LEVEL, ("MaxCount not found for existing ingredient ID: " + std::to_string(ingredients_id) + " in Items table. Skipping update.").c_str());
                 skipped_count++; // Count as skipped due to DB lookup failure
                 continue; // Skip to next if item data not found
@@ -469,7 +773,7 @@ void SaveGameManager::MaxOwnIngredients(sqlite3* db) {
 
             if (target_count > 0 && it.value()["count"] < target_count) { // target_count == 0 indicates skipping
                 // Update the count to the determined target
-                it.value()["count"] = target_count;
+                SetSaveValue(it.value()["count"], target_count, "Ingredients", it.key(), "count");
                 updated_count++;
             } else {
                 // Item should be skipped (e.g., MaxCount == 1 or unhandled tier)
@@ -484,31 +788,29 @@ void SaveGameManager::MaxOwnIngredients(sqlite3* db) {
 
     sqlite3_finalize(stmt); // Clean up the prepared statement once after the loop
     LogMessage(LOG_INFO_LEVEL, ("MaxOwnIngredients: Updated " + std::to_string(updated_count) + " owned ingredients. Skipped " + std::to_string(skipped_count) + " ingredients.").c_str());
-    
-    DumpSaveDataToFile(m_saveData);
-    DumpSQLiteToText(db, "db_dump.txt");
 }
 
 // --- MaxOwnMaterials Implementation ---
 void SaveGameManager::MaxOwnMaterials(sqlite3* db) {
+    m_journal.Append(JOURNAL_OP_MAX_OWN_MATERIALS, 0);
     if (!m_isSaveFileLoaded || !m_saveData.contains("InventoryItemSlot") || !m_saveData["InventoryItemSlot"].is_object()) {
         LogMessage(LOG_WARNING_LEVEL, "No save file loaded or 'InventoryItemSlot' section not found/invalid for MaxOwnMaterials.");
         return;
     }
-    if (!db) {
+    if (!db && !m_catalog) {
         LogMessage(LOG_ERROR_LEVEL, "Database handle (g_refDb) is null for MaxOwnMaterials.");
         return;
     }
 
-    nlohmann::json& material_json_map = m_saveData["InventoryItemSlot"];
+    SaveJson& material_json_map = m_saveData["InventoryItemSlot"];
     
     int updated_count = 0;
     int skipped_count = 0; // Counter for items skipped due to rules or issues
 
     // SQL to get MaxCount for an Item ID
-    sqlite3_stmt *stmt_material = nullptr; // Prepare statement once outside the loop
+    sqlite3_stmt *stmt_material = nullptr; // Prepare statement once outside the loop (not needed with an item catalog)
     std::string sql_material = "SELECT MaxCount FROM Items WHERE TID = ?;";
-    int rc_prepare_material = sqlite3_prepare_v2(db, sql_material.c_str(), -1, &stmt_material, NULL);
+    int rc_prepare_material = m_catalog ? SQLITE_OK : sqlite3_prepare_v2(db, sql_material.c_str(), -1, &stmt_material, NULL);
     if (rc_prepare_material != SQLITE_OK) {
         LogMessage(LOG_ERROR_LEVEL, ("SQL prepare failed for MaxOwnMaterial: " + std::string(sqlite3_errmsg(db))).c_str());
         return; // Exit if prepare fails
@@ -519,14 +821,9 @@ void SaveGameManager::MaxOwnMaterials(sqlite3* db) {
         if (it.value().contains("itemID") && it.value()["itemID"].is_number_integer()) {
             int material_id = it.value()["itemID"].get<int>();
 
-            sqlite3_reset(stmt_material); // Reset statement for reuse in each iteration
-            sqlite3_bind_int(stmt_material, 1, material_id);
-
             int max_count_from_db = 0; // Initialize to 0; will be retrieved from DB
-            if (sqlite3_step(stmt_material) == SQLITE_ROW) {
-                max_count_from_db = sqlite3_column_int(stmt_material, 0);
-            } else {
-                it.value()["totalCount"] = 1;
+            if (!LookupItemMaxCount(stmt_material, CATALOG_INDEX_ITEM_BY_TID, material_id, max_count_from_db)) {
+                SetSaveValue(it.value()["totalCount"], 1, "InventoryItemSlot", it.key(), "totalCount");
                 LogMessage(LOG_WARNING_LEVEL, ("MaxCount not found for existing TID: " + std::to_string(material_id) + " in Items table. Skipping update.").c_str());
                 skipped_count++; // Count as skipped due to DB lookup failure
                 continue; // Skip to next if item data not found
@@ -537,7 +834,7 @@ void SaveGameManager::MaxOwnMaterials(sqlite3* db) {
 
             if (target_count > 0 && it.value()["totalCount"] < target_count) { // target_count == 0 indicates skipping
                 // Update the count to the determined target
-                it.value()["totalCount"] = target_count;
+                SetSaveValue(it.value()["totalCount"], target_count, "InventoryItemSlot", it.key(), "totalCount");
                 updated_count++;
             } else {
                 // Item should be skipped (e.g., MaxCount == 1 or unhandled tier)
@@ -552,32 +849,83 @@ void SaveGameManager::MaxOwnMaterials(sqlite3* db) {
 
     sqlite3_finalize(stmt_material); // Clean up the prepared statement once after the loop
     LogMessage(LOG_INFO_LEVEL, ("MaxOwnMaterial: Updated " + std::to_string(updated_count) + " owned material. Skipped " + std::to_string(skipped_count) + " material.").c_str());
-
-    // DumpSaveDataToFile(m_saveData);
-    // DumpSQLiteToText(db, "db_dump.txt");
 }
 
 // --- MaxOwnStaffLevel Implementation ---
 void SaveGameManager::MaxOwnStaffLevel() {
+    m_journal.Append(JOURNAL_OP_MAX_OWN_STAFF_LEVEL, 0);
     if (!m_isSaveFileLoaded || !m_saveData.contains("Staff")) {
         LogMessage(LOG_WARNING_LEVEL, "No save file loaded or 'Staff' section not found/invalid for MaxOwnStaffLevel.");
         return;
     }
 
     // Max All Staff Level
-    nlohmann::json& hired_staff_json_map = m_saveData["Staff"];
-    for (auto it = hired_staff_json_map.begin(); it != hired_staff_json_map.end(); ++it) {
+    SaveJson& hired_staff_json_map = m_saveData["Staff"];
+    size_t index = 0; // Entry key for change events when Staff is an array rather than an object.
+    for (auto it = hired_staff_json_map.begin(); it != hired_staff_json_map.end(); ++it, ++index) {
         std::string staff_name = it.value()["name"].get<std::string>();
 
         if(staff_name == "Staff_Dave"){
             continue;
         }
         if(it.value()["level"] < 20){
-            it.value()["level"] = 20;
+            if (hired_staff_json_map.is_object()) {
+                SetSaveValue(it.value()["level"], 20, "Staff", it.key(), "level");
+            } else {
+                SetSaveValue(it.value()["level"], 20, "Staff", index, "level");
+            }
         }
     }
 }
 
+// --- New Ingredient Entries ---
+// New entries copy the gain timestamps of the section's first entry, so they look like the others.
+// The timestamps are returned as JSON strings so every entry built from them shares their buffers.
+void SaveGameManager::GetNewIngredientTimestamps(const SaveJson& ingredients, SaveJson& out_gain_time, SaveJson& out_gain_game_time) const {
+    SaveTimestamp gain_time;
+    SaveTimestamp gain_game_time;
+    ParseSaveTimestamp("04/01/2025 12:34:56", SAVE_TIMESTAMP_LENGTH, gain_time);
+    ParseSaveTimestamp("10/03/2022 08:30:52", SAVE_TIMESTAMP_LENGTH, gain_game_time);
+
+    // If the ingredient map isn't empty, try to get timestamps from the first entry.
+    // Malformed timestamps are not propagated to new entries; the defaults are kept instead.
+    if (!ingredients.empty()) {
+        const SaveJson& first_item_value = ingredients.begin().value();
+        auto time_it = first_item_value.find("lastGainTime");
+        if (time_it != first_item_value.end() && time_it->is_string() &&
+            !ParseSaveTimestamp(time_it->get_ref<const SaveJson::string_t&>(), gain_time)) {
+            LogMessage(LOG_WARNING_LEVEL, "First ingredient has a malformed lastGainTime. Using the default.");
+        }
+        auto game_time_it = first_item_value.find("lastGainGameTime");
+        if (game_time_it != first_item_value.end() && game_time_it->is_string() &&
+            !ParseSaveTimestamp(game_time_it->get_ref<const SaveJson::string_t&>(), gain_game_time)) {
+            LogMessage(LOG_WARNING_LEVEL, "First ingredient has a malformed lastGainGameTime. Using the default.");
+        }
+    }
+    char gain_time_text[SAVE_TIMESTAMP_LENGTH];
+    char gain_game_time_text[SAVE_TIMESTAMP_LENGTH];
+    FormatSaveTimestamp(gain_time, gain_time_text);
+    FormatSaveTimestamp(gain_game_time, gain_game_time_text);
+    out_gain_time = SaveJson::string_t(gain_time_text, SAVE_TIMESTAMP_LENGTH);
+    out_gain_game_time = SaveJson::string_t(gain_game_time_text, SAVE_TIMESTAMP_LENGTH);
+    LogMessage(LOG_INFO_LEVEL, ("Using timestamps '" + std::string(gain_time_text, SAVE_TIMESTAMP_LENGTH) + "' / '" +
+                                std::string(gain_game_time_text, SAVE_TIMESTAMP_LENGTH) + "' for new ingredients.").c_str());
+}
+
+SaveJson SaveGameManager::MakeIngredientEntry(int ingredientsId, int parentId, int count, const SaveJson& gainTime, const SaveJson& gainGameTime) {
+    SaveJson entry;
+    entry["ingredientsID"] = ingredientsId;
+    entry["level"] = 1; // Default level
+    entry["parentID"] = parentId;
+    entry["count"] = count;
+    entry["branchCount"] = 0; // Default
+    entry["lastGainTime"] = gainTime;
+    entry["lastGainGameTime"] = gainGameTime;
+    entry["isNew"] = true; // Mark as new
+    entry["placeTagMask"] = 1; // Default
+    return entry;
+}
+
 // --- SQLite Callback for batch querying ingredients (for MaxAllIngredients) ---
 // This is a static function that can be accessed by sqlite3_exec
 static int callbackGetAllIngredients(void *data, int argc, char **argv, char **azColName){
@@ -593,36 +941,28 @@ static int callbackGetAllIngredients(void *data, int argc, char **argv, char **a
 
 // --- MaxAllIngredients Implementation ---
 void SaveGameManager::MaxAllIngredients(sqlite3* db) {
+    m_journal.Append(JOURNAL_OP_MAX_ALL_INGREDIENTS, 0);
     if (!m_isSaveFileLoaded) {
         LogMessage(LOG_WARNING_LEVEL, "No save file loaded for MaxAllIngredients.");
         return;
     }
-    if (!db) {
+    if (!db && !m_catalog) {
         LogMessage(LOG_ERROR_LEVEL, "Database handle (g_refDb) is null for MaxAllIngredients.");
         return;
     }
 
     if (!m_saveData.contains("Ingredients") || !m_saveData["Ingredients"].is_object()) {
         LogMessage(LOG_INFO_LEVEL, "Creating empty 'Ingredients' section in save data.");
-        m_saveData["Ingredients"] = nlohmann::json::object();
+        m_saveData["Ingredients"] = SaveJson::object();
     }
 
-    nlohmann::json& ingredients_json_map = m_saveData["Ingredients"];
+    SaveJson& ingredients_json_map = m_saveData["Ingredients"];
+    // New entries repeat the same keys and timestamps; intern them with the rest of the save's strings.
+    ScopedStringInterning interning(m_stringPool);
 
-    std::string default_lastGainTime = "04/01/2025 12:34:56";
-    std::string default_lastGainGameTime = "10/03/2022 08:30:52";
-
-    // If the ingredient map isn't empty, try to get a timestamp from the first entry.
-    if (!ingredients_json_map.empty()) {
-        auto& first_item_value = ingredients_json_map.begin().value();
-        if (first_item_value.contains("lastGainTime") && first_item_value["lastGainTime"].is_string()) {
-            default_lastGainTime = first_item_value["lastGainTime"].get<std::string>();
-        }
-        if (first_item_value.contains("lastGainGameTime") && first_item_value["lastGainGameTime"].is_string()) {
-            default_lastGainGameTime = first_item_value["lastGainGameTime"].get<std::string>();
-        }
-    }
-    LogMessage(LOG_INFO_LEVEL, ("Using timestamps '" + default_lastGainTime + "' / '" + default_lastGainGameTime + "' for new ingredients.").c_str());
+    SaveJson default_lastGainTime;
+    SaveJson default_lastGainGameTime;
+    GetNewIngredientTimestamps(ingredients_json_map, default_lastGainTime, default_lastGainGameTime);
 
     std::vector<std::map<std::string, int>> all_db_ingredients;
     std::string sql_query = R"(
@@ -635,15 +975,32 @@ void SaveGameManager::MaxAllIngredients(sqlite3* db) {
         JOIN
             Items AS T
         ON
-            I.TID = T.ItemDataID;
+            I.TID = T.ItemDataID
+        ORDER BY
+            I.TID, T.TID;
     )";
 
-    char* zErrMsg = nullptr;
-    int rc = sqlite3_exec(db, sql_query.c_str(), callbackGetAllIngredients, &all_db_ingredients, &zErrMsg);
-    if (rc != SQLITE_OK) {
-        LogMessage(LOG_ERROR_LEVEL, ("SQL error getting all ingredients: " + std::string(zErrMsg)).c_str());
-        sqlite3_free(zErrMsg);
-        return;
+    if (m_catalog) {
+        // The same join, from the item catalog's ItemDataID index.
+        for (uint32_t row = 0; row < m_catalog->GetIngredientCount(); ++row) {
+            int ingredient_id = m_catalog->GetInt(CATALOG_INGREDIENT_TID, row);
+            ItemCatalogRows items = m_catalog->Find(CATALOG_INDEX_ITEM_BY_DATA_ID, ingredient_id);
+            for (uint32_t i = 0; i < items.count; ++i) {
+                std::map<std::string, int> db_row;
+                db_row["ingredientsID_for_save_file_key"] = ingredient_id;
+                db_row["parentID"] = m_catalog->GetInt(CATALOG_ITEM_TID, items.rows[i]);
+                db_row["MaxCount"] = m_catalog->GetInt(CATALOG_ITEM_MAX_COUNT, items.rows[i]);
+                all_db_ingredients.push_back(db_row);
+            }
+        }
+    } else {
+        char* zErrMsg = nullptr;
+        int rc = sqlite3_exec(db, sql_query.c_str(), callbackGetAllIngredients, &all_db_ingredients, &zErrMsg);
+        if (rc != SQLITE_OK) {
+            LogMessage(LOG_ERROR_LEVEL, ("SQL error getting all ingredients: " + std::string(zErrMsg)).c_str());
+            sqlite3_free(zErrMsg);
+            return;
+        }
     }
     LogMessage(LOG_INFO_LEVEL, ("Retrieved " + std::to_string(all_db_ingredients.size()) + " potential ingredients from database.").c_str());
 
@@ -680,28 +1037,201 @@ void SaveGameManager::MaxAllIngredients(sqlite3* db) {
 
         if (ingredients_json_map.contains(ingredient_key)) {
             // Ingredient already exists, just update its count
-            ingredients_json_map[ingredient_key]["count"] = target_count;
+            SetSaveValue(ingredients_json_map[ingredient_key]["count"], target_count, "Ingredients", ingredient_key, "count");
             updated_count++;
         } else {
             // Ingredient does not exist, add it
-            nlohmann::json new_ingredient_entry;
-            new_ingredient_entry["ingredientsID"] = ingredients_id_from_db;
-            new_ingredient_entry["level"] = 1; // Default level
-            new_ingredient_entry["parentID"] = parent_id_from_db;
-            new_ingredient_entry["count"] = target_count; // Set to the determined target count
-            new_ingredient_entry["branchCount"] = 0; // Default
-            new_ingredient_entry["lastGainTime"] = default_lastGainTime;
-            new_ingredient_entry["lastGainGameTime"] = default_lastGainGameTime;
-            new_ingredient_entry["isNew"] = true; // Mark as new
-            new_ingredient_entry["placeTagMask"] = 1; // Default
-
-            ingredients_json_map[ingredient_key] = new_ingredient_entry;
+            SetSaveValue(ingredients_json_map[ingredient_key], MakeIngredientEntry(ingredients_id_from_db, parent_id_from_db, target_count, default_lastGainTime, default_lastGainGameTime),
+                         "Ingredients", ingredient_key, NULL);
             added_count++;
         }
     }
     LogMessage(LOG_INFO_LEVEL, ("MaxAllIngredients: Updated " + std::to_string(updated_count) + " existing, added " + std::to_string(added_count) + " new, skipped " + std::to_string(skipped_count) + " ingredients.").c_str());
 }
 
+// --- ApplyItemCounts Implementation ---
+void SaveGameManager::ApplyItemCounts(const std::vector<ItemCountChange>& changes, ItemCountApplyResult& out_result) {
+    out_result = ItemCountApplyResult();
+    if (!m_isSaveFileLoaded) {
+        LogMessage(LOG_WARNING_LEVEL, "No save file loaded for ApplyItemCounts.");
+        return;
+    }
+
+    // Index the inventory slots by item ID once, so each material change is a hash lookup. The index holds
+    // the slot's key and value; they stay put because nothing is added to InventoryItemSlot here.
+    std::unordered_map<int, std::pair<const SaveJson::string_t*, SaveJson*>> slots_by_item;
+    if (m_saveData.contains("InventoryItemSlot") && m_saveData["InventoryItemSlot"].is_object()) {
+        SaveJson& slots = m_saveData["InventoryItemSlot"];
+        slots_by_item.reserve(slots.size());
+        for (auto it = slots.begin(); it != slots.end(); ++it) {
+            auto item_id = it.value().find("itemID");
+            if (item_id != it.value().end() && item_id->is_number_integer()) {
+                slots_by_item.emplace(item_id->get<int>(), std::make_pair(&it.key(), &it.value())); // The first slot holding an item gets its count.
+            }
+        }
+    }
+
+    ScopedStringInterning interning(m_stringPool);
+    SaveJson gain_time;
+    SaveJson gain_game_time;
+    for (const ItemCountChange& change : changes) {
+        if (change.target == ITEM_COUNT_INGREDIENT) {
+            if (!m_saveData.contains("Ingredients") || !m_saveData["Ingredients"].is_object()) {
+                LogMessage(LOG_INFO_LEVEL, "Creating empty 'Ingredients' section in save data.");
+                m_saveData["Ingredients"] = SaveJson::object();
+            }
+            SaveJson& ingredients = m_saveData["Ingredients"];
+            std::string key = std::to_string(change.id);
+            auto entry = ingredients.find(key);
+            const bool exists = entry != ingredients.end() && entry->is_object();
+            if (!exists) {
+                // The import chose the parent item; record it so a replay adds the same entry.
+                m_journal.Append(JOURNAL_OP_SET_INGREDIENT_PARENT, PackJournalItemCount(change.id, change.parentId));
+            }
+            m_journal.Append(JOURNAL_OP_SET_INGREDIENT_COUNT, PackJournalItemCount(change.id, change.count));
+            if (exists) {
+                SetSaveValue((*entry)["count"], change.count, "Ingredients", key, "count");
+                out_result.ingredientsSet++;
+            } else {
+                if (gain_time.is_null()) {
+                    GetNewIngredientTimestamps(ingredients, gain_time, gain_game_time);
+                }
+                SetSaveValue(ingredients[key], MakeIngredientEntry(change.id, change.parentId, change.count, gain_time, gain_game_time), "Ingredients", key, NULL);
+                out_result.ingredientsAdded++;
+            }
+        } else {
+            m_journal.Append(JOURNAL_OP_SET_MATERIAL_COUNT, PackJournalItemCount(change.id, change.count));
+            auto slot = slots_by_item.find(change.id);
+            if (slot == slots_by_item.end()) {
+                out_result.materialsNotOwned++;
+                continue;
+            }
+            SetSaveValue((*slot->second.second)["totalCount"], change.count, "InventoryItemSlot", *slot->second.first, "totalCount");
+            out_result.materialsSet++;
+        }
+    }
+    LogMessage(LOG_INFO_LEVEL, ("ApplyItemCounts: Set " + std::to_string(out_result.ingredientsSet) + " ingredients, added " + std::to_string(out_result.ingredientsAdded) +
+               ", set " + std::to_string(out_result.materialsSet) + " materials, skipped " + std::to_string(out_result.materialsNotOwned) + " materials not in the inventory.").c_str());
+}
+
+// --- FindUnknownItemIds Implementation ---
+void SaveGameManager::FindUnknownItemIds(sqlite3* db, std::vector<int32_t>& out_ids) const {
+    out_ids.clear();
+    if (!m_isSaveFileLoaded || !db) {
+        return;
+    }
+    // Read the known IDs once rather than querying per save entry.
+    std::unordered_set<int32_t> known_tids;
+    std::unordered_set<int32_t> known_data_ids;
+    sqlite3_stmt* stmt = NULL;
+    if (sqlite3_prepare_v2(db, "SELECT TID, ItemDataID FROM Items;", -1, &stmt, NULL) != SQLITE_OK) {
+        LogMessage(LOG_ERROR_LEVEL, ("SQL prepare failed for FindUnknownItemIds: " + std::string(sqlite3_errmsg(db))).c_str());
+        return;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        known_tids.insert(sqlite3_column_int(stmt, 0));
+        known_data_ids.insert(sqlite3_column_int(stmt, 1));
+    }
+    sqlite3_finalize(stmt);
+
+    auto collect = [&](const char* section, const char* field, const std::unordered_set<int32_t>& known) {
+        auto entries = m_saveData.find(section);
+        if (entries == m_saveData.end() || !entries->is_object()) {
+            return;
+        }
+        for (const SaveJson& entry : *entries) {
+            auto id = entry.find(field);
+            if (id != entry.end() && id->is_number_integer() && known.count(id->get<int32_t>()) == 0) {
+                out_ids.push_back(id->get<int32_t>());
+            }
+        }
+    };
+    collect("Ingredients", "ingredientsID", known_data_ids);
+    collect("InventoryItemSlot", "itemID", known_tids);
+}
+
+// --- Ingredient Gain Times ---
+size_t SaveGameManager::SetIngredientGainTimes(const SaveTimestamp& timestamp) {
+    if (!m_isSaveFileLoaded) {
+        LogMessage(LOG_WARNING_LEVEL, "No save file loaded for SetIngredientGainTimes.");
+        return 0;
+    }
+    m_journal.Append(JOURNAL_OP_SET_INGREDIENT_GAIN_TIME, static_cast<long long>(timestamp.SortKey()));
+    auto ingredients = m_saveData.find("Ingredients");
+    if (ingredients == m_saveData.end() || !ingredients->is_object()) {
+        return 0;
+    }
+    char text[SAVE_TIMESTAMP_LENGTH];
+    FormatSaveTimestamp(timestamp, text);
+    const SaveJson gain_time = SaveJson::string_t(text, SAVE_TIMESTAMP_LENGTH); // Every entry shares this buffer.
+
+    size_t updated = 0;
+    for (auto it = ingredients->begin(); it != ingredients->end(); ++it) {
+        if (it.value().is_object()) {
+            SetSaveValue(it.value()["lastGainTime"], gain_time, "Ingredients", it.key(), "lastGainTime");
+            updated++;
+        }
+    }
+    LogMessage(LOG_INFO_LEVEL, ("Set the gain time of " + std::to_string(updated) + " ingredients to " + std::string(text, SAVE_TIMESTAMP_LENGTH) + ".").c_str());
+    return updated;
+}
+
+std::vector<TimestampedEntry> SaveGameManager::SelectIngredientsByGainTime(const SaveTimestamp& from, const SaveTimestamp& to) const {
+    std::vector<TimestampedEntry> selected;
+    auto ingredients = m_saveData.find("Ingredients");
+    if (!m_isSaveFileLoaded || ingredients == m_saveData.end() || !ingredients->is_object()) {
+        return selected;
+    }
+    selected.reserve(ingredients->size());
+    const uint64_t from_key = from.SortKey();
+    const uint64_t to_key = to.SortKey();
+    for (auto it = ingredients->begin(); it != ingredients->end(); ++it) {
+        const SaveJson& entry = it.value();
+        if (!entry.is_object()) {
+            continue;
+        }
+        auto value = entry.find("lastGainTime");
+        SaveTimestamp timestamp;
+        if (value == entry.end() || !value->is_string() || !ParseSaveTimestamp(value->get_ref<const SaveJson::string_t&>(), timestamp)) {
+            continue;
+        }
+        const uint64_t key = timestamp.SortKey();
+        if (key >= from_key && key <= to_key) {
+            selected.push_back({ key, &entry, &it.key() });
+        }
+    }
+    std::sort(selected.begin(), selected.end(), [](const TimestampedEntry& a, const TimestampedEntry& b) {
+        return a.sortKey < b.sortKey;
+    });
+    return selected;
+}
+
+// Rebuilds the changes of count records and applies them in one ApplyItemCounts call, so the inventory
+// is indexed once per run rather than once per record. An ingredient the import added has its parent
+// TID in the JOURNAL_OP_SET_INGREDIENT_PARENT record just before its count; other changes never use it.
+void SaveGameManager::ReplayItemCounts(const JournalEntry* entries, size_t count) {
+    std::vector<ItemCountChange> changes;
+    changes.reserve(count);
+    int32_t parent_of = 0;
+    int32_t parent_id = 0;
+    bool has_parent = false;
+    for (size_t i = 0; i < count; ++i) {
+        if (entries[i].op == JOURNAL_OP_SET_INGREDIENT_PARENT) {
+            UnpackJournalItemCount(entries[i].value, parent_of, parent_id);
+            has_parent = true;
+            continue;
+        }
+        ItemCountChange change;
+        change.target = entries[i].op == JOURNAL_OP_SET_INGREDIENT_COUNT ? ITEM_COUNT_INGREDIENT : ITEM_COUNT_MATERIAL;
+        UnpackJournalItemCount(entries[i].value, change.id, change.count);
+        change.parentId = has_parent && parent_of == change.id ? parent_id : change.id;
+        has_parent = false;
+        changes.push_back(change);
+    }
+    ItemCountApplyResult result;
+    ApplyItemCounts(changes, result);
+}
+
 // --- Static Helper: GetDefaultSaveGameDirectoryAndLatestFile Implementation ---
 // Discovers the default save game directory for Dave the Diver and identifies the most recent save file.
 std::filesystem::path SaveGameManager::GetDefaultSaveGameDirectoryAndLatestFile(std::string& latestSaveFileName) {
@@ -31,12 +31,42 @@
 //
 #pragma once
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <filesystem>
-#include "json.hpp"         // Include nlohmann/json for the JSON data
+#include "SaveJson.h"       // For SaveJson, the JSON data of the save
 #include "zlib.h"           // For zlib compression/decompression
 #include "sqlite3.h"        // For SQLite database operations
+#include "SaveSchema.h"     // For validating save data before it is written
+#include "EditJournal.h"    // For the crash-recovery edit journal
+#include "SaveCodec.h"      // For detecting and applying the save file encoding
+#include "ItemCatalog.h"    // For looking up item data without the reference database
+#include "SaveChangeEvents.h" // For publishing changes to the save data
+#include "InventoryImport.h" // For ItemCountChange, the counts applied by ApplyItemCounts
+#include "SaveTimestamp.h"  // For SaveTimestamp, the ingredient gain times
+
+// Largest save accepted by the loader. Real saves are a few megabytes at most.
+const size_t MAX_SAVE_FILE_BYTES = 256 * 1024 * 1024;
+// Deepest JSON nesting accepted by the loader. Real saves nest a handful of levels; serializing and
+// validating recurse once per level, so unbounded nesting could exhaust the stack.
+const size_t MAX_SAVE_NESTING_DEPTH = 256;
+
+// An Ingredients entry located by its lastGainTime (see SelectIngredientsByGainTime).
+struct TimestampedEntry {
+    uint64_t sortKey;                       // SaveTimestamp::SortKey() of the entry's lastGainTime.
+    const SaveJson* entry;                  // The entry object.
+    const SaveJson::string_t* key;          // The entry's key.
+};
+
+// What ApplyItemCounts did with its changes.
+struct ItemCountApplyResult {
+    size_t ingredientsSet = 0;      // Existing Ingredients entries given the imported count.
+    size_t ingredientsAdded = 0;    // Ingredients entries created for ingredients the save did not have.
+    size_t materialsSet = 0;        // InventoryItemSlot entries given the imported count.
+    size_t materialsNotOwned = 0;   // Materials skipped because the save has no inventory slot for them.
+};
 
 class SaveGameManager {
 public:
@@ -44,15 +74,58 @@ public:
     ~SaveGameManager();
 
     // Core Save File Operations
+    // filepath may also name a save inside an archive (see SaveArchive.h); such saves load read-only.
     bool LoadSaveFile(const std::string& filepath);
+    // Loads a save from encoded bytes already in memory; the bytes are decoded in place.
+    // sourcePath is recorded as the file the save will be written back to.
+    bool LoadSaveFromMemory(std::string& bytes, const std::string& sourcePath);
+    // Takes over the save loaded by source (e.g., one loaded ahead of time on another thread, see
+    // SavePreload), leaving source unloaded. Nothing is copied or reparsed; otherwise this behaves as a
+    // load: a new edit journal starts and a load event is published. Returns false if source has no save.
+    bool AdoptSave(SaveGameManager& source);
+    // Unloads the save, discarding its edit journal, without loading another.
+    void CloseSave() { UnloadSave(); }
     bool WriteSaveFile(std::string& out_backup_filepath);
 
+    // Replaces the schema used to validate save data before writing with one loaded from a JSON file.
+    // Returns false (keeping the current schema) if the file cannot be read or compiled.
+    bool LoadSchemaFile(const std::string& filepath);
+    // Validates the loaded save against the schema, as WriteSaveFile does before writing.
+    SchemaValidationResult ValidateSaveData() const { return m_schema.Validate(m_saveData); }
+
+    // Edit Journal (crash recovery)
+    // Enables the edit journal at journalPath. Every save file loaded afterwards starts a new journal,
+    // and every edit is recorded in it before being applied.
+    void EnableEditJournal(const std::string& journalPath);
+    // Rebuilds a crashed session in two steps, so the caller can pick the reference data for the save in
+    // between: LoadRecoverySource reloads the journal's source save file, leaving the journal intact, and
+    // ReplayJournal then replays its edits in order. databaseFor returns the reference database to replay
+    // an edit with, given the catalog version it was made under. The cost is one load plus one operation
+    // per recorded edit.
+    bool LoadRecoverySource(const JournalContents& journal);
+    void ReplayJournal(const JournalContents& journal, const std::function<sqlite3*(uint32_t catalogVersion)>& databaseFor);
+    // Closes and deletes the current journal; unsaved edits are being abandoned (e.g., on a clean exit).
+    void DiscardEditJournal();
+
+    // Session Snapshots (see SaveSessionCache)
+    // Writes the session to a compact binary snapshot: the save data, its encoding and source path, and
+    // the edits recorded in the journal, as CBOR deflated with zlib. Returns false if no save is loaded.
+    bool WriteSessionSnapshot(std::vector<unsigned char>& out_snapshot, std::string& out_error) const;
+    // Replaces the loaded save with a snapshot's session. If journaling is enabled, a new journal starts
+    // with the snapshot's edits, so crash recovery still covers them.
+    bool RestoreSessionSnapshot(const std::vector<unsigned char>& snapshot, std::string& out_error);
+    // Approximate heap memory held by the loaded save: its nodes, containers and string buffers.
+    size_t EstimateMemoryUsage() const;
+
     // Player Stats Getters (already exists, but ensures it can access m_saveData)
     long long GetGold() const;
     long long GetBei() const;
     long long GetArtisansFlame() const;
     long long GetFollowerCount() const;
     bool IsSaveFileLoaded() const { return m_isSaveFileLoaded; }
+    const SaveJson& GetSaveData() const { return m_saveData; }
+    // Encoding detected when the save file was loaded; writes use the same encoding.
+    const SaveCodec& GetSaveCodec() const { return m_codec; }
 
     // Player Stats Setters
     void SetGold(long long value);
@@ -65,24 +138,82 @@ public:
     void MaxAllIngredients(sqlite3* db); // Needs access to the database
     void MaxOwnMaterials(sqlite3* db); // Needs access to the database
     void MaxOwnStaffLevel(); // Needs access to the database
+    // Writes imported item counts (see JoinItemCounts) in one pass: each change is one hash lookup into
+    // Ingredients or into an index of InventoryItemSlot by itemID built once per call. Missing ingredients
+    // are added; materials are only set in inventory slots the save already has.
+    void ApplyItemCounts(const std::vector<ItemCountChange>& changes, ItemCountApplyResult& out_result);
+    // Collects the item IDs the save refers to that db has no item for: ingredientsIDs missing from
+    // Items.ItemDataID and inventory itemIDs missing from Items.TID. Used to pick the reference catalog
+    // version the save was written by (see ReferenceDatabase::FindCatalogVersionForItems).
+    void FindUnknownItemIds(sqlite3* db, std::vector<int32_t>& out_ids) const;
+
+    // Ingredient Gain Times
+    // Sets the lastGainTime of every Ingredients entry to timestamp, e.g. CurrentLocalTimestamp() to
+    // make them all look just gained. Journaled like any edit, and each entry that differs publishes a
+    // change. The formatted time is one shared string, so no entry allocates. Returns the entries set.
+    size_t SetIngredientGainTimes(const SaveTimestamp& timestamp);
+    // Returns the Ingredients entries whose lastGainTime lies in [from, to] (inclusive), oldest first.
+    // Entries with a missing or malformed lastGainTime are skipped. The pointers are valid until the
+    // save data next changes.
+    std::vector<TimestampedEntry> SelectIngredientsByGainTime(const SaveTimestamp& from, const SaveTimestamp& to) const;
+
+    // Makes the Max* passes look item data up in a mapped item catalog instead of the reference database
+    // (the db parameter may then be NULL). Pass NULL to go back to the database. The catalog must outlive
+    // its use here.
+    void SetItemCatalog(const ItemCatalog* catalog) { m_catalog = catalog; }
+    // Records the reference catalog version the database passed to the Max* passes holds, so the edit
+    // journal can replay each edit with the item data it was made with.
+    void SetCatalogVersion(size_t version) { m_journal.SetCatalogVersion(static_cast<uint32_t>(version)); }
+
+    // Change Notifications
+    // Calls callback with every change to the save data made from now on: each value set by the setters
+    // and Max* passes (only when it actually differs), and each load or unload. Returns an id for
+    // UnsubscribeFromChanges. Events are delivered synchronously from inside the edit.
+    int SubscribeToChanges(SaveChangeCallback callback) { return m_changes.Subscribe(std::move(callback)); }
+    void UnsubscribeFromChanges(int id) { m_changes.Unsubscribe(id); }
 
     // Static helper to find save directory (already exists)
     static std::filesystem::path GetDefaultSaveGameDirectoryAndLatestFile(std::string& latestSaveFileName);
 
 private:
     // --- Member Variables ---
-    nlohmann::json m_saveData;           // Holds the parsed JSON data of the save file.
+    SaveJson m_saveData;                 // Holds the parsed JSON data of the save file.
+    StringInternPool m_stringPool;       // Strings of the save data interned on load and by bulk edits.
     std::string m_currentSaveFilePath;   // Path of the currently loaded save file.
     bool m_isSaveFileLoaded;             // Flag to indicate if a save file is successfully loaded.
+    uint64_t m_sourceSize;               // Size of the save file when it was loaded or last written.
+    int64_t m_sourceWriteTime;           // Write time of the save file when it was loaded or last written.
+    CompiledSaveSchema m_schema;         // Validates the save data before every write.
+    SaveCodec m_codec;                   // Encoding of the loaded save file.
+    EditJournal m_journal;               // Records edits made since the save file was loaded or written.
+    std::string m_journalPath;           // Journal location; empty if journaling is disabled.
+    const ItemCatalog* m_catalog;        // Item data source for the Max* passes; NULL to use the reference database.
+    SaveChangePublisher m_changes;       // Subscribers to changes of the save data.
 
     // --- Private Helper Methods ---
-    // XOR encryption/decryption (already exists, but ensure it's private if it's not a static utility)
-    std::string XORDecryptEncrypt(const std::string& data, const std::string& key);
-
-    // Zlib decompression (will be moved from DaveSaveEd.cpp and integrated with XOR)
-    std::string decompressZlib(const std::vector<unsigned char>& compressed_bytes);
-    // Zlib compression (will be moved from DaveSaveEd.cpp and integrated with XOR)
-    std::vector<unsigned char> compressZlib(const std::string& uncompressed_json);
+    // Clears the loaded save and discards its edit journal.
+    void UnloadSave();
+    // Records the size and write time of the save file just loaded or written.
+    void RecordSourceFingerprint();
+    // Starts a journal for the loaded save against its recorded fingerprint; false if journaling is off or fails.
+    bool BeginJournal();
+    // Applies one recorded edit (used when replaying a journal).
+    void ApplyJournalEntry(const JournalEntry& entry, sqlite3* db);
+    // Looks up an item's MaxCount by TID or ItemDataID, from the item catalog or the reference database.
+    bool LookupItemMaxCount(sqlite3_stmt* stmt, ItemCatalogIndex index, int id, int& out_max_count) const;
+    // Sets slot, the value at /section/key[/field], to value and publishes the change if it differs.
+    // The key's path string is only built when someone is subscribed.
+    void SetSaveValue(SaveJson& slot, SaveJson value, const char* section, std::string_view key, const char* field);
+    // As above, for an entry of an array section, keyed by its index.
+    void SetSaveValue(SaveJson& slot, SaveJson value, const char* section, size_t index, const char* field);
+    // Publishes a load or unload event.
+    void PublishLoadState(SaveChangeKind kind);
+    // Gets the gain timestamps for new Ingredients entries (those of the section's first entry, if valid).
+    void GetNewIngredientTimestamps(const SaveJson& ingredients, SaveJson& out_gain_time, SaveJson& out_gain_game_time) const;
+    // Builds a new Ingredients entry.
+    static SaveJson MakeIngredientEntry(int ingredientsId, int parentId, int count, const SaveJson& gainTime, const SaveJson& gainGameTime);
+    // Replays count consecutive JOURNAL_OP_SET_*_COUNT records as one batch.
+    void ReplayItemCounts(const JournalEntry* entries, size_t count);
 
     // SQLite Callback for batch querying ingredients (for MaxAllIngredients)
     // This will need to be a static member function or a friend function
@@ -91,7 +222,4 @@ private:
     // and just declare it here.
     // For simplicity, let's keep it in SaveGameManager.cpp's private section for now.
     // static int callbackGetAllIngredients(void* data, int argc, char** argv, char** azColName);
-
-    // Constant for the XOR key (replace with your actual key)
-    const std::string XOR_KEY = "GameData"; // <-- **IMPORTANT: Replace with your actual key!**
 };
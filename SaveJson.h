@@ -0,0 +1,316 @@
+// SaveJson.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <functional>       // For std::hash, std::equal_to, std::less
+#include <initializer_list>
+#include <iterator>         // For std::next, std::prev
+#include <memory>           // For std::allocator, std::allocator_traits
+#include <stdexcept>        // For std::out_of_range
+#include <string_view>
+#include <utility>          // For std::pair
+#include <vector>
+#include "json.hpp"         // For nlohmann::basic_json
+#include "PooledString.h"
+#include "SaveJsonArena.h"  // For SaveJsonAllocator
+
+// Objects with at most this many members are searched linearly and carry no index. Save entries (one
+// ingredient, one staff member) have about ten short keys, where a scan is faster than hashing.
+const size_t INDEXED_MAP_LINEAR_LIMIT = 16;
+
+// Object storage for save data. Members live in insertion order in one contiguous vector, as in
+// nlohmann::ordered_map, so a save is written back with its keys in the order the game wrote them.
+// Objects larger than INDEXED_MAP_LINEAR_LIMIT also get an open-addressing hash index from key to
+// position, so lookups in big sections such as Ingredients probe a flat array instead of walking the
+// nodes of a std::map.
+// Appending is amortized O(1). Erasing rebuilds the index in O(n); saves are edited by insertion and
+// update and almost never by removal. As with ordered_map, only the members below keep the index in
+// sync, so the inherited vector modifiers must not be used directly.
+// Unlike ordered_map, keys are stored non-const: std::pair<const Key, T> cannot be moved without
+// throwing, so every reallocation would deep-copy every member's value. Keys must still never be
+// modified through an iterator.
+template <class Key, class T, class IgnoredLess = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T>>>
+struct IndexedOrderedMap : std::vector<std::pair<Key, T>, typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<Key, T>>> {
+    using key_type = Key;
+    using mapped_type = T;
+    using Container = std::vector<std::pair<Key, T>, typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<Key, T>>>;
+    using iterator = typename Container::iterator;
+    using const_iterator = typename Container::const_iterator;
+    using size_type = typename Container::size_type;
+    using value_type = typename Container::value_type;
+    using key_compare = std::equal_to<>;
+
+    IndexedOrderedMap() noexcept(noexcept(Container())) : Container{} {}
+    explicit IndexedOrderedMap(const Allocator& alloc) noexcept(noexcept(Container(alloc))) : Container{alloc} {}
+    template <class It>
+    IndexedOrderedMap(It first, It last, const Allocator& alloc = Allocator()) : Container{first, last, alloc} {
+        RebuildIndex();
+    }
+    IndexedOrderedMap(std::initializer_list<value_type> init, const Allocator& alloc = Allocator()) : Container{init, alloc} {
+        RebuildIndex();
+    }
+
+    std::pair<iterator, bool> emplace(const key_type& key, T&& t) {
+        size_type position = FindPosition(key);
+        if (position != this->size()) {
+            return { this->begin() + position, false };
+        }
+        Container::emplace_back(key, std::forward<T>(t));
+        IndexLastMember();
+        return { std::prev(this->end()), true };
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    std::pair<iterator, bool> emplace(KeyType&& key, T&& t) {
+        size_type position = FindPosition(key);
+        if (position != this->size()) {
+            return { this->begin() + position, false };
+        }
+        Container::emplace_back(std::forward<KeyType>(key), std::forward<T>(t));
+        IndexLastMember();
+        return { std::prev(this->end()), true };
+    }
+
+    T& operator[](const key_type& key) {
+        return emplace(key, T{}).first->second;
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    T& operator[](KeyType&& key) {
+        return emplace(std::forward<KeyType>(key), T{}).first->second;
+    }
+
+    const T& operator[](const key_type& key) const {
+        return at(key);
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    const T& operator[](KeyType&& key) const {
+        return at(std::forward<KeyType>(key));
+    }
+
+    T& at(const key_type& key) {
+        return AtPosition(FindPosition(key));
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    T& at(KeyType&& key) {
+        return AtPosition(FindPosition(key));
+    }
+
+    const T& at(const key_type& key) const {
+        return const_cast<IndexedOrderedMap*>(this)->AtPosition(FindPosition(key));
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    const T& at(KeyType&& key) const {
+        return const_cast<IndexedOrderedMap*>(this)->AtPosition(FindPosition(key));
+    }
+
+    size_type erase(const key_type& key) {
+        size_type position = FindPosition(key);
+        if (position == this->size()) {
+            return 0;
+        }
+        erase(this->begin() + position);
+        return 1;
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    size_type erase(KeyType&& key) {
+        size_type position = FindPosition(key);
+        if (position == this->size()) {
+            return 0;
+        }
+        erase(this->begin() + position);
+        return 1;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(pos, std::next(pos));
+    }
+
+    iterator erase(iterator first, iterator last) {
+        iterator result = Container::erase(first, last);
+        RebuildIndex();
+        return result;
+    }
+
+    void clear() noexcept {
+        Container::clear();
+        m_slots.clear();
+    }
+
+    size_type count(const key_type& key) const {
+        return FindPosition(key) != this->size() ? 1 : 0;
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    size_type count(KeyType&& key) const {
+        return FindPosition(key) != this->size() ? 1 : 0;
+    }
+
+    iterator find(const key_type& key) {
+        return this->begin() + FindPosition(key);
+    }
+
+    template <class KeyType, nlohmann::detail::enable_if_t<
+                 nlohmann::detail::is_usable_as_key_type<key_compare, key_type, KeyType>::value, int> = 0>
+    iterator find(KeyType&& key) {
+        return this->begin() + FindPosition(key);
+    }
+
+    const_iterator find(const key_type& key) const {
+        return this->begin() + FindPosition(key);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return emplace(value.first, std::move(value.second));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        size_type position = FindPosition(value.first);
+        if (position != this->size()) {
+            return { this->begin() + position, false };
+        }
+        Container::push_back(value);
+        IndexLastMember();
+        return { std::prev(this->end()), true };
+    }
+
+    template <typename InputIt>
+    using require_input_iter = typename std::enable_if<std::is_convertible<typename std::iterator_traits<InputIt>::iterator_category,
+        std::input_iterator_tag>::value>::type;
+
+    template <typename InputIt, typename = require_input_iter<InputIt>>
+    void insert(InputIt first, InputIt last) {
+        for (auto it = first; it != last; ++it) {
+            insert(*it);
+        }
+    }
+
+private:
+    // A hash index slot. position is the member's index plus one; 0 marks an empty slot. The full hash is
+    // kept so most mismatches are rejected without touching the key.
+    struct Slot {
+        uint32_t hash;
+        uint32_t position;
+    };
+    std::vector<Slot, typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>> m_slots;  // Power-of-two sized, at most half full; empty while the object is small.
+
+    static uint32_t HashKey(std::string_view key) {
+        return static_cast<uint32_t>(std::hash<std::string_view>()(key));
+    }
+
+    // Returns the position of the first member with the given key, or size() if there is none.
+    template <class KeyType>
+    size_type FindPosition(const KeyType& key_value) const {
+        const std::string_view key(key_value);
+        if (m_slots.empty()) {
+            for (size_type i = 0; i < this->size(); ++i) {
+                if (std::string_view(Container::operator[](i).first) == key) {
+                    return i;
+                }
+            }
+            return this->size();
+        }
+        const uint32_t hash = HashKey(key);
+        const size_t mask = m_slots.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Slot& candidate = m_slots[slot];
+            if (candidate.position == 0) {
+                return this->size();
+            }
+            if (candidate.hash == hash && std::string_view(Container::operator[](candidate.position - 1).first) == key) {
+                return candidate.position - 1;
+            }
+        }
+    }
+
+    T& AtPosition(size_type position) {
+        if (position == this->size()) {
+            throw std::out_of_range("key not found");
+        }
+        return Container::operator[](position).second;
+    }
+
+    void InsertSlot(size_type position, uint32_t hash) {
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = hash & mask;
+        while (m_slots[slot].position != 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = Slot{ hash, static_cast<uint32_t>(position + 1) };
+    }
+
+    // Adds the member just appended to the index, creating or growing the index as needed.
+    void IndexLastMember() {
+        if (m_slots.empty() ? this->size() > INDEXED_MAP_LINEAR_LIMIT : this->size() * 2 > m_slots.size()) {
+            RebuildIndex();
+        } else if (!m_slots.empty()) {
+            InsertSlot(this->size() - 1, HashKey(this->back().first));
+        }
+    }
+
+    void RebuildIndex() {
+        m_slots.clear();
+        if (this->size() <= INDEXED_MAP_LINEAR_LIMIT) {
+            return;
+        }
+        // Sized for a load factor of at most a quarter, so the index is rebuilt only after doubling.
+        size_t slot_count = 64;
+        while (slot_count < this->size() * 4) {
+            slot_count <<= 1;
+        }
+        m_slots.assign(slot_count, Slot{ 0, 0 });
+        // Members are indexed in order, so a duplicate key (possible only from the range constructor)
+        // resolves to its first occurrence.
+        for (size_type i = 0; i < this->size(); ++i) {
+            InsertSlot(i, HashKey(Container::operator[](i).first));
+        }
+    }
+};
+
+// JSON document type for save data: nlohmann::basic_json with IndexedOrderedMap object storage and
+// PooledString strings, so copies of a key or value share one buffer. Nodes are allocated through
+// SaveJsonAllocator, so a batch worker can place a whole document in its SaveJsonArena.
+using SaveJson = nlohmann::basic_json<IndexedOrderedMap, std::vector, PooledString, bool, std::int64_t, std::uint64_t, double,
+                                      SaveJsonAllocator>;
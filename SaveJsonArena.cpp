@@ -0,0 +1,157 @@
+// SaveJsonArena.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveJsonArena.h"
+
+#include <algorithm>    // For std::max, std::min
+#include <cstdint>      // For uintptr_t
+
+// Allocations are rounded up to keep every one aligned like operator new's.
+static const size_t SAVE_JSON_ARENA_ALIGNMENT = alignof(std::max_align_t);
+// Each new chunk doubles the last, up to this size, so a large save needs only a few chunks.
+static const size_t SAVE_JSON_ARENA_MAX_CHUNK_SIZE = 64 << 20;
+
+namespace {
+// The arena installed by the innermost ScopedSaveJsonArena on each thread.
+thread_local SaveJsonArena* g_currentArena = NULL;
+}
+
+// --- SaveJsonArena ---
+SaveJsonArena::SaveJsonArena(size_t firstChunkSize) : m_firstChunkSize(std::max<size_t>(firstChunkSize, SAVE_JSON_ARENA_ALIGNMENT)) {
+}
+
+SaveJsonArena::~SaveJsonArena() {
+    for (const Chunk& chunk : m_chunks) {
+        ::operator delete(chunk.base);
+    }
+}
+
+SaveJsonArena* SaveJsonArena::Current() {
+    return g_currentArena;
+}
+
+void* SaveJsonArena::Allocate(size_t size) {
+    if (size > static_cast<size_t>(-1) - SAVE_JSON_ARENA_ALIGNMENT) {
+        throw std::bad_alloc();
+    }
+    size = (size + SAVE_JSON_ARENA_ALIGNMENT - 1) & ~(SAVE_JSON_ARENA_ALIGNMENT - 1);
+    if (size <= static_cast<size_t>(m_end - m_cursor)) {
+        m_last = m_cursor;
+        m_cursor += size;
+        return m_last;
+    }
+    return AllocateFromNextChunk(size);
+}
+
+void* SaveJsonArena::AllocateFromNextChunk(size_t size) {
+    // Chunks kept from before the last Reset come first; one too small for this allocation is skipped.
+    while (m_chunk + 1 < m_chunks.size()) {
+        m_usedBefore += m_chunks[m_chunk].size;
+        const Chunk& chunk = m_chunks[++m_chunk];
+        m_cursor = chunk.base;
+        m_end = chunk.base + chunk.size;
+        if (size <= chunk.size) {
+            m_last = m_cursor;
+            m_cursor += size;
+            return m_last;
+        }
+    }
+    size_t chunk_size = m_chunks.empty() ? m_firstChunkSize : std::min(m_chunks.back().size * 2, SAVE_JSON_ARENA_MAX_CHUNK_SIZE);
+    chunk_size = std::max(chunk_size, size);
+    m_chunks.reserve(m_chunks.size() + 1); // So recording the chunk cannot throw once it is allocated.
+    char* base = static_cast<char*>(::operator new(chunk_size));
+    if (!m_chunks.empty()) {
+        m_usedBefore += m_chunks[m_chunk].size;
+    }
+    m_chunks.push_back(Chunk{ base, chunk_size });
+    m_chunk = m_chunks.size() - 1;
+    m_capacity += chunk_size;
+    m_cursor = base + size;
+    m_end = base + chunk_size;
+    m_last = base;
+    return base;
+}
+
+void SaveJsonArena::Release(void* p, size_t size) {
+    size = (size + SAVE_JSON_ARENA_ALIGNMENT - 1) & ~(SAVE_JSON_ARENA_ALIGNMENT - 1);
+    if (p == m_last && m_last + size == m_cursor) {
+        m_cursor = m_last;
+        m_last = NULL; // Only the most recent allocation is known.
+    }
+}
+
+bool SaveJsonArena::Owns(const void* p) const {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(p);
+    for (const Chunk& chunk : m_chunks) {
+        if (address - reinterpret_cast<uintptr_t>(chunk.base) < chunk.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SaveJsonArena::Reset() {
+    m_peak = GetPeakBytes();
+    m_chunk = 0;
+    m_usedBefore = 0;
+    m_last = NULL;
+    m_cursor = m_chunks.empty() ? NULL : m_chunks[0].base;
+    m_end = m_chunks.empty() ? NULL : m_chunks[0].base + m_chunks[0].size;
+}
+
+size_t SaveJsonArena::GetPeakBytes() const {
+    size_t used = m_chunks.empty() ? 0 : m_usedBefore + static_cast<size_t>(m_cursor - m_chunks[m_chunk].base);
+    return std::max(m_peak, used);
+}
+
+// --- ScopedSaveJsonArena ---
+ScopedSaveJsonArena::ScopedSaveJsonArena(SaveJsonArena& arena) : m_previous(g_currentArena) {
+    g_currentArena = &arena;
+}
+
+ScopedSaveJsonArena::~ScopedSaveJsonArena() {
+    g_currentArena = m_previous;
+}
+
+// --- Allocation ---
+void* AllocateSaveJsonMemory(size_t size) {
+    SaveJsonArena* arena = g_currentArena;
+    return arena ? arena->Allocate(size) : ::operator new(size);
+}
+
+void FreeSaveJsonMemory(void* p, size_t size) noexcept {
+    SaveJsonArena* arena = g_currentArena;
+    if (arena && arena->Owns(p)) {
+        arena->Release(p, size);
+        return;
+    }
+    ::operator delete(p);
+}
@@ -0,0 +1,130 @@
+// SaveJsonArena.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstddef>
+#include <new>              // For std::bad_alloc
+#include <vector>
+
+// Bump allocator for the nodes and strings of parsed saves. A batch worker installs its arena with
+// ScopedSaveJsonArena while it loads and checks one save, then calls Reset once the save is gone:
+// everything the document allocated is freed wholesale, and the chunks are kept for the next save.
+// After the first few saves a worker's arena has grown to its high-water mark and loading another
+// save makes almost no calls into the heap, so workers stop contending for the allocator's locks.
+//
+// Memory freed while the arena is installed is only reclaimed when it was the most recent allocation
+// (a growing vector or string); the rest waits for Reset. Values allocated under an arena must be
+// destroyed before it is reset, and while it is still installed. Not thread-safe: an arena belongs
+// to one thread.
+class SaveJsonArena {
+public:
+    explicit SaveJsonArena(size_t firstChunkSize = 1 << 20);
+    ~SaveJsonArena();
+    SaveJsonArena(const SaveJsonArena&) = delete;
+    SaveJsonArena& operator=(const SaveJsonArena&) = delete;
+
+    void* Allocate(size_t size);
+    // Gives back the most recent allocation's memory, if p is it.
+    void Release(void* p, size_t size);
+    bool Owns(const void* p) const;
+    // Frees every allocation at once, keeping the chunks.
+    void Reset();
+
+    size_t GetCapacity() const { return m_capacity; }
+    // Most bytes in use at once since the arena was created.
+    size_t GetPeakBytes() const;
+
+    // The arena installed on the calling thread, or NULL when allocations go to the heap.
+    static SaveJsonArena* Current();
+
+private:
+    friend class ScopedSaveJsonArena;
+
+    struct Chunk {
+        char* base;
+        size_t size;
+    };
+
+    void* AllocateFromNextChunk(size_t size);
+
+    std::vector<Chunk> m_chunks;
+    size_t m_chunk = 0;         // Index of the chunk allocations come from.
+    char* m_cursor = NULL;      // Next free byte in that chunk.
+    char* m_end = NULL;
+    char* m_last = NULL;        // Start of the most recent allocation, for Release.
+    size_t m_capacity = 0;
+    size_t m_usedBefore = 0;    // Bytes used or skipped in the chunks before the current one.
+    size_t m_peak = 0;
+    size_t m_firstChunkSize;
+};
+
+// Installs an arena on the calling thread for the lifetime of the scope. Scopes nest; the previous
+// arena is restored on exit.
+class ScopedSaveJsonArena {
+public:
+    explicit ScopedSaveJsonArena(SaveJsonArena& arena);
+    ~ScopedSaveJsonArena();
+    ScopedSaveJsonArena(const ScopedSaveJsonArena&) = delete;
+    ScopedSaveJsonArena& operator=(const ScopedSaveJsonArena&) = delete;
+
+private:
+    SaveJsonArena* m_previous;
+};
+
+// Allocate from the installed arena, or from the heap when there is none. FreeSaveJsonMemory must be
+// given the size that was allocated.
+void* AllocateSaveJsonMemory(size_t size);
+void FreeSaveJsonMemory(void* p, size_t size) noexcept;
+
+// Allocator for SaveJson's containers and the values it creates on the heap. It is stateless, so
+// containers move and swap freely; the arena, if any, is picked when memory is allocated.
+template <class T>
+struct SaveJsonAllocator {
+    using value_type = T;
+
+    SaveJsonAllocator() noexcept = default;
+    template <class U>
+    SaveJsonAllocator(const SaveJsonAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(AllocateSaveJsonMemory(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { FreeSaveJsonMemory(p, n * sizeof(T)); }
+
+    template <class U>
+    bool operator==(const SaveJsonAllocator<U>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const SaveJsonAllocator<U>&) const noexcept { return false; }
+};
@@ -0,0 +1,219 @@
+// SaveJsonCbor.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveJsonCbor.h"
+#include <cmath>        // For std::ldexp
+#include <cstdint>
+#include <cstring>      // For memcpy
+#include <limits>       // For std::numeric_limits
+
+namespace {
+// --- Reader ---
+// Reads items from a byte range, building each straight into its place in the document.
+class SaveJsonCborReader {
+public:
+    SaveJsonCborReader(const unsigned char* data, size_t size, size_t maxDepth) : m_pos(data), m_end(data + size), m_maxDepth(maxDepth) {}
+
+    bool Read(SaveJson& out, size_t depth);
+    bool AtEnd() const { return m_pos == m_end; }
+    const char* GetError() const { return m_error; }
+
+private:
+    bool Fail(const char* error) {
+        m_error = error;
+        return false;
+    }
+    size_t Remaining() const { return static_cast<size_t>(m_end - m_pos); }
+    // Reads the argument that follows an initial byte: a length, a count or an integer value.
+    bool ReadArgument(unsigned char initial, uint64_t& out);
+    bool ReadFloat(unsigned char initial, SaveJson& out);
+
+    const unsigned char* m_pos;
+    const unsigned char* m_end;
+    size_t m_maxDepth;
+    const char* m_error = "";
+};
+
+bool SaveJsonCborReader::ReadArgument(unsigned char initial, uint64_t& out) {
+    const unsigned char info = initial & 0x1F;
+    if (info < 24) {
+        out = info;
+        return true;
+    }
+    if (info > 27) {
+        return Fail("indefinite-length or reserved CBOR item");
+    }
+    const size_t bytes = static_cast<size_t>(1) << (info - 24);
+    if (Remaining() < bytes) {
+        return Fail("truncated CBOR");
+    }
+    out = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        out = (out << 8) | m_pos[i];
+    }
+    m_pos += bytes;
+    return true;
+}
+
+bool SaveJsonCborReader::ReadFloat(unsigned char initial, SaveJson& out) {
+    uint64_t bits = 0;
+    if (!ReadArgument(initial, bits)) {
+        return false;
+    }
+    if (initial == 0xF9) {
+        // Half precision; to_cbor uses it only for NaN and the infinities.
+        const int exponent = static_cast<int>((bits >> 10) & 0x1F);
+        const double mantissa = static_cast<double>(bits & 0x3FF);
+        double value = exponent == 0 ? std::ldexp(mantissa, -24)
+                     : exponent == 31 ? (mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN())
+                     : std::ldexp(mantissa + 1024, exponent - 25);
+        out = (bits & 0x8000) ? -value : value;
+    } else if (initial == 0xFA) {
+        const uint32_t single_bits = static_cast<uint32_t>(bits);
+        float value;
+        memcpy(&value, &single_bits, sizeof(value));
+        out = static_cast<double>(value);
+    } else {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        out = value;
+    }
+    return true;
+}
+
+bool SaveJsonCborReader::Read(SaveJson& out, size_t depth) {
+    if (m_pos == m_end) {
+        return Fail("truncated CBOR");
+    }
+    const unsigned char initial = *m_pos++;
+    switch (initial) {
+        case 0xF4: out = false; return true;
+        case 0xF5: out = true; return true;
+        case 0xF6: out = nullptr; return true;
+        case 0xF9: case 0xFA: case 0xFB: return ReadFloat(initial, out);
+        default: break;
+    }
+    uint64_t argument = 0;
+    if (!ReadArgument(initial, argument)) {
+        return false;
+    }
+    switch (initial >> 5) {
+        case 0:
+            out = static_cast<SaveJson::number_unsigned_t>(argument);
+            return true;
+        case 1:
+            if (argument > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                return Fail("CBOR negative integer out of range");
+            }
+            out = static_cast<SaveJson::number_integer_t>(-1 - static_cast<int64_t>(argument));
+            return true;
+        case 2:
+            if (argument > Remaining()) {
+                return Fail("truncated CBOR");
+            }
+            out = SaveJson::binary(SaveJson::binary_t::container_type(m_pos, m_pos + argument));
+            m_pos += argument;
+            return true;
+        case 3:
+            if (argument > Remaining()) {
+                return Fail("truncated CBOR");
+            }
+            out = SaveJson::string_t(reinterpret_cast<const char*>(m_pos), static_cast<size_t>(argument));
+            m_pos += argument;
+            return true;
+        case 4: {
+            // Every element takes at least a byte, which bounds what a corrupt count can allocate.
+            if (depth >= m_maxDepth) {
+                return Fail("CBOR nests too deeply");
+            }
+            if (argument > Remaining()) {
+                return Fail("truncated CBOR");
+            }
+            out = SaveJson::array();
+            SaveJson::array_t& array = out.get_ref<SaveJson::array_t&>();
+            array.resize(static_cast<size_t>(argument));
+            for (SaveJson& element : array) {
+                if (!Read(element, depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case 5: {
+            if (depth >= m_maxDepth) {
+                return Fail("CBOR nests too deeply");
+            }
+            if (argument > Remaining() / 2) {
+                return Fail("truncated CBOR");
+            }
+            out = SaveJson::object();
+            SaveJson::object_t& object = out.get_ref<SaveJson::object_t&>();
+            object.reserve(static_cast<size_t>(argument));
+            for (uint64_t i = 0; i < argument; ++i) {
+                uint64_t key_size = 0;
+                if (m_pos == m_end || (*m_pos >> 5) != 3) {
+                    return Fail("CBOR map key is not a text string");
+                }
+                const unsigned char key_initial = *m_pos++;
+                if (!ReadArgument(key_initial, key_size)) {
+                    return false;
+                }
+                if (key_size > Remaining()) {
+                    return Fail("truncated CBOR");
+                }
+                SaveJson::string_t key(reinterpret_cast<const char*>(m_pos), static_cast<size_t>(key_size));
+                m_pos += key_size;
+                if (!Read(object.emplace(key, SaveJson()).first->second, depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case 6:
+            return Fail("CBOR tags are not supported");
+        default:
+            return Fail("unsupported CBOR simple value");
+    }
+}
+}
+
+bool ReadSaveJsonCbor(const void* data, size_t size, size_t maxDepth, SaveJson& out, std::string& out_error) {
+    SaveJsonCborReader reader(static_cast<const unsigned char*>(data), size, maxDepth);
+    if (!reader.Read(out, 0)) {
+        out_error = std::string("Could not decode CBOR: ") + reader.GetError() + ".";
+        return false;
+    }
+    if (!reader.AtEnd()) {
+        out_error = "Could not decode CBOR: unexpected data after the item.";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+// SaveJsonCbor.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "SaveJson.h"
+
+// Decodes one CBOR item, as written by SaveJson::to_cbor, into out. Much quicker than
+// SaveJson::from_cbor for large documents: arrays and objects are sized once from the lengths CBOR
+// stores up front, and each string is copied in one piece (and interned, if a StringInternPool is
+// installed) instead of a byte at a time.
+// Only what to_cbor writes is accepted: definite-length items, no tags, and the simple values false,
+// true and null. Items nested deeper than maxDepth are rejected, so hostile input cannot exhaust the
+// stack. Returns false and sets out_error if the data is not exactly one such item.
+bool ReadSaveJsonCbor(const void* data, size_t size, size_t maxDepth, SaveJson& out, std::string& out_error);
@@ -0,0 +1,419 @@
+// SaveJsonWriter.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveJsonWriter.h"
+#include <cmath>        // For std::isfinite
+#include <cstring>      // For memcpy
+#include <memory>       // For std::make_shared
+#include <stdexcept>    // For std::logic_error
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>  // SSE2 intrinsics
+#define SAVE_JSON_WRITER_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>     // For _BitScanForward
+#endif
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// True for the bytes a string scan stops at: control characters, '"', '\\' and non-ASCII bytes.
+static inline bool NeedsAttention(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\' || c >= 0x80;
+}
+
+#ifdef SAVE_JSON_WRITER_SSE2
+static inline unsigned LowestSetBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// Returns the position of the first byte from start on that NeedsAttention, or length if there is none.
+static size_t FindSpecialByte(const char* text, size_t start, size_t length) {
+    size_t i = start;
+#ifdef SAVE_JSON_WRITER_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        // A signed compare: bytes of 0x80 and up are negative, so "less than a space" also finds them.
+        __m128i special = _mm_or_si128(_mm_cmplt_epi8(block, space),
+                                       _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return i + LowestSetBit(mask);
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (NeedsAttention(static_cast<unsigned char>(text[i]))) {
+            return i;
+        }
+    }
+    return length;
+}
+
+// Returns the length of the well-formed UTF-8 sequence at text, or 0 if it is not one. Accepts what
+// nlohmann's decoder accepts: no overlong forms, no surrogates, nothing above U+10FFFF.
+static size_t Utf8SequenceLength(const unsigned char* text, size_t available) {
+    const unsigned char lead = text[0];
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead < 0xC2) {
+        return 0;
+    } else if (lead < 0xE0) {
+        length = 2;
+    } else if (lead < 0xF0) {
+        length = 3;
+        if (lead == 0xE0) {
+            low = 0xA0;
+        } else if (lead == 0xED) {
+            high = 0x9F;
+        }
+    } else if (lead < 0xF5) {
+        length = 4;
+        if (lead == 0xF0) {
+            low = 0x90;
+        } else if (lead == 0xF4) {
+            high = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+    if (available < length || text[1] < low || text[1] > high) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; ++i) {
+        if (text[i] < 0x80 || text[i] > 0xBF) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+// Discards everything written to it.
+class NullOutputAdapter : public nlohmann::detail::output_adapter_protocol<char> {
+public:
+    void write_character(char) override {}
+    void write_characters(const char*, std::size_t) override {}
+};
+
+// Raises the error SaveJson::dump() raises for a string that is not valid UTF-8, by letting nlohmann's
+// own serializer reject it.
+[[noreturn]] static void ThrowInvalidUtf8(const SaveJson::string_t& text) {
+    nlohmann::detail::serializer<SaveJson> serializer(std::make_shared<NullOutputAdapter>(), ' ');
+    serializer.dump(SaveJson(text), false, false, 0);
+    // Only reached if the two UTF-8 checks disagree.
+    throw std::logic_error("SaveJsonWriter rejected a string that nlohmann::json accepts");
+}
+
+// --- SaveJsonWriter ---
+SaveJsonWriter::SaveJsonWriter(nlohmann::detail::output_adapter_t<char> output, int indent)
+    : m_output(output), m_buffer(JSON_WRITER_CHUNK_SIZE), m_used(0), m_indent(indent) {
+}
+
+SaveJsonWriter::~SaveJsonWriter() {
+}
+
+void SaveJsonWriter::Write(const SaveJson& value) {
+    WriteValue(value, 0);
+    Flush();
+}
+
+void SaveJsonWriter::Flush() {
+    if (m_used > 0) {
+        m_output->write_characters(m_buffer.data(), m_used);
+        m_used = 0;
+    }
+}
+
+void SaveJsonWriter::WriteRaw(const char* data, size_t length) {
+    if (m_used + length > m_buffer.size()) {
+        Flush();
+        if (length >= m_buffer.size()) {
+            m_output->write_characters(data, length);
+            return;
+        }
+    }
+    memcpy(m_buffer.data() + m_used, data, length);
+    m_used += length;
+}
+
+void SaveJsonWriter::WriteIndent(size_t depth) {
+    size_t spaces = depth * static_cast<size_t>(m_indent);
+    while (spaces > 0) {
+        const size_t run = spaces < 64 ? spaces : 64;
+        memset(Reserve(run), ' ', run);
+        m_used += run;
+        spaces -= run;
+    }
+}
+
+void SaveJsonWriter::WriteValue(const SaveJson& value, size_t depth) {
+    const bool pretty = m_indent >= 0;
+    switch (value.type()) {
+    case SaveJson::value_t::object: {
+        const SaveJson::object_t& members = *value.get_ptr<const SaveJson::object_t*>();
+        if (members.empty()) {
+            WriteRaw("{}", 2);
+            return;
+        }
+        Put('{');
+        bool first = true;
+        for (const auto& member : members) {
+            if (!first) {
+                Put(',');
+            }
+            first = false;
+            if (pretty) {
+                Put('\n');
+                WriteIndent(depth + 1);
+            }
+            WriteString(member.first);
+            if (pretty) {
+                WriteRaw(": ", 2);
+            } else {
+                Put(':');
+            }
+            WriteValue(member.second, depth + 1);
+        }
+        if (pretty) {
+            Put('\n');
+            WriteIndent(depth);
+        }
+        Put('}');
+        return;
+    }
+    case SaveJson::value_t::array: {
+        const SaveJson::array_t& elements = *value.get_ptr<const SaveJson::array_t*>();
+        if (elements.empty()) {
+            WriteRaw("[]", 2);
+            return;
+        }
+        Put('[');
+        bool first = true;
+        for (const SaveJson& element : elements) {
+            if (!first) {
+                Put(',');
+            }
+            first = false;
+            if (pretty) {
+                Put('\n');
+                WriteIndent(depth + 1);
+            }
+            WriteValue(element, depth + 1);
+        }
+        if (pretty) {
+            Put('\n');
+            WriteIndent(depth);
+        }
+        Put(']');
+        return;
+    }
+    case SaveJson::value_t::string:
+        WriteString(*value.get_ptr<const SaveJson::string_t*>());
+        return;
+    case SaveJson::value_t::boolean:
+        if (*value.get_ptr<const SaveJson::boolean_t*>()) {
+            WriteRaw("true", 4);
+        } else {
+            WriteRaw("false", 5);
+        }
+        return;
+    case SaveJson::value_t::number_integer:
+        WriteInteger(*value.get_ptr<const SaveJson::number_integer_t*>());
+        return;
+    case SaveJson::value_t::number_unsigned:
+        WriteUnsigned(*value.get_ptr<const SaveJson::number_unsigned_t*>(), false);
+        return;
+    case SaveJson::value_t::number_float:
+        WriteFloat(*value.get_ptr<const SaveJson::number_float_t*>());
+        return;
+    case SaveJson::value_t::null:
+        WriteRaw("null", 4);
+        return;
+    default: {
+        // Binary and discarded values never occur in saves; nlohmann's serializer writes them.
+        Flush();
+        nlohmann::detail::serializer<SaveJson> serializer(m_output, ' ');
+        serializer.dump(value, pretty, false, pretty ? static_cast<unsigned int>(m_indent) : 0,
+                        pretty ? static_cast<unsigned int>(depth * m_indent) : 0);
+        return;
+    }
+    }
+}
+
+void SaveJsonWriter::WriteString(const SaveJson::string_t& text) {
+    const char* chars = text.data();
+    const size_t length = text.size();
+    Put('"');
+    size_t i = 0;
+    while (i < length) {
+        const size_t special = FindSpecialByte(chars, i, length);
+        WriteRaw(chars + i, special - i);
+        if (special == length) {
+            break;
+        }
+        const unsigned char c = static_cast<unsigned char>(chars[special]);
+        if (c >= 0x80) {
+            // Copy the whole run of multi-byte sequences, checking each one.
+            size_t end = special;
+            while (end < length && static_cast<unsigned char>(chars[end]) >= 0x80) {
+                const size_t sequence = Utf8SequenceLength(reinterpret_cast<const unsigned char*>(chars + end), length - end);
+                if (sequence == 0) {
+                    ThrowInvalidUtf8(text);
+                }
+                end += sequence;
+            }
+            WriteRaw(chars + special, end - special);
+            i = end;
+            continue;
+        }
+        char* out = Reserve(6);
+        out[0] = '\\';
+        size_t written = 2;
+        switch (c) {
+        case '"':  out[1] = '"'; break;
+        case '\\': out[1] = '\\'; break;
+        case '\b': out[1] = 'b'; break;
+        case '\t': out[1] = 't'; break;
+        case '\n': out[1] = 'n'; break;
+        case '\f': out[1] = 'f'; break;
+        case '\r': out[1] = 'r'; break;
+        default:
+            out[1] = 'u';
+            out[2] = '0';
+            out[3] = '0';
+            out[4] = HEX_DIGITS[c >> 4];
+            out[5] = HEX_DIGITS[c & 0xF];
+            written = 6;
+            break;
+        }
+        m_used += written;
+        i = special + 1;
+    }
+    Put('"');
+}
+
+void SaveJsonWriter::WriteInteger(int64_t value) {
+    if (value < 0) {
+        WriteUnsigned(0 - static_cast<uint64_t>(value), true);
+    } else {
+        WriteUnsigned(static_cast<uint64_t>(value), false);
+    }
+}
+
+void SaveJsonWriter::WriteUnsigned(uint64_t value, bool negative) {
+    char* out = Reserve(21);
+    // Counts and levels are almost always one or two digits; write those without the general loop.
+    if (!negative && value < 100) {
+        if (value < 10) {
+            out[0] = static_cast<char>('0' + value);
+            m_used += 1;
+        } else {
+            out[0] = DIGIT_PAIRS[value * 2];
+            out[1] = DIGIT_PAIRS[value * 2 + 1];
+            m_used += 2;
+        }
+        return;
+    }
+    char digits[21];
+    char* p = digits + sizeof(digits);
+    while (value >= 100) {
+        const size_t pair = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        *--p = DIGIT_PAIRS[value * 2 + 1];
+        *--p = DIGIT_PAIRS[value * 2];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    if (negative) {
+        *--p = '-';
+    }
+    const size_t count = static_cast<size_t>(digits + sizeof(digits) - p);
+    memcpy(out, p, count);
+    m_used += count;
+}
+
+void SaveJsonWriter::WriteFloat(double value) {
+    if (!std::isfinite(value)) {
+        WriteRaw("null", 4);
+        return;
+    }
+    // nlohmann's own shortest round-trip formatting, so floats match dump() exactly.
+    char* out = Reserve(64);
+    char* end = nlohmann::detail::to_chars(out, out + 64, value);
+    m_used += static_cast<size_t>(end - out);
+}
+
+// --- Encoding ---
+void XorOutputAdapter::write_characters(const char* s, std::size_t length) {
+    if (m_scratch.size() < length) {
+        m_scratch.resize(length);
+    }
+    memcpy(m_scratch.data(), s, length);
+    XorWithKey(m_scratch.data(), length, m_key, m_offset);
+    m_offset += length;
+    m_output->write_characters(m_scratch.data(), length);
+}
+
+void EncodeSaveJson(const SaveJson& value, const SaveCodec& codec, std::string& out) {
+    nlohmann::detail::output_adapter_t<char> output = std::make_shared<nlohmann::detail::output_string_adapter<char, std::string>>(out);
+    if (codec.type == SAVE_CODEC_XOR) {
+        output = std::make_shared<XorOutputAdapter>(output, codec.key);
+    }
+    SaveJsonWriter writer(output);
+    writer.Write(value);
+}
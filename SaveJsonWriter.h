@@ -0,0 +1,104 @@
+// SaveJsonWriter.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SaveJson.h"       // For SaveJson, nlohmann::detail::output_adapter_t
+#include "SaveCodec.h"      // For SaveCodec
+
+// Size of the chunks SaveJsonWriter hands to its output.
+const size_t JSON_WRITER_CHUNK_SIZE = 64 * 1024;
+
+// Serializes SaveJson values, producing exactly the bytes SaveJson::dump() (or dump(indent)) would:
+// same escapes, same number formatting, and the same type_error for invalid UTF-8.
+// nlohmann's serializer walks strings one byte at a time through a UTF-8 decoder and makes a virtual
+// call for every token. This writer scans strings 16 bytes at a time (SSE2, when available) for bytes
+// that need escaping or are not ASCII, copies the clean runs in bulk, formats integers straight into
+// its own buffer, and passes the text on in JSON_WRITER_CHUNK_SIZE chunks.
+class SaveJsonWriter {
+public:
+    // indent: Indentation step; a negative value writes compact JSON.
+    explicit SaveJsonWriter(nlohmann::detail::output_adapter_t<char> output, int indent = -1);
+    ~SaveJsonWriter();
+    SaveJsonWriter(const SaveJsonWriter&) = delete;
+    SaveJsonWriter& operator=(const SaveJsonWriter&) = delete;
+
+    // Writes value and flushes. Throws SaveJson::type_error (316) on a string that is not valid UTF-8;
+    // the output then holds an incomplete document.
+    void Write(const SaveJson& value);
+
+private:
+    void WriteValue(const SaveJson& value, size_t depth);
+    void WriteString(const SaveJson::string_t& text);
+    void WriteInteger(int64_t value);
+    void WriteUnsigned(uint64_t value, bool negative);
+    void WriteFloat(double value);
+    void WriteIndent(size_t depth);
+    void WriteRaw(const char* data, size_t length);
+    // Returns room for length more bytes in the buffer, flushing first if needed. length must be small.
+    char* Reserve(size_t length) {
+        if (m_used + length > m_buffer.size()) {
+            Flush();
+        }
+        return m_buffer.data() + m_used;
+    }
+    void Put(char c) { *Reserve(1) = c; m_used++; }
+    void Flush();
+
+    nlohmann::detail::output_adapter_t<char> m_output;
+    std::vector<char> m_buffer;
+    size_t m_used;
+    int m_indent;
+};
+
+// Output adapter that XORs text with a repeating key before passing it on. The key position carries
+// over from one write to the next, so a serializer can encode a save while writing it.
+class XorOutputAdapter : public nlohmann::detail::output_adapter_protocol<char> {
+public:
+    XorOutputAdapter(nlohmann::detail::output_adapter_t<char> output, const std::string& key)
+        : m_output(output), m_key(key), m_offset(0) {}
+    void write_character(char c) override { write_characters(&c, 1); }
+    void write_characters(const char* s, std::size_t length) override;
+
+private:
+    nlohmann::detail::output_adapter_t<char> m_output;
+    std::string m_key;
+    size_t m_offset;            // Bytes written so far; the key position of the next byte.
+    std::vector<char> m_scratch;
+};
+
+// Serializes a save's data and encodes it with codec in the same pass, appending the file bytes to out.
+// Throws as SaveJsonWriter::Write does.
+void EncodeSaveJson(const SaveJson& value, const SaveCodec& codec, std::string& out);
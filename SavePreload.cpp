@@ -0,0 +1,108 @@
+// SavePreload.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SavePreload.h"
+#include <filesystem>   // For comparing paths
+#include "EditJournal.h" // For EditJournal::GetSourceFingerprint
+#include "Logger.h"     // For LogMessage
+
+SavePreload::~SavePreload() {
+    Close();
+}
+
+void SavePreload::Start(const std::string& savePath) {
+    Discard();
+    Join();
+    if (!EditJournal::GetSourceFingerprint(savePath, m_size, m_writeTime)) {
+        LogMessage(LOG_WARNING_LEVEL, ("Not preloading save file; it cannot be read: " + savePath).c_str());
+        return;
+    }
+    m_path = savePath;
+    m_discarded = false;
+    LogMessage(LOG_INFO_LEVEL, ("Preloading save file in the background: " + savePath).c_str());
+    m_thread = std::thread([this, savePath] {
+        // The manager is built here too, so the startup thread pays for none of the load.
+        std::unique_ptr<SaveGameManager> manager(new SaveGameManager());
+        if (!manager->LoadSaveFile(savePath) || m_discarded) {
+            manager.reset(); // Freed here rather than on the thread that discarded it.
+        }
+        m_manager = std::move(manager);
+    });
+}
+
+bool SavePreload::TakeInto(const std::string& savePath, SaveGameManager& target) {
+    if (m_path.empty()) {
+        return false;
+    }
+    if (std::filesystem::path(savePath).lexically_normal() != std::filesystem::path(m_path).lexically_normal()) {
+        LogMessage(LOG_INFO_LEVEL, "A different save file than the preloaded one was chosen; discarding the preload.");
+        Discard();
+        return false;
+    }
+    uint64_t size = 0;
+    int64_t write_time = 0;
+    if (!EditJournal::GetSourceFingerprint(savePath, size, write_time) || size != m_size || write_time != m_writeTime) {
+        LogMessage(LOG_INFO_LEVEL, "The save file changed after it was preloaded; discarding the preload.");
+        Discard();
+        return false;
+    }
+
+    Join();
+    std::unique_ptr<SaveGameManager> manager = std::move(m_manager);
+    m_path.clear();
+    if (!manager) {
+        // The background load failed; loading again reports why.
+        return false;
+    }
+    return target.AdoptSave(*manager);
+}
+
+void SavePreload::Discard() {
+    if (m_path.empty()) {
+        return;
+    }
+    m_discarded = true;
+    m_path.clear();
+}
+
+void SavePreload::Close() {
+    Discard();
+    Join();
+}
+
+void SavePreload::Join() {
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_discarded) {
+        m_manager.reset(); // Discarded after the background load checked; usually already empty.
+    }
+}
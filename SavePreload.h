@@ -0,0 +1,78 @@
+// SavePreload.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include "SaveGameManager.h"
+
+// Loads a save file on a background thread before it is asked for, so that the load the user then
+// confirms (normally the most recent save) completes at once. The preloaded save is only used if it
+// was loaded from the confirmed path and the file has not changed since; otherwise it is dropped and
+// the caller loads the file as usual.
+// Not thread-safe: one thread calls Start, TakeInto and Discard.
+class SavePreload {
+public:
+    SavePreload() = default;
+    // Waits for a load still running.
+    ~SavePreload();
+    SavePreload(const SavePreload&) = delete;
+    SavePreload& operator=(const SavePreload&) = delete;
+
+    // Starts loading savePath into a manager of its own on a background thread, replacing any earlier
+    // preload (and waiting for it, if it is still running). The file's size and write time are read
+    // first, so a write made after this call is noticed by TakeInto.
+    void Start(const std::string& savePath);
+    // Moves the preloaded save into target (see SaveGameManager::AdoptSave) if it was preloaded from
+    // savePath and the file still has the size and write time it had when the preload started, waiting
+    // for the load to finish if need be. Returns false otherwise, leaving target to load savePath itself.
+    // Either way the preload is used up.
+    bool TakeInto(const std::string& savePath, SaveGameManager& target);
+    // Drops the preload without waiting; a load still running frees its result on its own thread.
+    void Discard();
+    // Discards the preload and waits for a load still running. Called before shutting down the logger.
+    void Close();
+
+private:
+    // Waits for the background load, then frees its result if the preload was discarded meanwhile.
+    void Join();
+
+    std::thread m_thread;
+    std::unique_ptr<SaveGameManager> m_manager; // Set by the background thread; used only after Join.
+    std::atomic<bool> m_discarded{ false };
+    std::string m_path;                         // Save being preloaded; empty if none.
+    uint64_t m_size = 0;                        // Fingerprint of the file when the preload started.
+    int64_t m_writeTime = 0;
+};
@@ -0,0 +1,702 @@
+// SaveQuery.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveQuery.h"
+#include <algorithm>        // For std::min, std::max, std::sort
+#include <cstdio>           // For snprintf
+#include <cstdlib>          // For strtod, strtoll
+#include <cstring>          // For strncmp
+#include "SaveGameManager.h" // For MAX_SAVE_NESTING_DEPTH
+
+// --- Accumulator ---
+
+void SaveQueryAccumulator::Merge(const SaveQueryAccumulator& other) {
+    if (other.numericCount > 0) {
+        min = numericCount > 0 ? std::min(min, other.min) : other.min;
+        max = numericCount > 0 ? std::max(max, other.max) : other.max;
+    }
+    count += other.count;
+    numericCount += other.numericCount;
+    sum += other.sum;
+    for (const auto& entry : other.histogram) {
+        histogram[entry.first] += entry.second;
+    }
+}
+
+// --- Compiler ---
+
+static const char* const REDUCER_NAMES[] = { "", "count", "sum", "min", "max", "histogram" };
+
+// Recursive-descent parser for the query language; see SaveQuery for the grammar.
+class SaveQueryParser {
+public:
+    explicit SaveQueryParser(const std::string& text) : m_text(text), m_pos(0) {}
+
+    bool ParsePipeline(std::vector<SaveQueryStage>& out_stages, SaveQueryReducer& out_reducer) {
+        out_reducer = QUERY_REDUCE_NONE;
+        for (;;) {
+            SkipSpace();
+            if (out_reducer != QUERY_REDUCE_NONE) {
+                return Fail("a reducer must be the last stage");
+            }
+            SaveQueryStage stage;
+            if (MatchWord("select")) {
+                stage.kind = SaveQueryStage::STAGE_SELECT;
+                if (!Expect('(') || !ParseOr(stage.condition) || !Expect(')')) {
+                    return false;
+                }
+                out_stages.push_back(std::move(stage));
+            } else if (!MatchReducer(out_reducer)) {
+                stage.kind = SaveQueryStage::STAGE_PATH;
+                if (!ParsePath(stage.steps)) {
+                    return false;
+                }
+                out_stages.push_back(std::move(stage));
+            }
+            SkipSpace();
+            if (m_pos == m_text.size()) {
+                return true;
+            }
+            if (!Expect('|')) {
+                return false;
+            }
+        }
+    }
+
+    const std::string& GetError() const { return m_error; }
+
+private:
+    bool Fail(const std::string& message) {
+        if (m_error.empty()) {
+            m_error = message + " at position " + std::to_string(m_pos + 1);
+        }
+        return false;
+    }
+
+    void SkipSpace() {
+        while (m_pos < m_text.size() && isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos++;
+        }
+    }
+
+    static bool IsWordChar(char c) {
+        return isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool Expect(char c) {
+        SkipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            m_pos++;
+            return true;
+        }
+        return Fail(std::string("expected '") + c + "'");
+    }
+
+    // Consumes word if it appears next as a whole word.
+    bool MatchWord(const char* word) {
+        SkipSpace();
+        size_t length = strlen(word);
+        if (m_text.compare(m_pos, length, word) == 0 && (m_pos + length == m_text.size() || !IsWordChar(m_text[m_pos + length]))) {
+            m_pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    bool MatchReducer(SaveQueryReducer& out_reducer) {
+        for (int reducer = QUERY_REDUCE_COUNT; reducer <= QUERY_REDUCE_HISTOGRAM; ++reducer) {
+            if (MatchWord(REDUCER_NAMES[reducer])) {
+                out_reducer = static_cast<SaveQueryReducer>(reducer);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Parses a JSON string literal starting at the opening quote.
+    bool ParseString(std::string& out) {
+        size_t start = m_pos;
+        for (size_t i = m_pos + 1; i < m_text.size(); ++i) {
+            if (m_text[i] == '\\') {
+                ++i;
+            } else if (m_text[i] == '"') {
+                try {
+                    out = SaveJson::parse(m_text.begin() + start, m_text.begin() + i + 1).get<std::string>();
+                } catch (const std::exception&) {
+                    return Fail("invalid string literal");
+                }
+                m_pos = i + 1;
+                return true;
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseIdentifier(std::string& out) {
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && IsWordChar(m_text[m_pos])) {
+            m_pos++;
+        }
+        out.assign(m_text, start, m_pos - start);
+        return true;
+    }
+
+    // Parses "[]", "[<index>]" or "[\"key\"]" starting at the '['.
+    bool ParseBracket(std::vector<SaveQueryStep>& steps) {
+        m_pos++;
+        SkipSpace();
+        SaveQueryStep step;
+        step.index = 0;
+        if (m_pos < m_text.size() && m_text[m_pos] == ']') {
+            step.kind = SaveQueryStep::STEP_ITERATE;
+        } else if (m_pos < m_text.size() && m_text[m_pos] == '"') {
+            step.kind = SaveQueryStep::STEP_KEY;
+            if (!ParseString(step.key)) {
+                return false;
+            }
+        } else {
+            const char* start = m_text.c_str() + m_pos;
+            char* end = NULL;
+            step.kind = SaveQueryStep::STEP_INDEX;
+            step.index = strtoll(start, &end, 10);
+            if (end == start) {
+                return Fail("expected an index, a quoted key or ']'");
+            }
+            m_pos += end - start;
+        }
+        steps.push_back(step);
+        return Expect(']');
+    }
+
+    // Parses a path: "." followed by any number of .key, ."key", [..] steps.
+    bool ParsePath(std::vector<SaveQueryStep>& steps) {
+        SkipSpace();
+        if (m_pos >= m_text.size() || m_text[m_pos] != '.') {
+            return Fail("expected a path, select() or a reducer");
+        }
+        bool first = true;
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos];
+            char next = m_pos + 1 < m_text.size() ? m_text[m_pos + 1] : '\0';
+            if (c == '[') {
+                if (!ParseBracket(steps)) {
+                    return false;
+                }
+            } else if (c == '.' && (IsWordChar(next) || next == '"')) {
+                m_pos++;
+                SaveQueryStep step;
+                step.kind = SaveQueryStep::STEP_KEY;
+                step.index = 0;
+                if (!(next == '"' ? ParseString(step.key) : ParseIdentifier(step.key))) {
+                    return false;
+                }
+                steps.push_back(step);
+            } else if (c == '.' && first) {
+                m_pos++; // "." on its own, or ".[" with the bracket next.
+            } else {
+                break;
+            }
+            first = false;
+        }
+        return true;
+    }
+
+    bool ParseOperand(SaveQueryOperand& out) {
+        SkipSpace();
+        if (m_pos >= m_text.size()) {
+            return Fail("expected a value");
+        }
+        char c = m_text[m_pos];
+        if (c == '.') {
+            out.isPath = true;
+            if (!ParsePath(out.steps)) {
+                return false;
+            }
+            for (const SaveQueryStep& step : out.steps) {
+                if (step.kind == SaveQueryStep::STEP_ITERATE) {
+                    return Fail("select() paths cannot iterate with []");
+                }
+            }
+            return true;
+        }
+        if (c == '"') {
+            std::string value;
+            if (!ParseString(value)) {
+                return false;
+            }
+            out.literal = value;
+            return true;
+        }
+        if (MatchWord("true")) {
+            out.literal = true;
+        } else if (MatchWord("false")) {
+            out.literal = false;
+        } else if (MatchWord("null")) {
+            out.literal = nullptr;
+        } else {
+            const char* start = m_text.c_str() + m_pos;
+            char* end = NULL;
+            double number = strtod(start, &end);
+            if (end == start) {
+                return Fail("expected a path or a literal");
+            }
+            std::string token(start, static_cast<const char*>(end));
+            if (token.find_first_of(".eE") == std::string::npos) {
+                out.literal = static_cast<int64_t>(strtoll(start, NULL, 10));
+            } else {
+                out.literal = number;
+            }
+            m_pos += end - start;
+        }
+        return true;
+    }
+
+    bool ParseComparison(SaveQueryCondition& out) {
+        SkipSpace();
+        if (m_pos < m_text.size() && m_text[m_pos] == '(') {
+            m_pos++;
+            return ParseOr(out) && Expect(')');
+        }
+        if (!ParseOperand(out.left)) {
+            return false;
+        }
+        SkipSpace();
+        static const struct { const char* text; SaveQueryCondition::Op op; } OPERATORS[] = {
+            { "==", SaveQueryCondition::OP_EQ }, { "!=", SaveQueryCondition::OP_NE },
+            { "<=", SaveQueryCondition::OP_LE }, { ">=", SaveQueryCondition::OP_GE },
+            { "<", SaveQueryCondition::OP_LT }, { ">", SaveQueryCondition::OP_GT },
+        };
+        for (const auto& candidate : OPERATORS) {
+            size_t length = strlen(candidate.text);
+            if (m_text.compare(m_pos, length, candidate.text) == 0) {
+                m_pos += length;
+                out.kind = SaveQueryCondition::COND_COMPARE;
+                out.op = candidate.op;
+                return ParseOperand(out.right);
+            }
+        }
+        if (!out.left.isPath) {
+            return Fail("expected a comparison operator");
+        }
+        out.kind = SaveQueryCondition::COND_TRUTHY;
+        return true;
+    }
+
+    // and binds tighter than or, as in jq.
+    bool ParseBinary(SaveQueryCondition& out, const char* word, SaveQueryCondition::Kind kind, bool (SaveQueryParser::*operand)(SaveQueryCondition&)) {
+        if (!(this->*operand)(out)) {
+            return false;
+        }
+        while (MatchWord(word)) {
+            SaveQueryCondition combined;
+            combined.kind = kind;
+            combined.children.push_back(std::move(out));
+            combined.children.emplace_back();
+            if (!(this->*operand)(combined.children.back())) {
+                return false;
+            }
+            out = std::move(combined);
+        }
+        return true;
+    }
+
+    bool ParseAnd(SaveQueryCondition& out) {
+        return ParseBinary(out, "and", SaveQueryCondition::COND_AND, &SaveQueryParser::ParseComparison);
+    }
+
+    bool ParseOr(SaveQueryCondition& out) {
+        return ParseBinary(out, "or", SaveQueryCondition::COND_OR, &SaveQueryParser::ParseAnd);
+    }
+
+    const std::string& m_text;
+    size_t m_pos;
+    std::string m_error;
+};
+
+bool SaveQuery::Compile(const std::string& expression, std::string& out_error) {
+    m_stages.clear();
+    m_rootSections.clear();
+    SaveQueryParser parser(expression);
+    if (!parser.ParsePipeline(m_stages, m_reducer)) {
+        out_error = "Invalid query: " + parser.GetError();
+        m_stages.clear();
+        m_reducer = QUERY_REDUCE_NONE;
+        return false;
+    }
+    // A query that starts by naming a top-level section reads nothing else.
+    if (!m_stages.empty() && m_stages[0].kind == SaveQueryStage::STAGE_PATH && !m_stages[0].steps.empty() &&
+        m_stages[0].steps[0].kind == SaveQueryStep::STEP_KEY) {
+        m_rootSections.push_back(m_stages[0].steps[0].key);
+    }
+    return true;
+}
+
+// --- Evaluation ---
+
+// Follows steps from value and calls emit for every value they reach.
+template <class Emit>
+static void WalkPath(const std::vector<SaveQueryStep>& steps, size_t step, const SaveJson& value, const Emit& emit) {
+    if (step == steps.size()) {
+        emit(value);
+        return;
+    }
+    const SaveQueryStep& current = steps[step];
+    switch (current.kind) {
+        case SaveQueryStep::STEP_KEY:
+            if (value.is_object()) {
+                auto it = value.find(current.key);
+                if (it != value.end()) {
+                    WalkPath(steps, step + 1, *it, emit);
+                }
+            }
+            break;
+        case SaveQueryStep::STEP_INDEX:
+            if (value.is_array()) {
+                int64_t index = current.index < 0 ? current.index + static_cast<int64_t>(value.size()) : current.index;
+                if (index >= 0 && static_cast<uint64_t>(index) < value.size()) {
+                    WalkPath(steps, step + 1, value[static_cast<size_t>(index)], emit);
+                }
+            }
+            break;
+        case SaveQueryStep::STEP_ITERATE:
+            if (value.is_array() || value.is_object()) {
+                for (const SaveJson& child : value) {
+                    WalkPath(steps, step + 1, child, emit);
+                }
+            }
+            break;
+    }
+}
+
+// Returns the value an operand names, or NULL if its path reaches nothing.
+static const SaveJson* ResolveOperand(const SaveQueryOperand& operand, const SaveJson& value) {
+    if (!operand.isPath) {
+        return &operand.literal;
+    }
+    const SaveJson* found = NULL;
+    WalkPath(operand.steps, 0, value, [&found](const SaveJson& result) { found = &result; });
+    return found;
+}
+
+// Orders two numbers, comparing integers exactly rather than through double.
+static int CompareNumbers(const SaveJson& a, const SaveJson& b) {
+    if (a.is_number_float() || b.is_number_float()) {
+        double x = a.get<double>(), y = b.get<double>();
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+    bool a_big = a.is_number_unsigned() && a.get<uint64_t>() > static_cast<uint64_t>(INT64_MAX);
+    bool b_big = b.is_number_unsigned() && b.get<uint64_t>() > static_cast<uint64_t>(INT64_MAX);
+    if (a_big || b_big) {
+        if (a_big && b_big) {
+            uint64_t x = a.get<uint64_t>(), y = b.get<uint64_t>();
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+        return a_big ? 1 : -1;
+    }
+    int64_t x = a.get<int64_t>(), y = b.get<int64_t>();
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static bool Compare(const SaveJson& a, const SaveJson& b, SaveQueryCondition::Op op) {
+    int order;
+    if (a.is_number() && b.is_number()) {
+        order = CompareNumbers(a, b);
+    } else if (a.is_string() && b.is_string()) {
+        order = a.get_ref<const SaveJson::string_t&>().compare(b.get_ref<const SaveJson::string_t&>());
+    } else {
+        // Other types only compare equal or unequal.
+        bool equal = a == b;
+        return op == SaveQueryCondition::OP_EQ ? equal : (op == SaveQueryCondition::OP_NE ? !equal : false);
+    }
+    switch (op) {
+        case SaveQueryCondition::OP_EQ: return order == 0;
+        case SaveQueryCondition::OP_NE: return order != 0;
+        case SaveQueryCondition::OP_LT: return order < 0;
+        case SaveQueryCondition::OP_LE: return order <= 0;
+        case SaveQueryCondition::OP_GT: return order > 0;
+        case SaveQueryCondition::OP_GE: return order >= 0;
+    }
+    return false;
+}
+
+static bool TestCondition(const SaveQueryCondition& condition, const SaveJson& value) {
+    switch (condition.kind) {
+        case SaveQueryCondition::COND_AND:
+            return TestCondition(condition.children[0], value) && TestCondition(condition.children[1], value);
+        case SaveQueryCondition::COND_OR:
+            return TestCondition(condition.children[0], value) || TestCondition(condition.children[1], value);
+        case SaveQueryCondition::COND_TRUTHY: {
+            const SaveJson* found = ResolveOperand(condition.left, value);
+            return found && !found->is_null() && !(found->is_boolean() && !found->get<bool>());
+        }
+        case SaveQueryCondition::COND_COMPARE: {
+            const SaveJson* left = ResolveOperand(condition.left, value);
+            const SaveJson* right = ResolveOperand(condition.right, value);
+            return left && right && Compare(*left, *right, condition.op);
+        }
+    }
+    return false;
+}
+
+// Runs the stages from stage on, passing every final value to emit.
+template <class Emit>
+static void RunStages(const std::vector<SaveQueryStage>& stages, size_t stage, const SaveJson& value, const Emit& emit) {
+    if (stage == stages.size()) {
+        emit(value);
+        return;
+    }
+    const SaveQueryStage& current = stages[stage];
+    if (current.kind == SaveQueryStage::STAGE_SELECT) {
+        if (TestCondition(current.condition, value)) {
+            RunStages(stages, stage + 1, value, emit);
+        }
+        return;
+    }
+    WalkPath(current.steps, 0, value, [&](const SaveJson& result) { RunStages(stages, stage + 1, result, emit); });
+}
+
+void SaveQuery::Run(const SaveJson& save, const std::function<void(const SaveJson&)>& emit) const {
+    RunStages(m_stages, 0, save, emit);
+}
+
+void SaveQuery::Accumulate(const SaveJson& save, SaveQueryAccumulator& accumulator) const {
+    const bool histogram = m_reducer == QUERY_REDUCE_HISTOGRAM;
+    RunStages(m_stages, 0, save, [&](const SaveJson& value) {
+        accumulator.count++;
+        if (histogram) {
+            accumulator.histogram[value.dump()]++;
+        } else if (value.is_number()) {
+            double number = value.get<double>();
+            accumulator.min = accumulator.numericCount > 0 ? std::min(accumulator.min, number) : number;
+            accumulator.max = accumulator.numericCount > 0 ? std::max(accumulator.max, number) : number;
+            accumulator.sum += number;
+            accumulator.numericCount++;
+        }
+    });
+}
+
+std::vector<std::string> SaveQuery::DescribeResult(const SaveQueryAccumulator& accumulator) const {
+    std::vector<std::string> lines;
+    char line[160];
+    uint64_t skipped = accumulator.count - accumulator.numericCount;
+    switch (m_reducer) {
+        case QUERY_REDUCE_NONE:
+        case QUERY_REDUCE_COUNT:
+            lines.push_back("count: " + std::to_string(accumulator.count));
+            break;
+        case QUERY_REDUCE_SUM:
+            snprintf(line, sizeof(line), "sum: %.15g over %llu number(s), %llu non-numeric value(s) skipped", accumulator.sum,
+                     static_cast<unsigned long long>(accumulator.numericCount), static_cast<unsigned long long>(skipped));
+            lines.push_back(line);
+            break;
+        case QUERY_REDUCE_MIN:
+        case QUERY_REDUCE_MAX:
+            if (accumulator.numericCount == 0) {
+                lines.push_back(std::string(REDUCER_NAMES[m_reducer]) + ": no numeric values");
+                break;
+            }
+            snprintf(line, sizeof(line), "%s: %.15g over %llu number(s), %llu non-numeric value(s) skipped", REDUCER_NAMES[m_reducer],
+                     m_reducer == QUERY_REDUCE_MIN ? accumulator.min : accumulator.max,
+                     static_cast<unsigned long long>(accumulator.numericCount), static_cast<unsigned long long>(skipped));
+            lines.push_back(line);
+            break;
+        case QUERY_REDUCE_HISTOGRAM: {
+            // Most frequent first; ties in value order.
+            std::vector<std::pair<std::string, uint64_t>> buckets(accumulator.histogram.begin(), accumulator.histogram.end());
+            std::stable_sort(buckets.begin(), buckets.end(), [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+                return a.second > b.second;
+            });
+            for (const auto& bucket : buckets) {
+                lines.push_back(std::to_string(bucket.second) + "  " + bucket.first);
+            }
+            lines.push_back("histogram: " + std::to_string(buckets.size()) + " distinct value(s) over " + std::to_string(accumulator.count) + " result(s)");
+            break;
+        }
+    }
+    return lines;
+}
+
+// --- Section scan ---
+
+// Where one top-level member's value lies in the save text.
+struct TopLevelMember {
+    std::string key;
+    size_t begin;
+    size_t end;
+};
+
+// Skips a string starting at its opening quote; returns the position after the closing quote, or npos.
+static size_t SkipJsonString(const std::string& json, size_t pos) {
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\') {
+            ++pos;
+        } else if (json[pos] == '"') {
+            return pos + 1;
+        }
+    }
+    return std::string::npos;
+}
+
+static size_t SkipJsonSpace(const std::string& json, size_t pos) {
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' || json[pos] == '\r')) {
+        pos++;
+    }
+    return pos;
+}
+
+// Skips one value starting at pos, matching brackets outside strings. Only the structure is checked;
+// the parser validates whatever value is actually wanted. Returns the end position, or npos (setting
+// out_too_deep if the value nests past maxDepth).
+static size_t SkipJsonValue(const std::string& json, size_t pos, size_t depth, size_t maxDepth, bool& out_too_deep) {
+    if (pos >= json.size()) {
+        return std::string::npos;
+    }
+    char c = json[pos];
+    if (c == '"') {
+        return SkipJsonString(json, pos);
+    }
+    if (c != '{' && c != '[') {
+        // A number, true, false or null runs to the next delimiter.
+        while (pos < json.size() && json[pos] != ',' && json[pos] != '}' && json[pos] != ']' &&
+               json[pos] != ' ' && json[pos] != '\t' && json[pos] != '\n' && json[pos] != '\r') {
+            pos++;
+        }
+        return pos;
+    }
+    size_t level = 0;
+    for (; pos < json.size(); ++pos) {
+        c = json[pos];
+        if (c == '"') {
+            pos = SkipJsonString(json, pos);
+            if (pos == std::string::npos) {
+                return pos;
+            }
+            --pos;
+        } else if (c == '{' || c == '[') {
+            if (depth + ++level > maxDepth) {
+                out_too_deep = true;
+                return std::string::npos;
+            }
+        } else if (c == '}' || c == ']') {
+            if (--level == 0) {
+                return pos + 1;
+            }
+        }
+    }
+    return std::string::npos;
+}
+
+// Lists the members of the top-level object. Returns false if the text is not an object, nests past
+// MAX_SAVE_NESTING_DEPTH (setting out_too_deep), or is malformed in a way the bracket scan notices.
+static bool ScanTopLevelMembers(const std::string& json, std::vector<TopLevelMember>& out_members, bool& out_too_deep) {
+    size_t pos = 0;
+    if (json.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        pos = 3; // UTF-8 byte order mark, which the parser also accepts.
+    }
+    pos = SkipJsonSpace(json, pos);
+    if (pos >= json.size() || json[pos] != '{') {
+        return false;
+    }
+    pos = SkipJsonSpace(json, pos + 1);
+    if (pos < json.size() && json[pos] == '}') {
+        return SkipJsonSpace(json, pos + 1) == json.size();
+    }
+    for (;;) {
+        if (pos >= json.size() || json[pos] != '"') {
+            return false;
+        }
+        size_t key_end = SkipJsonString(json, pos);
+        if (key_end == std::string::npos) {
+            return false;
+        }
+        TopLevelMember member;
+        if (json.find('\\', pos) < key_end) {
+            try {
+                member.key = SaveJson::parse(json.begin() + pos, json.begin() + key_end).get<std::string>();
+            } catch (const std::exception&) {
+                return false;
+            }
+        } else {
+            member.key.assign(json, pos + 1, key_end - pos - 2);
+        }
+        pos = SkipJsonSpace(json, key_end);
+        if (pos >= json.size() || json[pos] != ':') {
+            return false;
+        }
+        member.begin = SkipJsonSpace(json, pos + 1);
+        member.end = SkipJsonValue(json, member.begin, 1, MAX_SAVE_NESTING_DEPTH, out_too_deep);
+        if (member.end == std::string::npos || member.end == member.begin) {
+            return false;
+        }
+        out_members.push_back(std::move(member));
+        pos = SkipJsonSpace(json, out_members.back().end);
+        if (pos < json.size() && json[pos] == ',') {
+            pos = SkipJsonSpace(json, pos + 1);
+        } else if (pos < json.size() && json[pos] == '}') {
+            return SkipJsonSpace(json, pos + 1) == json.size();
+        } else {
+            return false;
+        }
+    }
+}
+
+bool ParseSaveSections(const std::string& json, const std::vector<std::string>& sections, SaveJson& out_save, std::string& out_error) {
+    out_save = SaveJson();
+    try {
+        std::vector<TopLevelMember> members;
+        bool too_deep = false;
+        if (!ScanTopLevelMembers(json, members, too_deep)) {
+            if (too_deep) {
+                out_error = "Save data nests deeper than the limit of " + std::to_string(MAX_SAVE_NESTING_DEPTH) + " levels.";
+                return false;
+            }
+            // Let the parser say what is wrong; if it somehow accepts the text, use the full parse.
+            out_save = SaveJson::parse(json);
+            if (!out_save.is_object()) {
+                out_error = "Save data is not a JSON object.";
+                out_save = SaveJson();
+                return false;
+            }
+            return true;
+        }
+        out_save = SaveJson::object();
+        for (const TopLevelMember& member : members) {
+            if (sections.empty() || std::find(sections.begin(), sections.end(), member.key) != sections.end()) {
+                out_save[member.key] = SaveJson::parse(json.begin() + member.begin, json.begin() + member.end);
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        out_error = "JSON parse error: " + std::string(e.what());
+    }
+    out_save = SaveJson();
+    return false;
+}
@@ -0,0 +1,136 @@
+// SaveQuery.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstdint>
+#include <functional>       // For std::function
+#include <map>
+#include <string>
+#include <vector>
+#include "SaveJson.h"       // For SaveJson
+
+// Reducers a query can end with. Each folds the query's results into a SaveQueryAccumulator, so a run
+// over many saves keeps one small accumulator per worker instead of every result.
+enum SaveQueryReducer {
+    QUERY_REDUCE_NONE,      // No reducer: every result is reported.
+    QUERY_REDUCE_COUNT,     // Number of results.
+    QUERY_REDUCE_SUM,       // Sum of the numeric results.
+    QUERY_REDUCE_MIN,       // Smallest numeric result.
+    QUERY_REDUCE_MAX,       // Largest numeric result.
+    QUERY_REDUCE_HISTOGRAM  // Occurrences of each distinct result.
+};
+
+// Running totals of a reduced query. Accumulators filled by different workers are combined with Merge.
+struct SaveQueryAccumulator {
+    uint64_t count = 0;                         // Results seen.
+    uint64_t numericCount = 0;                  // Numeric results among them.
+    double sum = 0.0;                           // Sum of the numeric results.
+    double min = 0.0;                           // Smallest numeric result, if numericCount > 0.
+    double max = 0.0;                           // Largest numeric result, if numericCount > 0.
+    std::map<std::string, uint64_t> histogram;  // Result (as JSON text) -> occurrences, for QUERY_REDUCE_HISTOGRAM.
+
+    void Merge(const SaveQueryAccumulator& other);
+};
+
+// One step of a path: a member, an array element, or every child.
+struct SaveQueryStep {
+    enum Kind { STEP_KEY, STEP_INDEX, STEP_ITERATE };
+    Kind kind;
+    std::string key;        // For STEP_KEY.
+    int64_t index;          // For STEP_INDEX; negative counts from the end.
+};
+
+// One side of a comparison in select(): a path from the current value, or a literal.
+struct SaveQueryOperand {
+    bool isPath = false;
+    std::vector<SaveQueryStep> steps;
+    SaveJson literal;
+};
+
+// A select() condition: a comparison, a bare path (true if it yields a value other than false or null),
+// or an and/or of two conditions.
+struct SaveQueryCondition {
+    enum Kind { COND_COMPARE, COND_TRUTHY, COND_AND, COND_OR };
+    enum Op { OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE };
+    Kind kind = COND_TRUTHY;
+    Op op = OP_EQ;
+    SaveQueryOperand left;
+    SaveQueryOperand right;
+    std::vector<SaveQueryCondition> children;   // The two operands of COND_AND and COND_OR.
+};
+
+// One stage of the pipeline.
+struct SaveQueryStage {
+    enum Kind { STAGE_PATH, STAGE_SELECT };
+    Kind kind;
+    std::vector<SaveQueryStep> steps;           // For STAGE_PATH; empty for the identity path ".".
+    SaveQueryCondition condition;               // For STAGE_SELECT.
+};
+
+// A read-only query over save data, in a subset of jq:
+//   .Ingredients[] | select(.count < 10) | .ingredientsID
+//   .InventoryItemSlot[] | select(.itemID == 1010001 or .totalCount >= 999) | .totalCount | sum
+// Stages are separated by '|'. A stage is a path (".", ".key", ."quoted key", .key[], .key[0], .[]),
+// select(<condition>) with ==, !=, <, <=, >, >=, and, or and parentheses, or, as the last stage, one
+// of the reducers count, sum, min, max or histogram.
+// Unlike jq, a missing key or a step into the wrong type yields no value rather than null or an error,
+// so select(.count < 10) skips entries without a count.
+// The expression is compiled once into stages; running it walks the save in place without copying.
+class SaveQuery {
+public:
+    // Compiles an expression. On failure, out_error names the problem and its position.
+    bool Compile(const std::string& expression, std::string& out_error);
+
+    SaveQueryReducer GetReducer() const { return m_reducer; }
+    // Top-level save sections the query reads, or empty if it may read any of them. Only these need to
+    // be parsed; see ParseSaveSections.
+    const std::vector<std::string>& GetRootSections() const { return m_rootSections; }
+
+    // Runs the query (without its reducer) on save and passes every result to emit.
+    void Run(const SaveJson& save, const std::function<void(const SaveJson&)>& emit) const;
+    // Runs the query on save and folds its results into accumulator with the query's reducer.
+    void Accumulate(const SaveJson& save, SaveQueryAccumulator& accumulator) const;
+    // Describes a reducer's result for the log, one line per element (one per value for histograms).
+    std::vector<std::string> DescribeResult(const SaveQueryAccumulator& accumulator) const;
+
+private:
+    std::vector<SaveQueryStage> m_stages;
+    SaveQueryReducer m_reducer = QUERY_REDUCE_NONE;
+    std::vector<std::string> m_rootSections;
+};
+
+// Parses a decoded save, building only the named top-level sections (all of them if sections is empty).
+// A quick scan first finds where each top-level member's value starts and ends; only the wanted values
+// are handed to the JSON parser, so a query that reads Ingredients never builds Staff or SNSInfo. Falls
+// back to a full parse if the text cannot be scanned. Returns false and sets out_error if the save is
+// not a JSON object, nests too deeply, or does not parse.
+bool ParseSaveSections(const std::string& json, const std::vector<std::string>& sections, SaveJson& out_save, std::string& out_error);
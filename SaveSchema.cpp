@@ -0,0 +1,335 @@
+// SaveSchema.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveSchema.h"
+#include <stdexcept>    // For std::runtime_error
+#include <algorithm>    // For std::all_of
+
+// Maximum number of violation messages recorded; later violations are only counted.
+const size_t MAX_SCHEMA_MESSAGES = 20;
+
+// Names used for type flags in schema documents, indexed by bit position.
+static const char* const SCHEMA_TYPE_NAMES[] = { "null", "boolean", "integer", "float", "string", "object", "array" };
+const size_t SCHEMA_TYPE_NAME_COUNT = sizeof(SCHEMA_TYPE_NAMES) / sizeof(SCHEMA_TYPE_NAMES[0]);
+
+uint8_t GetSchemaType(const SaveJson& value) {
+    switch (value.type()) {
+        case SaveJson::value_t::null:                   return SCHEMA_TYPE_NULL;
+        case SaveJson::value_t::boolean:                return SCHEMA_TYPE_BOOLEAN;
+        case SaveJson::value_t::number_integer:
+        case SaveJson::value_t::number_unsigned:        return SCHEMA_TYPE_INTEGER;
+        case SaveJson::value_t::number_float:           return SCHEMA_TYPE_FLOAT;
+        case SaveJson::value_t::string:                 return SCHEMA_TYPE_STRING;
+        case SaveJson::value_t::object:                 return SCHEMA_TYPE_OBJECT;
+        case SaveJson::value_t::array:                  return SCHEMA_TYPE_ARRAY;
+        default:                                        return 0; // Binary and discarded values match nothing.
+    }
+}
+
+// Converts a type mask to a readable list such as "integer|string".
+static std::string TypeMaskToString(uint8_t mask) {
+    std::string names;
+    for (size_t bit = 0; bit < SCHEMA_TYPE_NAME_COUNT; ++bit) {
+        if (mask & (1 << bit)) {
+            if (!names.empty()) {
+                names += "|";
+            }
+            names += SCHEMA_TYPE_NAMES[bit];
+        }
+    }
+    return names.empty() ? "nothing" : names;
+}
+
+// Converts a schema document's "type" value (a name or an array of names) to a type mask.
+static uint8_t ParseTypeMask(const SaveJson& type_value, const std::string& context) {
+    std::vector<std::string> names;
+    if (type_value.is_string()) {
+        names.push_back(type_value.get<std::string>());
+    } else if (type_value.is_array()) {
+        for (const auto& name : type_value) {
+            if (!name.is_string()) {
+                throw std::runtime_error("Schema type names must be strings at " + context);
+            }
+            names.push_back(name.get<std::string>());
+        }
+    } else {
+        throw std::runtime_error("Schema field has no valid \"type\" at " + context);
+    }
+
+    uint8_t mask = 0;
+    for (const auto& name : names) {
+        size_t bit = 0;
+        while (bit < SCHEMA_TYPE_NAME_COUNT && name != SCHEMA_TYPE_NAMES[bit]) {
+            ++bit;
+        }
+        if (bit == SCHEMA_TYPE_NAME_COUNT) {
+            throw std::runtime_error("Unknown schema type \"" + name + "\" at " + context);
+        }
+        mask |= static_cast<uint8_t>(1 << bit);
+    }
+    return mask;
+}
+
+// Converts a type mask to a schema document "type" array.
+static SaveJson TypeMaskToDocument(uint8_t mask) {
+    SaveJson names = SaveJson::array();
+    for (size_t bit = 0; bit < SCHEMA_TYPE_NAME_COUNT; ++bit) {
+        if (mask & (1 << bit)) {
+            names.push_back(SCHEMA_TYPE_NAMES[bit]);
+        }
+    }
+    return names;
+}
+
+CompiledSaveSchema::CompiledSaveSchema(const SaveJson& schema_document) {
+    if (!schema_document.is_object() || !schema_document.contains("sections") || !schema_document["sections"].is_object()) {
+        throw std::runtime_error("Schema document must be an object with a \"sections\" object.");
+    }
+    for (auto it = schema_document["sections"].begin(); it != schema_document["sections"].end(); ++it) {
+        const SaveJson& section_doc = it.value();
+        Section section;
+        section.path = it.key();
+
+        // Pre-resolve the dot-separated path into its key tokens.
+        size_t start = 0;
+        while (start <= section.path.size()) {
+            size_t dot = section.path.find('.', start);
+            if (dot == std::string::npos) {
+                dot = section.path.size();
+            }
+            section.keys.push_back(section.path.substr(start, dot - start));
+            start = dot + 1;
+        }
+
+        std::string kind = section_doc.value("kind", "object");
+        if (kind != "object" && kind != "entries") {
+            throw std::runtime_error("Unknown section kind \"" + kind + "\" for " + section.path);
+        }
+        section.entries = (kind == "entries");
+
+        if (section_doc.contains("fields") && section_doc["fields"].is_object()) {
+            for (auto field_it = section_doc["fields"].begin(); field_it != section_doc["fields"].end(); ++field_it) {
+                std::string context = section.path + "." + field_it.key();
+                Field field;
+                field.key = field_it.key();
+                field.typeMask = ParseTypeMask(field_it.value().contains("type") ? field_it.value()["type"] : SaveJson(), context);
+                field.required = field_it.value().value("required", false);
+                section.fields.push_back(field);
+            }
+        }
+        m_sections.push_back(section);
+    }
+}
+
+// Records a violation, keeping a readable message for the first few.
+static void AddViolation(SchemaValidationResult& result, const std::string& message) {
+    if (result.messages.size() < MAX_SCHEMA_MESSAGES) {
+        result.messages.push_back(message);
+    }
+    result.errorCount++;
+}
+
+SchemaValidationResult CompiledSaveSchema::Validate(const SaveJson& save_data) const {
+    SchemaValidationResult result;
+    if (!save_data.is_object()) {
+        AddViolation(result, "Save data root is not an object.");
+        return result;
+    }
+
+    for (const auto& section : m_sections) {
+        // Resolve the section path. Sections absent from the save are not an error: the editor only
+        // touches sections that exist (or creates them with the correct shape).
+        const SaveJson* node = &save_data;
+        for (const auto& key : section.keys) {
+            if (!node->is_object()) {
+                node = nullptr;
+                break;
+            }
+            auto found = node->find(key);
+            if (found == node->end()) {
+                node = nullptr;
+                break;
+            }
+            node = &found.value();
+        }
+        if (!node) {
+            continue;
+        }
+
+        // where() builds the object's location for messages; it is only called once a violation is found,
+        // so valid entries cost no string building.
+        auto check_object = [&](const SaveJson& object, const auto& where) {
+            if (!object.is_object()) {
+                AddViolation(result, where() + ": expected object, found " + TypeMaskToString(GetSchemaType(object)));
+                return;
+            }
+            for (const auto& field : section.fields) {
+                auto value = object.find(field.key);
+                if (value == object.end()) {
+                    if (field.required) {
+                        AddViolation(result, where() + ": missing required field \"" + field.key + "\"");
+                    }
+                } else if ((GetSchemaType(*value) & field.typeMask) == 0) {
+                    AddViolation(result, where() + "." + field.key + ": expected " + TypeMaskToString(field.typeMask) + ", found " + TypeMaskToString(GetSchemaType(*value)));
+                }
+            }
+        };
+
+        if (!section.entries) {
+            check_object(*node, [&] { return section.path; });
+        } else if (node->is_object()) {
+            for (auto entry = node->begin(); entry != node->end(); ++entry) {
+                check_object(entry.value(), [&] { return section.path + "[\"" + entry.key() + "\"]"; });
+            }
+        } else if (node->is_array()) {
+            for (size_t index = 0; index < node->size(); ++index) {
+                check_object((*node)[index], [&] { return section.path + "[" + std::to_string(index) + "]"; });
+            }
+        } else {
+            AddViolation(result, section.path + ": expected object or array of entries, found " + TypeMaskToString(GetSchemaType(*node)));
+        }
+    }
+    return result;
+}
+
+const SaveJson& CompiledSaveSchema::DefaultSchemaDocument() {
+    // Describes the sections and fields the editor itself reads and writes.
+    static const SaveJson schema = SaveJson::parse(R"({
+        "sections": {
+            "PlayerInfo": { "kind": "object", "fields": {
+                "m_Gold":       { "type": ["integer"] },
+                "m_Bei":        { "type": ["integer"] },
+                "m_ChefFlame":  { "type": ["integer"] }
+            } },
+            "SNSInfo": { "kind": "object", "fields": {
+                "m_Follow_Count": { "type": ["integer"] }
+            } },
+            "Ingredients": { "kind": "entries", "fields": {
+                "ingredientsID":    { "type": ["integer"], "required": true },
+                "count":            { "type": ["integer"], "required": true },
+                "level":            { "type": ["integer"] },
+                "parentID":         { "type": ["integer"] },
+                "branchCount":      { "type": ["integer"] },
+                "lastGainTime":     { "type": ["string"] },
+                "lastGainGameTime": { "type": ["string"] },
+                "isNew":            { "type": ["boolean"] },
+                "placeTagMask":     { "type": ["integer"] }
+            } },
+            "InventoryItemSlot": { "kind": "entries", "fields": {
+                "itemID":       { "type": ["integer"], "required": true },
+                "totalCount":   { "type": ["integer"], "required": true }
+            } },
+            "Staff": { "kind": "entries", "fields": {
+                "name":         { "type": ["string"], "required": true },
+                "level":        { "type": ["integer"], "required": true }
+            } }
+        }
+    })");
+    return schema;
+}
+
+// Returns true if every key of the object is a non-empty string of digits (e.g., item ID keyed maps).
+static bool HasOnlyNumericKeys(const SaveJson& object) {
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        const std::string& key = it.key();
+        if (key.empty() || !std::all_of(key.begin(), key.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SaveSchemaInferrer::AddObjectFields(SectionStats& stats, const SaveJson& object) {
+    stats.observedCount++;
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        FieldStats& field = stats.fields[it.key()];
+        field.typeMask |= GetSchemaType(it.value());
+        field.presentCount++;
+    }
+}
+
+void SaveSchemaInferrer::AddSample(const SaveJson& save_data) {
+    if (!save_data.is_object()) {
+        return;
+    }
+    m_sampleCount++;
+    for (auto it = save_data.begin(); it != save_data.end(); ++it) {
+        const SaveJson& value = it.value();
+        bool entries;
+        if (value.is_array()) {
+            entries = std::all_of(value.begin(), value.end(), [](const SaveJson& v) { return v.is_object(); });
+            if (!entries) {
+                continue; // Arrays of scalars carry no field structure to learn.
+            }
+        } else if (value.is_object()) {
+            entries = !value.empty() && HasOnlyNumericKeys(value) &&
+                      std::all_of(value.begin(), value.end(), [](const SaveJson& v) { return v.is_object(); });
+        } else {
+            continue; // Top-level scalars are not sections.
+        }
+
+        auto existing = m_sections.find(it.key());
+        SectionStats& stats = m_sections[it.key()];
+        if (existing == m_sections.end()) {
+            stats.entries = entries;
+        } else if (stats.entries != entries) {
+            stats.kindConflict = true;
+            continue;
+        }
+
+        if (entries) {
+            for (const auto& entry : value) {
+                AddObjectFields(stats, entry);
+            }
+        } else {
+            AddObjectFields(stats, value);
+        }
+    }
+}
+
+SaveJson SaveSchemaInferrer::BuildSchemaDocument() const {
+    SaveJson sections = SaveJson::object();
+    for (const auto& section : m_sections) {
+        const SectionStats& stats = section.second;
+        if (stats.kindConflict || stats.observedCount == 0) {
+            continue;
+        }
+        SaveJson fields = SaveJson::object();
+        for (const auto& field : stats.fields) {
+            fields[field.first] = {
+                { "type", TypeMaskToDocument(field.second.typeMask) },
+                { "required", field.second.presentCount == stats.observedCount }
+            };
+        }
+        sections[section.first] = { { "kind", stats.entries ? "entries" : "object" }, { "fields", fields } };
+    }
+    return { { "sections", sections } };
+}
@@ -0,0 +1,127 @@
+// SaveSchema.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "SaveJson.h"       // For SaveJson
+
+// Bit flags for the JSON value types a schema field accepts.
+enum SchemaTypeFlags : uint8_t {
+    SCHEMA_TYPE_NULL    = 1 << 0,
+    SCHEMA_TYPE_BOOLEAN = 1 << 1,
+    SCHEMA_TYPE_INTEGER = 1 << 2,   // Signed or unsigned integers.
+    SCHEMA_TYPE_FLOAT   = 1 << 3,
+    SCHEMA_TYPE_STRING  = 1 << 4,
+    SCHEMA_TYPE_OBJECT  = 1 << 5,
+    SCHEMA_TYPE_ARRAY   = 1 << 6
+};
+
+// Result of validating a save against a compiled schema.
+struct SchemaValidationResult {
+    size_t errorCount = 0;              // Total number of violations found.
+    std::vector<std::string> messages;  // Descriptions of the first violations (capped to keep failures cheap).
+    bool IsValid() const { return errorCount == 0; }
+};
+
+// A save schema compiled for fast validation. Section paths are split into key tokens and field type
+// names into bit masks once, so validating a save is a single linear pass with no string parsing.
+//
+// Schema documents have the form:
+//   { "sections": { "<path>": { "kind": "object" | "entries",
+//                               "fields": { "<key>": { "type": ["integer", ...], "required": true } } } } }
+// A section path is a dot-separated list of keys from the document root. For "object" sections the
+// fields describe the section itself; for "entries" sections they describe every value of the section
+// (every member of an object, or every element of an array).
+class CompiledSaveSchema {
+public:
+    // Compiles a schema document. Throws std::runtime_error if the document is malformed.
+    explicit CompiledSaveSchema(const SaveJson& schema_document);
+
+    // Validates a save document in one pass over the sections the schema describes.
+    SchemaValidationResult Validate(const SaveJson& save_data) const;
+
+    // Returns the built-in schema for the sections the editor reads and writes.
+    static const SaveJson& DefaultSchemaDocument();
+
+private:
+    struct Field {
+        std::string key;
+        uint8_t typeMask;
+        bool required;
+    };
+    struct Section {
+        std::string path;                   // Original path, for messages.
+        std::vector<std::string> keys;      // Pre-resolved path tokens.
+        bool entries;                       // True if fields apply to each value of the section.
+        std::vector<Field> fields;
+    };
+
+    std::vector<Section> m_sections;
+};
+
+// The SaveSchemaInferrer class builds a schema document from a corpus of real saves.
+// Samples are accumulated one at a time, so the corpus never needs to be held in memory at once.
+class SaveSchemaInferrer {
+public:
+    // Adds one parsed save to the corpus statistics.
+    void AddSample(const SaveJson& save_data);
+
+    // Returns the number of samples added so far.
+    size_t GetSampleCount() const { return m_sampleCount; }
+
+    // Builds a schema document: a field is required if it appeared in every observed entry,
+    // and accepts every type it was observed with.
+    SaveJson BuildSchemaDocument() const;
+
+private:
+    struct FieldStats {
+        uint8_t typeMask = 0;
+        size_t presentCount = 0;
+    };
+    struct SectionStats {
+        bool entries = false;
+        bool kindConflict = false;          // Seen as both "object" and "entries"; skipped when building.
+        size_t observedCount = 0;           // Number of objects the field statistics were gathered from.
+        std::map<std::string, FieldStats> fields;
+    };
+
+    void AddObjectFields(SectionStats& stats, const SaveJson& object);
+
+    std::map<std::string, SectionStats> m_sections;
+    size_t m_sampleCount = 0;
+};
+
+// Returns the schema type flag for a JSON value.
+uint8_t GetSchemaType(const SaveJson& value);
@@ -0,0 +1,199 @@
+// SaveSessionCache.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveSessionCache.h"
+#include <filesystem>   // For std::filesystem::create_directories, remove
+#include <fstream>      // For reading and writing snapshot files
+#include <vector>
+#include "Logger.h"     // For LogMessage
+
+// --- Snapshot files ---
+static bool WriteSnapshotFile(const std::string& path, const std::vector<unsigned char>& snapshot, std::string& out_error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(reinterpret_cast<const char*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()))) {
+        out_error = "Could not write session snapshot: " + path;
+        return false;
+    }
+    return true;
+}
+
+static bool ReadSnapshotFile(const std::string& path, std::vector<unsigned char>& out_snapshot, std::string& out_error) {
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    std::streamoff size = input ? static_cast<std::streamoff>(input.tellg()) : -1;
+    if (size < 0) {
+        out_error = "Could not open session snapshot: " + path;
+        return false;
+    }
+    out_snapshot.resize(static_cast<size_t>(size));
+    input.seekg(0);
+    if (size > 0 && !input.read(reinterpret_cast<char*>(out_snapshot.data()), size)) {
+        out_error = "Could not read session snapshot: " + path;
+        return false;
+    }
+    return true;
+}
+
+static void RemoveSnapshotFile(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::remove(std::filesystem::path(path), ec);
+}
+
+// --- SaveSessionCache ---
+SaveSessionCache::SaveSessionCache(size_t memoryBudget, const std::string& snapshotDir)
+    : m_memoryBudget(memoryBudget), m_snapshotDir(snapshotDir) {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(snapshotDir), ec);
+}
+
+SaveSessionCache::~SaveSessionCache() {
+    for (const auto& entry : m_sessions) {
+        RemoveSnapshotFile(entry.second.snapshotPath);
+    }
+}
+
+size_t SaveSessionCache::GetResidentCount() const {
+    size_t count = 0;
+    for (const auto& entry : m_sessions) {
+        count += entry.second.manager ? 1 : 0;
+    }
+    return count;
+}
+
+std::unique_ptr<SaveGameManager> SaveSessionCache::NewManager(const Session& session) const {
+    std::unique_ptr<SaveGameManager> manager(new SaveGameManager());
+    if (m_setup) {
+        m_setup(*manager);
+    }
+    if (!session.journalPath.empty()) {
+        manager->EnableEditJournal(session.journalPath);
+    }
+    return manager;
+}
+
+SaveGameManager* SaveSessionCache::Acquire(const std::string& sessionId, const std::string& savePath) {
+    // The session handed out last may have been edited since; measure it again.
+    auto last = m_sessions.find(m_lastAcquired);
+    if (last != m_sessions.end() && last->second.manager) {
+        m_residentBytes -= last->second.bytes;
+        last->second.bytes = last->second.manager->EstimateMemoryUsage();
+        m_residentBytes += last->second.bytes;
+    }
+
+    auto it = m_sessions.find(sessionId);
+    const bool is_new = it == m_sessions.end();
+    if (is_new) {
+        it = m_sessions.emplace(sessionId, Session()).first;
+        const std::string base = (std::filesystem::path(m_snapshotDir) / ("session_" + std::to_string(m_nextFileNumber++))).string();
+        it->second.snapshotPath = base + ".snap";
+        if (m_journaling) {
+            it->second.journalPath = base + ".journal";
+        }
+        m_recency.push_front(sessionId);
+        it->second.recency = m_recency.begin();
+    } else {
+        m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+    }
+    Session& session = it->second;
+
+    if (session.manager) {
+        m_stats.hits++;
+    } else {
+        std::unique_ptr<SaveGameManager> manager = NewManager(session);
+        if (is_new) {
+            if (!manager->LoadSaveFile(savePath)) {
+                m_recency.erase(session.recency);
+                m_sessions.erase(it);
+                return NULL;
+            }
+            m_stats.loads++;
+        } else {
+            std::vector<unsigned char> snapshot;
+            std::string error;
+            if (!ReadSnapshotFile(session.snapshotPath, snapshot, error) || !manager->RestoreSessionSnapshot(snapshot, error)) {
+                LogMessage(LOG_ERROR_LEVEL, ("Could not restore session " + sessionId + ": " + error).c_str());
+                return NULL; // The snapshot is kept, so a later request can try again.
+            }
+            RemoveSnapshotFile(session.snapshotPath); // Out of date as soon as the session is edited.
+            m_stats.restores++;
+        }
+        session.manager = std::move(manager);
+        session.bytes = session.manager->EstimateMemoryUsage();
+        m_residentBytes += session.bytes;
+    }
+    m_lastAcquired = sessionId;
+    EvictToBudget(&session);
+    return session.manager.get();
+}
+
+void SaveSessionCache::Close(const std::string& sessionId) {
+    auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    Session& session = it->second;
+    if (session.manager) {
+        session.manager->DiscardEditJournal();
+        m_residentBytes -= session.bytes;
+    } else if (!session.journalPath.empty()) {
+        EditJournal::Remove(session.journalPath);
+    }
+    RemoveSnapshotFile(session.snapshotPath);
+    m_recency.erase(session.recency);
+    if (m_lastAcquired == sessionId) {
+        m_lastAcquired.clear();
+    }
+    m_sessions.erase(it);
+}
+
+void SaveSessionCache::EvictToBudget(const Session* keep) {
+    for (auto it = m_recency.rbegin(); it != m_recency.rend() && m_residentBytes > m_memoryBudget; ++it) {
+        Session& session = m_sessions.find(*it)->second;
+        if (&session != keep && session.manager) {
+            Evict(*it, session);
+        }
+    }
+}
+
+bool SaveSessionCache::Evict(const std::string& sessionId, Session& session) {
+    std::vector<unsigned char> snapshot;
+    std::string error;
+    if (!session.manager->WriteSessionSnapshot(snapshot, error) || !WriteSnapshotFile(session.snapshotPath, snapshot, error)) {
+        LogMessage(LOG_WARNING_LEVEL, ("Could not evict session " + sessionId + "; keeping it in memory: " + error).c_str());
+        return false;
+    }
+    m_residentBytes -= session.bytes;
+    session.bytes = 0;
+    // The manager's journal file is closed but kept, so the session's edits still survive a crash.
+    session.manager.reset();
+    m_stats.evictions++;
+    LogMessage(LOG_INFO_LEVEL, ("Session " + sessionId + " evicted to a " + std::to_string(snapshot.size()) + " byte snapshot.").c_str());
+    return true;
+}
@@ -0,0 +1,109 @@
+// SaveSessionCache.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "SaveGameManager.h"
+
+// Counters of how a SaveSessionCache met its requests.
+struct SaveSessionCacheStats {
+    size_t hits = 0;        // Sessions found in memory.
+    size_t loads = 0;       // Sessions started by loading their save file.
+    size_t restores = 0;    // Evicted sessions brought back from their snapshot.
+    size_t evictions = 0;   // Sessions written to a snapshot to make room.
+};
+
+// Open editing sessions, one SaveGameManager each, kept within a memory budget for a process that
+// holds many saves open at once. When the sessions in memory exceed the budget, the least recently
+// used are written to binary snapshots on disk (see SaveGameManager::WriteSessionSnapshot), edit
+// journal included, and dropped. Asking for an evicted session restores it from its snapshot, which is
+// quicker than loading the save file and keeps its unsaved edits.
+// Not thread-safe.
+class SaveSessionCache {
+public:
+    // memoryBudget is in bytes, as estimated by SaveGameManager::EstimateMemoryUsage. The session just
+    // asked for always stays in memory, even if it alone is over budget. Snapshots, and the edit
+    // journals when enabled, go in snapshotDir, which is created if needed.
+    SaveSessionCache(size_t memoryBudget, const std::string& snapshotDir);
+    // Deletes the snapshots. Edit journals are kept, as for a session that was never written.
+    ~SaveSessionCache();
+    SaveSessionCache(const SaveSessionCache&) = delete;
+    SaveSessionCache& operator=(const SaveSessionCache&) = delete;
+
+    // Called with every session's manager before its save is loaded or restored, to apply the process's
+    // settings (schema, item catalog, change subscriptions).
+    void SetSessionSetup(std::function<void(SaveGameManager&)> setup) { m_setup = std::move(setup); }
+    // Gives every session started from now on an edit journal of its own in the snapshot directory.
+    void EnableEditJournals() { m_journaling = true; }
+
+    // Returns the session named sessionId, loading savePath into a new one if there is no such session
+    // (savePath is ignored otherwise). Returns NULL if the save or snapshot cannot be loaded. The pointer
+    // is valid until the next Acquire or Close, which may evict the session.
+    SaveGameManager* Acquire(const std::string& sessionId, const std::string& savePath);
+    // Ends a session, deleting its snapshot and discarding its edit journal.
+    void Close(const std::string& sessionId);
+
+    size_t GetSessionCount() const { return m_sessions.size(); }
+    size_t GetResidentCount() const;
+    // Estimated memory held by the sessions in memory.
+    size_t GetResidentBytes() const { return m_residentBytes; }
+    const SaveSessionCacheStats& GetStats() const { return m_stats; }
+
+private:
+    struct Session {
+        std::unique_ptr<SaveGameManager> manager;   // NULL while evicted.
+        std::string snapshotPath;
+        std::string journalPath;                    // Empty if journaling was off when it started.
+        size_t bytes = 0;                           // Estimated memory, while in memory.
+        std::list<std::string>::iterator recency;   // Position in m_recency.
+    };
+
+    std::unique_ptr<SaveGameManager> NewManager(const Session& session) const;
+    // Writes the least recently used sessions, other than keep, to snapshots until within budget.
+    void EvictToBudget(const Session* keep);
+    bool Evict(const std::string& sessionId, Session& session);
+
+    size_t m_memoryBudget;
+    std::string m_snapshotDir;
+    std::function<void(SaveGameManager&)> m_setup;
+    bool m_journaling = false;
+    std::unordered_map<std::string, Session> m_sessions;
+    std::list<std::string> m_recency;   // Session IDs, most recently used first.
+    std::string m_lastAcquired;         // Its memory is measured again on the next Acquire: it may have been edited.
+    size_t m_residentBytes = 0;
+    size_t m_nextFileNumber = 0;
+    SaveSessionCacheStats m_stats;
+};
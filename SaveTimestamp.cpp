@@ -0,0 +1,125 @@
+// SaveTimestamp.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "SaveTimestamp.h"
+#include <ctime>        // For std::time, localtime_s
+
+// Reads two ASCII digits. Returns false if either character is not a digit.
+static inline bool ReadTwoDigits(const char* p, unsigned& out) {
+    unsigned d0 = static_cast<unsigned char>(p[0]) - '0';
+    unsigned d1 = static_cast<unsigned char>(p[1]) - '0';
+    if (d0 > 9 || d1 > 9) {
+        return false;
+    }
+    out = d0 * 10 + d1;
+    return true;
+}
+
+// Writes a value in [0, 99] as two ASCII digits.
+static inline void WriteTwoDigits(char* p, unsigned value) {
+    p[0] = static_cast<char>('0' + value / 10);
+    p[1] = static_cast<char>('0' + value % 10);
+}
+
+static bool IsLeapYear(unsigned year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static unsigned DaysInMonth(unsigned year, unsigned month) {
+    static const unsigned char DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    return (month == 2 && IsLeapYear(year)) ? 29 : DAYS[month - 1];
+}
+
+bool ParseSaveTimestamp(const char* text, size_t length, SaveTimestamp& out) {
+    // Layout: MM/DD/YYYY HH:MM:SS
+    //         0123456789012345678
+    if (length != SAVE_TIMESTAMP_LENGTH || text[2] != '/' || text[5] != '/' || text[10] != ' ' ||
+        text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+    unsigned month, day, century, year_in_century, hour, minute, second;
+    if (!ReadTwoDigits(text + 0, month) || !ReadTwoDigits(text + 3, day) ||
+        !ReadTwoDigits(text + 6, century) || !ReadTwoDigits(text + 8, year_in_century) ||
+        !ReadTwoDigits(text + 11, hour) || !ReadTwoDigits(text + 14, minute) || !ReadTwoDigits(text + 17, second)) {
+        return false;
+    }
+    unsigned year = century * 100 + year_in_century;
+    if (month < 1 || month > 12 || day < 1 || day > DaysInMonth(year, month) || hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    out.year = static_cast<uint16_t>(year);
+    out.month = static_cast<uint8_t>(month);
+    out.day = static_cast<uint8_t>(day);
+    out.hour = static_cast<uint8_t>(hour);
+    out.minute = static_cast<uint8_t>(minute);
+    out.second = static_cast<uint8_t>(second);
+    return true;
+}
+
+void FormatSaveTimestamp(const SaveTimestamp& timestamp, char* out) {
+    WriteTwoDigits(out + 0, timestamp.month);
+    out[2] = '/';
+    WriteTwoDigits(out + 3, timestamp.day);
+    out[5] = '/';
+    WriteTwoDigits(out + 6, timestamp.year / 100 % 100);
+    WriteTwoDigits(out + 8, timestamp.year % 100);
+    out[10] = ' ';
+    WriteTwoDigits(out + 11, timestamp.hour);
+    out[13] = ':';
+    WriteTwoDigits(out + 14, timestamp.minute);
+    out[16] = ':';
+    WriteTwoDigits(out + 17, timestamp.second);
+}
+
+void FormatCompactTimestamp(const SaveTimestamp& timestamp, char* out) {
+    WriteTwoDigits(out + 0, timestamp.year / 100 % 100);
+    WriteTwoDigits(out + 2, timestamp.year % 100);
+    WriteTwoDigits(out + 4, timestamp.month);
+    WriteTwoDigits(out + 6, timestamp.day);
+    out[8] = '_';
+    WriteTwoDigits(out + 9, timestamp.hour);
+    WriteTwoDigits(out + 11, timestamp.minute);
+    WriteTwoDigits(out + 13, timestamp.second);
+}
+
+SaveTimestamp CurrentLocalTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm_buf;
+    localtime_s(&tm_buf, &now); // Use localtime_s for thread safety on Windows
+    SaveTimestamp timestamp;
+    timestamp.year = static_cast<uint16_t>(tm_buf.tm_year + 1900);
+    timestamp.month = static_cast<uint8_t>(tm_buf.tm_mon + 1);
+    timestamp.day = static_cast<uint8_t>(tm_buf.tm_mday);
+    timestamp.hour = static_cast<uint8_t>(tm_buf.tm_hour);
+    timestamp.minute = static_cast<uint8_t>(tm_buf.tm_min);
+    timestamp.second = static_cast<uint8_t>(tm_buf.tm_sec > 59 ? 59 : tm_buf.tm_sec); // Clamp leap seconds.
+    return timestamp;
+}
@@ -0,0 +1,89 @@
+// SaveTimestamp.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Length of the save file's fixed timestamp layout "MM/DD/YYYY HH:MM:SS" (e.g., lastGainTime).
+const size_t SAVE_TIMESTAMP_LENGTH = 19;
+// Length of the compact file name timestamp layout "YYYYMMDD_HHMMSS" (e.g., backup names).
+const size_t COMPACT_TIMESTAMP_LENGTH = 15;
+
+// A broken-down timestamp as stored in save files. Parsing and formatting are done by hand on fixed
+// layouts, with no allocation, iostreams or locale involvement.
+struct SaveTimestamp {
+    uint16_t year = 1970;
+    uint8_t month = 1;
+    uint8_t day = 1;
+    uint8_t hour = 0;
+    uint8_t minute = 0;
+    uint8_t second = 0;
+
+    // Returns a key that orders timestamps chronologically.
+    uint64_t SortKey() const {
+        return (static_cast<uint64_t>(year) << 40) | (static_cast<uint64_t>(month) << 32) |
+               (static_cast<uint64_t>(day) << 24) | (static_cast<uint64_t>(hour) << 16) |
+               (static_cast<uint64_t>(minute) << 8) | second;
+    }
+    // Rebuilds a timestamp from its SortKey() (e.g., one stored in the edit journal).
+    static SaveTimestamp FromSortKey(uint64_t key) {
+        SaveTimestamp timestamp;
+        timestamp.year = static_cast<uint16_t>(key >> 40);
+        timestamp.month = static_cast<uint8_t>(key >> 32);
+        timestamp.day = static_cast<uint8_t>(key >> 24);
+        timestamp.hour = static_cast<uint8_t>(key >> 16);
+        timestamp.minute = static_cast<uint8_t>(key >> 8);
+        timestamp.second = static_cast<uint8_t>(key);
+        return timestamp;
+    }
+    bool operator<(const SaveTimestamp& other) const { return SortKey() < other.SortKey(); }
+    bool operator==(const SaveTimestamp& other) const { return SortKey() == other.SortKey(); }
+};
+
+// Parses "MM/DD/YYYY HH:MM:SS". Returns false if the text has the wrong length or layout,
+// or names an impossible date or time.
+bool ParseSaveTimestamp(const char* text, size_t length, SaveTimestamp& out);
+inline bool ParseSaveTimestamp(std::string_view text, SaveTimestamp& out) {
+    return ParseSaveTimestamp(text.data(), text.size(), out);
+}
+
+// Writes "MM/DD/YYYY HH:MM:SS" into out (exactly SAVE_TIMESTAMP_LENGTH characters, not NUL-terminated).
+void FormatSaveTimestamp(const SaveTimestamp& timestamp, char* out);
+
+// Writes "YYYYMMDD_HHMMSS" into out (exactly COMPACT_TIMESTAMP_LENGTH characters, not NUL-terminated).
+void FormatCompactTimestamp(const SaveTimestamp& timestamp, char* out);
+
+// Returns the current local time.
+SaveTimestamp CurrentLocalTimestamp();
@@ -0,0 +1,151 @@
+// StartupProfiler.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "StartupProfiler.h"
+#include <windows.h>    // For QueryPerformanceCounter, GetProcessTimes
+#include <cstdio>       // For snprintf
+#include "Logger.h"     // For LogMessage
+
+// Static member definitions for the StartupProfiler class.
+std::vector<StartupPhase> StartupProfiler::s_phases;
+std::vector<size_t> StartupProfiler::s_openPhases;
+long long StartupProfiler::s_startTicks = 0;
+long long StartupProfiler::s_ticksPerSecond = 0;
+double StartupProfiler::s_interactiveMs = -1.0;
+double StartupProfiler::s_processLaunchMs = -1.0;
+
+// Converts a FILETIME to a 64-bit count of 100-nanosecond intervals.
+static unsigned long long FileTimeToTicks(const FILETIME& ft) {
+    return (static_cast<unsigned long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+}
+
+// Records the start of the startup timeline and how long the process existed before it.
+void StartupProfiler::Start() {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    s_ticksPerSecond = frequency.QuadPart;
+    s_startTicks = counter.QuadPart;
+    s_phases.clear();
+    s_openPhases.clear();
+    s_interactiveMs = -1.0;
+
+    // The process creation time lets us attribute loader and CRT initialization time, which happen before WinMain.
+    FILETIME creation, exit_time, kernel, user, now;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exit_time, &kernel, &user)) {
+        GetSystemTimePreciseAsFileTime(&now);
+        unsigned long long created = FileTimeToTicks(creation);
+        unsigned long long current = FileTimeToTicks(now);
+        s_processLaunchMs = current > created ? static_cast<double>(current - created) / 10000.0 : 0.0;
+    } else {
+        s_processLaunchMs = -1.0;
+    }
+}
+
+// Returns milliseconds elapsed since Start().
+double StartupProfiler::NowMilliseconds() {
+    if (s_ticksPerSecond == 0) {
+        return 0.0;
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart - s_startTicks) * 1000.0 / static_cast<double>(s_ticksPerSecond);
+}
+
+void StartupProfiler::BeginPhase(const char* name) {
+    StartupPhase phase;
+    phase.name = name;
+    phase.depth = static_cast<int>(s_openPhases.size());
+    phase.start_ms = NowMilliseconds();
+    phase.duration_ms = -1.0; // Marks the phase as still running.
+    s_openPhases.push_back(s_phases.size());
+    s_phases.push_back(phase);
+}
+
+void StartupProfiler::EndPhase() {
+    if (s_openPhases.empty()) {
+        LogMessage(LOG_WARNING_LEVEL, "StartupProfiler::EndPhase called without a matching BeginPhase.");
+        return;
+    }
+    StartupPhase& phase = s_phases[s_openPhases.back()];
+    s_openPhases.pop_back();
+    phase.duration_ms = NowMilliseconds() - phase.start_ms;
+}
+
+void StartupProfiler::MarkInteractive() {
+    s_interactiveMs = NowMilliseconds();
+}
+
+double StartupProfiler::TimeToInteractiveMilliseconds() {
+    return s_interactiveMs >= 0.0 ? s_interactiveMs : NowMilliseconds();
+}
+
+double StartupProfiler::TotalPhaseMilliseconds() {
+    double total = 0.0;
+    for (const auto& phase : s_phases) {
+        if (phase.depth == 0 && phase.duration_ms >= 0.0) {
+            total += phase.duration_ms;
+        }
+    }
+    return total;
+}
+
+double StartupProfiler::ProcessLaunchMilliseconds() {
+    return s_processLaunchMs;
+}
+
+const std::vector<StartupPhase>& StartupProfiler::GetPhases() {
+    return s_phases;
+}
+
+// Logs one line per phase, indented by nesting depth, followed by the unattributed remainder.
+void StartupProfiler::Report() {
+    char line[256];
+    LogMessage(LOG_INFO_LEVEL, "--- Startup time breakdown ---");
+    if (s_processLaunchMs >= 0.0) {
+        snprintf(line, sizeof(line), "  %-34s %9.2f ms", "Process launch (loader, CRT)", s_processLaunchMs);
+        LogMessage(LOG_INFO_LEVEL, line);
+    }
+    for (const auto& phase : s_phases) {
+        std::string label = std::string(static_cast<size_t>(phase.depth) * 2, ' ') + phase.name;
+        if (phase.duration_ms >= 0.0) {
+            snprintf(line, sizeof(line), "  %-34s %9.2f ms", label.c_str(), phase.duration_ms);
+        } else {
+            snprintf(line, sizeof(line), "  %-34s   (not finished)", label.c_str());
+        }
+        LogMessage(LOG_INFO_LEVEL, line);
+    }
+    double tti = TimeToInteractiveMilliseconds();
+    snprintf(line, sizeof(line), "  %-34s %9.2f ms", "Other (unattributed)", tti - TotalPhaseMilliseconds());
+    LogMessage(LOG_INFO_LEVEL, line);
+    snprintf(line, sizeof(line), "  %-34s %9.2f ms", "Time to interactive", tti);
+    LogMessage(LOG_INFO_LEVEL, line);
+}
@@ -0,0 +1,96 @@
+// StartupProfiler.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A single timed phase of application startup.
+struct StartupPhase {
+    std::string name;       // Human-readable phase name (e.g., "Reference database").
+    int depth;              // Nesting depth; phases started inside another phase are indented in reports.
+    double start_ms;        // Offset from StartupProfiler::Start(), in milliseconds.
+    double duration_ms;     // Wall-clock duration of the phase, in milliseconds.
+};
+
+// The StartupProfiler class provides static methods for timing the phases of application startup.
+// Phases may be nested (e.g., the reference database is populated from inside WM_CREATE, which itself
+// runs inside CreateWindowEx). A report breaks time-to-interactive down by phase.
+class StartupProfiler {
+public:
+    // Marks the start of the startup timeline. Call once, as early as possible in WinMain.
+    static void Start();
+
+    // Begins a named phase. Every BeginPhase must be matched by an EndPhase.
+    static void BeginPhase(const char* name);
+
+    // Ends the most recently begun phase that has not yet ended.
+    static void EndPhase();
+
+    // Marks the application as interactive (window shown, about to enter the message loop).
+    static void MarkInteractive();
+
+    // Returns the milliseconds elapsed between Start() and MarkInteractive(), or until now if not yet interactive.
+    static double TimeToInteractiveMilliseconds();
+
+    // Returns the summed duration, in milliseconds, of all completed top-level phases.
+    static double TotalPhaseMilliseconds();
+
+    // Returns the milliseconds the OS loader and CRT spent before Start() was called, or -1 if unknown.
+    static double ProcessLaunchMilliseconds();
+
+    // Returns all recorded phases in the order they were begun.
+    static const std::vector<StartupPhase>& GetPhases();
+
+    // Logs a per-phase breakdown of startup time.
+    static void Report();
+
+private:
+    static double NowMilliseconds();
+
+    static std::vector<StartupPhase> s_phases;
+    static std::vector<size_t> s_openPhases;    // Indices into s_phases of phases not yet ended.
+    static long long s_startTicks;
+    static long long s_ticksPerSecond;
+    static double s_interactiveMs;
+    static double s_processLaunchMs;
+};
+
+// RAII helper that times a phase for the lifetime of the enclosing scope.
+class ScopedStartupPhase {
+public:
+    explicit ScopedStartupPhase(const char* name) { StartupProfiler::BeginPhase(name); }
+    ~ScopedStartupPhase() { StartupProfiler::EndPhase(); }
+
+    ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+    ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+};
@@ -0,0 +1,55 @@
+// WorkerThreads.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "WorkerThreads.h"
+#include <algorithm>            // For std::min, std::max
+#include <thread>               // For std::thread
+#include <vector>
+#include "SamplingProfiler.h"   // For sampling worker threads under -profile
+
+size_t RunWorkerThreads(size_t count, unsigned requestedThreads, const char* name, const std::function<void(std::atomic<size_t>& next)>& worker) {
+    unsigned threads = requestedThreads > 0 ? requestedThreads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t worker_count = std::max<size_t>(1, std::min<size_t>(threads, count));
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count - 1);
+    for (size_t i = 1; i < worker_count; ++i) {
+        workers.emplace_back([&worker, &next, name] {
+            ScopedProfiledThread profiled(name);
+            worker(next);
+        });
+    }
+    worker(next); // The calling thread is one of the workers.
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    return worker_count;
+}
@@ -0,0 +1,182 @@
+// ZlibUtil.cpp
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#include "ZlibUtil.h"
+#include <algorithm>        // For std::min
+#include <memory>           // For std::unique_ptr
+
+// Idle streams kept per thread for each direction; enough for the few formats and levels in use.
+const size_t MAX_IDLE_ZLIB_STREAMS = 4;
+
+// A stream set up for one direction, level and window size.
+struct PooledZlibStream {
+    z_stream strm;
+    bool deflating;
+    int level;
+    int windowBits;
+};
+
+// The calling thread's idle streams. Streams left when the thread exits are released with it.
+struct ZlibStreamPool {
+    std::vector<std::unique_ptr<PooledZlibStream>> idle;
+
+    ~ZlibStreamPool() {
+        for (auto& stream : idle) {
+            if (stream->deflating) {
+                deflateEnd(&stream->strm);
+            } else {
+                inflateEnd(&stream->strm);
+            }
+        }
+    }
+};
+
+static thread_local ZlibStreamPool t_streamPool;
+
+// Takes a matching idle stream from the pool, or sets up a new one. Returns NULL if zlib fails.
+static z_stream* AcquireStream(bool deflating, int level, int windowBits) {
+    std::vector<std::unique_ptr<PooledZlibStream>>& idle = t_streamPool.idle;
+    for (size_t i = 0; i < idle.size(); ++i) {
+        if (idle[i]->deflating == deflating && idle[i]->level == level && idle[i]->windowBits == windowBits) {
+            PooledZlibStream* stream = idle[i].release();
+            idle.erase(idle.begin() + i);
+            return &stream->strm;
+        }
+    }
+    std::unique_ptr<PooledZlibStream> stream(new PooledZlibStream());
+    stream->deflating = deflating;
+    stream->level = level;
+    stream->windowBits = windowBits;
+    stream->strm.zalloc = Z_NULL;
+    stream->strm.zfree = Z_NULL;
+    stream->strm.opaque = Z_NULL;
+    stream->strm.avail_in = 0;
+    stream->strm.next_in = Z_NULL;
+    int rc = deflating ? deflateInit2(&stream->strm, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY)
+                       : inflateInit2(&stream->strm, windowBits);
+    if (rc != Z_OK) {
+        return NULL;
+    }
+    return &stream.release()->strm;
+}
+
+// Resets a stream and returns it to the pool, or frees it if the pool is full or the reset fails.
+static void ReleaseStream(z_stream* strm) {
+    if (!strm) {
+        return;
+    }
+    // strm is the first member of its PooledZlibStream.
+    std::unique_ptr<PooledZlibStream> stream(reinterpret_cast<PooledZlibStream*>(strm));
+    int rc = stream->deflating ? deflateReset(strm) : inflateReset(strm);
+    if (rc == Z_OK && t_streamPool.idle.size() < MAX_IDLE_ZLIB_STREAMS) {
+        t_streamPool.idle.push_back(std::move(stream));
+        return;
+    }
+    if (stream->deflating) {
+        deflateEnd(strm);
+    } else {
+        inflateEnd(strm);
+    }
+}
+
+ZlibDeflateContext::ZlibDeflateContext(int level, int windowBits)
+    : m_stream(AcquireStream(true, level, windowBits)) {}
+
+ZlibDeflateContext::~ZlibDeflateContext() {
+    ReleaseStream(m_stream);
+}
+
+ZlibInflateContext::ZlibInflateContext(int windowBits)
+    : m_stream(AcquireStream(false, 0, windowBits)) {}
+
+ZlibInflateContext::~ZlibInflateContext() {
+    ReleaseStream(m_stream);
+}
+
+bool ZlibCompress(const void* data, size_t size, std::vector<unsigned char>& out, std::string& out_error, int level, int windowBits) {
+    ZlibDeflateContext context(level, windowBits);
+    z_stream* strm = context.Get();
+    if (!strm) {
+        out_error = "zlib deflateInit failed.";
+        return false;
+    }
+    out.resize(deflateBound(strm, static_cast<uLong>(size)));
+    strm->avail_in = static_cast<uInt>(size);
+    strm->next_in = const_cast<Bytef*>(static_cast<const Bytef*>(data));
+    strm->avail_out = static_cast<uInt>(out.size());
+    strm->next_out = out.data();
+    int rc = deflate(strm, Z_FINISH); // deflateBound guarantees room for the whole stream.
+    if (rc != Z_STREAM_END) {
+        out_error = "zlib deflate did not finish stream correctly: " + std::string(strm->msg ? strm->msg : "Unknown error");
+        out.clear();
+        return false;
+    }
+    out.resize(strm->total_out);
+    return true;
+}
+
+bool ZlibDecompress(const void* data, size_t size, size_t expectedSize, std::string& out, std::string& out_error, int windowBits, size_t maxSize) {
+    ZlibInflateContext context(windowBits);
+    z_stream* strm = context.Get();
+    if (!strm) {
+        out_error = "zlib inflateInit failed.";
+        return false;
+    }
+    size_t initial_size = expectedSize > 0 ? expectedSize : (size > 0 ? size * 4 : 64);
+    if (maxSize > 0 && initial_size > maxSize) {
+        initial_size = maxSize;
+    }
+    out.resize(initial_size);
+    strm->avail_in = static_cast<uInt>(size);
+    strm->next_in = const_cast<Bytef*>(static_cast<const Bytef*>(data));
+    int rc;
+    for (;;) {
+        strm->avail_out = static_cast<uInt>(out.size() - strm->total_out);
+        strm->next_out = reinterpret_cast<Bytef*>(&out[0]) + strm->total_out;
+        rc = inflate(strm, Z_FINISH);
+        if (rc != Z_BUF_ERROR || strm->avail_out != 0) {
+            break;
+        }
+        if (maxSize > 0 && out.size() >= maxSize) {
+            out_error = "zlib inflate output exceeds the " + std::to_string(maxSize) + " byte limit.";
+            out.clear();
+            return false;
+        }
+        out.resize(maxSize > 0 ? std::min(out.size() * 2, maxSize) : out.size() * 2); // The size was unknown or underestimated.
+    }
+    if (rc != Z_STREAM_END) {
+        out_error = "zlib inflate failed: " + std::string(strm->msg ? strm->msg : (rc == Z_BUF_ERROR ? "truncated stream" : "Unknown error"));
+        out.clear();
+        return false;
+    }
+    out.resize(strm->total_out);
+    return true;
+}
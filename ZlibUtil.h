@@ -0,0 +1,86 @@
+// ZlibUtil.h
+//
+// Copyright (c) 2025 FNGarvin (184324400+FNGarvin@users.noreply.github.com)
+// All rights reserved.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+// Disclaimer: This project and its creators are not affiliated with Mintrocket, Nexon,
+// or any other entities associated with the game "Dave the Diver." This is an independent
+// fan-made tool.
+//
+// This project uses third-party libraries under their respective licenses:
+// - zlib (Zlib License)
+// - nlohmann/json (MIT License)
+// - SQLite (Public Domain)
+// Full license texts can be found in the /dist/zlib, /dist/nlohmann_json, and /dist/sqlite3 directories.
+//
+#pragma once
+
+#include <string>
+#include <vector>
+#include "zlib.h"   // For z_stream
+
+// Window bits for the stream formats in use: zlib (RFC 1950), raw deflate, and gzip.
+const int ZLIB_WINDOW_BITS = 15;
+const int RAW_DEFLATE_WINDOW_BITS = -15;
+const int GZIP_WINDOW_BITS = 15 + 16;
+
+// A deflate stream borrowed from the calling thread's pool. A stream is set up (deflateInit2) the first
+// time a thread asks for its level and window bits; afterwards releasing it only resets it (deflateReset),
+// so repeated compression does no per-call setup. Use on the thread that created it.
+class ZlibDeflateContext {
+public:
+    ZlibDeflateContext(int level, int windowBits);
+    ~ZlibDeflateContext();
+    ZlibDeflateContext(const ZlibDeflateContext&) = delete;
+    ZlibDeflateContext& operator=(const ZlibDeflateContext&) = delete;
+
+    // NULL if zlib could not set up a stream.
+    z_stream* Get() { return m_stream; }
+
+private:
+    z_stream* m_stream;
+};
+
+// An inflate stream borrowed from the calling thread's pool, recycled with inflateReset.
+class ZlibInflateContext {
+public:
+    explicit ZlibInflateContext(int windowBits);
+    ~ZlibInflateContext();
+    ZlibInflateContext(const ZlibInflateContext&) = delete;
+    ZlibInflateContext& operator=(const ZlibInflateContext&) = delete;
+
+    // NULL if zlib could not set up a stream.
+    z_stream* Get() { return m_stream; }
+
+private:
+    z_stream* m_stream;
+};
+
+// Compresses data into out (replacing its contents) with a pooled stream. out is sized once from
+// deflateBound and trimmed afterwards, so the output is never regrown. Returns false and sets out_error on failure.
+bool ZlibCompress(const void* data, size_t size, std::vector<unsigned char>& out, std::string& out_error,
+                  int level = Z_DEFAULT_COMPRESSION, int windowBits = ZLIB_WINDOW_BITS);
+
+// Decompresses one complete stream into out (replacing its contents) with a pooled stream. If the
+// decompressed size is known, pass it as expectedSize: out is sized exactly and filled in one inflate
+// call. Otherwise (0, or an estimate that proves too small) out starts at expectedSize or four times
+// the input and doubles as needed. A non-zero maxSize fails the call once the output would exceed it,
+// which bounds the memory a hostile stream can claim. Returns false and sets out_error on failure.
+bool ZlibDecompress(const void* data, size_t size, size_t expectedSize, std::string& out, std::string& out_error,
+                    int windowBits = ZLIB_WINDOW_BITS, size_t maxSize = 0);
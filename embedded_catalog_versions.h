@@ -0,0 +1,40 @@
+// Reference catalog versions embedded alongside embedded_sql.h.
+//
+// embedded_sql.h holds the base catalog, built from one game build. Every other game build is
+// described here as a delta against that base, so each build costs only the items it changes:
+//   name:         The game build's database migration.
+//   delta:        zlib-compressed SQL script (INSERT OR REPLACE / DELETE against the base tables).
+//   deltaSize:    Size of delta in bytes.
+//   sqlSize:      Size of the script once inflated.
+//   addedIds:     Sorted item TIDs and ItemDataIDs the script adds to the base, used to pick the
+//                 version a save needs without inflating any delta.
+//   addedIdCount: Number of entries in addedIds.
+// The first row is the base itself and has no delta. Append newer builds after it; their position is
+// the version number recorded in edit journals, so never reorder or remove rows.
+//
+// Rows are generated, and checked by applying them to the base, from a SQL dump of the build's whole
+// reference database (e.g. `sqlite3 build.db .dump`):
+//   DaveSaveEd.exe -export-catalog-version=embedded_catalog_<migration>.h -catalog-version-sql=build.sql
+// Include the generated header below and append its catalog_version_<migration> to the table.
+
+#ifndef EMBEDDED_CATALOG_VERSIONS_H
+#define EMBEDDED_CATALOG_VERSIONS_H
+
+#include <cstddef> // For size_t
+#include <cstdint> // For int32_t
+
+struct EmbeddedCatalogVersion {
+    const char* name;
+    const unsigned char* delta;
+    size_t deltaSize;
+    size_t sqlSize;
+    const int32_t* addedIds;
+    size_t addedIdCount;
+};
+
+const EmbeddedCatalogVersion embedded_catalog_versions[] = {
+    { "20250607180926_InitialCreate", NULL, 0, 0, NULL, 0 },
+};
+const size_t embedded_catalog_version_count = sizeof(embedded_catalog_versions) / sizeof(embedded_catalog_versions[0]);
+
+#endif // EMBEDDED_CATALOG_VERSIONS_H